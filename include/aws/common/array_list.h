@@ -74,6 +74,12 @@ extern "C" {
     */
     AWS_COMMON_API int aws_array_list_pop_front(struct aws_array_list *list);
 
+    /**
+    * Deletes the first n elements of the list, shifting the rest to the front with a single move. If the list has
+    * fewer than n elements, AWS_ERROR_INVALID_INDEX will be raised and nothing is deleted.
+    */
+    AWS_COMMON_API int aws_array_list_pop_front_n(struct aws_array_list *list, size_t n);
+
     /**
      * Copies the element at the end of the list if it exists. If list is empty, AWS_ERROR_LIST_EMPTY will be raised.
      */
@@ -0,0 +1,460 @@
+#ifndef AWS_COMMON_ATOMICS_H_
+#define AWS_COMMON_ATOMICS_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/common.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * An atomic variable holding either a size_t or a pointer. The storage is a plain (non _Atomic) member so the struct can
+ * be embedded in structs shared with C99 and C++ callers; every access must go through the functions below.
+ */
+struct aws_atomic_var {
+    void *value;
+};
+
+/*
+ * Memory orderings, with the same meaning (and numeric values) as the C11 memory_order enumeration.
+ * As in C11, stores may not use acquire or acq_rel, loads may not use release or acq_rel, and the failure ordering of a
+ * compare-exchange may not be release, acq_rel, or stronger than the success ordering.
+ */
+enum aws_memory_order {
+    aws_memory_order_relaxed = 0,
+    aws_memory_order_acquire = 2,
+    aws_memory_order_release = 3,
+    aws_memory_order_acq_rel = 4,
+    aws_memory_order_seq_cst = 5
+};
+
+/* Static initializers. Use these (or aws_atomic_init_*) before the variable is shared between threads. */
+#define AWS_ATOMIC_INIT_INT(x) { (void *)(uintptr_t)(x) }
+#define AWS_ATOMIC_INIT_PTR(x) { (void *)(x) }
+
+/*
+ * Pick a backend. GCC and clang get the __atomic builtins, other C11 compilers get <stdatomic.h>, and MSVC gets the
+ * Interlocked intrinsics. A backend can be forced by defining one of the AWS_ATOMICS_* macros before including this file.
+ */
+#if !defined(AWS_ATOMICS_GNU) && !defined(AWS_ATOMICS_C11) && !defined(AWS_ATOMICS_MSVC)
+#if defined(__GNUC__) || defined(__clang__)
+#define AWS_ATOMICS_GNU
+#elif !defined(__cplusplus) && defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+#define AWS_ATOMICS_C11
+#elif defined(_MSC_VER)
+#define AWS_ATOMICS_MSVC
+#else
+#error "aws-c-common: no atomics implementation is available for this compiler"
+#endif
+#endif
+
+#if defined(AWS_ATOMICS_C11)
+#include <stdatomic.h>
+#elif defined(AWS_ATOMICS_MSVC)
+#include <Windows.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes an atomic variable with an integer value. This is not an atomic operation and must happen before the
+ * variable is visible to other threads.
+ */
+static inline void aws_atomic_init_int(volatile struct aws_atomic_var *var, size_t n);
+
+/**
+ * Initializes an atomic variable with a pointer value. This is not an atomic operation and must happen before the
+ * variable is visible to other threads.
+ */
+static inline void aws_atomic_init_ptr(volatile struct aws_atomic_var *var, void *p);
+
+/**
+ * Reads an atomic var as an integer, using the specified ordering.
+ */
+static inline size_t aws_atomic_load_int_explicit(volatile const struct aws_atomic_var *var, enum aws_memory_order order);
+
+/**
+ * Reads an atomic var as a pointer, using the specified ordering.
+ */
+static inline void *aws_atomic_load_ptr_explicit(volatile const struct aws_atomic_var *var, enum aws_memory_order order);
+
+/**
+ * Stores an integer into an atomic var, using the specified ordering.
+ */
+static inline void aws_atomic_store_int_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order);
+
+/**
+ * Stores a pointer into an atomic var, using the specified ordering.
+ */
+static inline void aws_atomic_store_ptr_explicit(volatile struct aws_atomic_var *var, void *p, enum aws_memory_order order);
+
+/**
+ * Exchanges an integer with the value in an atomic var, returning the old value.
+ */
+static inline size_t aws_atomic_exchange_int_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order);
+
+/**
+ * Exchanges a pointer with the value in an atomic var, returning the old value.
+ */
+static inline void *aws_atomic_exchange_ptr_explicit(volatile struct aws_atomic_var *var, void *p, enum aws_memory_order order);
+
+/**
+ * Atomically compares *var to *expected; if they are equal, stores desired into *var and returns non-zero. Otherwise,
+ * copies the current value of *var into *expected and returns zero.
+ */
+static inline int aws_atomic_compare_exchange_int_explicit(volatile struct aws_atomic_var *var, size_t *expected,
+        size_t desired, enum aws_memory_order order_success, enum aws_memory_order order_failure);
+
+/**
+ * Pointer flavor of aws_atomic_compare_exchange_int_explicit.
+ */
+static inline int aws_atomic_compare_exchange_ptr_explicit(volatile struct aws_atomic_var *var, void **expected,
+        void *desired, enum aws_memory_order order_success, enum aws_memory_order order_failure);
+
+/**
+ * Atomically adds n to *var, and returns the previous value of *var.
+ */
+static inline size_t aws_atomic_fetch_add_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order);
+
+/**
+ * Atomically subtracts n from *var, and returns the previous value of *var.
+ */
+static inline size_t aws_atomic_fetch_sub_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order);
+
+/**
+ * Atomically ORs n into *var, and returns the previous value of *var.
+ */
+static inline size_t aws_atomic_fetch_or_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order);
+
+/**
+ * Atomically ANDs n into *var, and returns the previous value of *var.
+ */
+static inline size_t aws_atomic_fetch_and_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order);
+
+/**
+ * Atomically XORs n into *var, and returns the previous value of *var.
+ */
+static inline size_t aws_atomic_fetch_xor_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order);
+
+/**
+ * Provides the same reordering guarantees as an atomic operation with the specified memory order, without
+ * needing to actually perform an atomic operation.
+ */
+static inline void aws_atomic_thread_fence(enum aws_memory_order order);
+
+/**
+ * Tells the CPU the caller is busy-waiting (pause on x86, yield on ARM). Use it in the body of spin loops.
+ */
+static inline void aws_atomic_cpu_relax(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* Sequentially consistent shorthands for all of the above. */
+#define aws_atomic_load_int(var) aws_atomic_load_int_explicit((var), aws_memory_order_seq_cst)
+#define aws_atomic_load_ptr(var) aws_atomic_load_ptr_explicit((var), aws_memory_order_seq_cst)
+#define aws_atomic_store_int(var, n) aws_atomic_store_int_explicit((var), (n), aws_memory_order_seq_cst)
+#define aws_atomic_store_ptr(var, p) aws_atomic_store_ptr_explicit((var), (p), aws_memory_order_seq_cst)
+#define aws_atomic_exchange_int(var, n) aws_atomic_exchange_int_explicit((var), (n), aws_memory_order_seq_cst)
+#define aws_atomic_exchange_ptr(var, p) aws_atomic_exchange_ptr_explicit((var), (p), aws_memory_order_seq_cst)
+#define aws_atomic_compare_exchange_int(var, expected, desired) \
+    aws_atomic_compare_exchange_int_explicit((var), (expected), (desired), aws_memory_order_seq_cst, aws_memory_order_seq_cst)
+#define aws_atomic_compare_exchange_ptr(var, expected, desired) \
+    aws_atomic_compare_exchange_ptr_explicit((var), (expected), (desired), aws_memory_order_seq_cst, aws_memory_order_seq_cst)
+#define aws_atomic_fetch_add(var, n) aws_atomic_fetch_add_explicit((var), (n), aws_memory_order_seq_cst)
+#define aws_atomic_fetch_sub(var, n) aws_atomic_fetch_sub_explicit((var), (n), aws_memory_order_seq_cst)
+#define aws_atomic_fetch_or(var, n) aws_atomic_fetch_or_explicit((var), (n), aws_memory_order_seq_cst)
+#define aws_atomic_fetch_and(var, n) aws_atomic_fetch_and_explicit((var), (n), aws_memory_order_seq_cst)
+#define aws_atomic_fetch_xor(var, n) aws_atomic_fetch_xor_explicit((var), (n), aws_memory_order_seq_cst)
+
+static inline void aws_atomic_init_int(volatile struct aws_atomic_var *var, size_t n) {
+    var->value = (void *)n;
+}
+
+static inline void aws_atomic_init_ptr(volatile struct aws_atomic_var *var, void *p) {
+    var->value = p;
+}
+
+#if defined(AWS_ATOMICS_GNU)
+
+/* The enum values line up with __ATOMIC_RELAXED .. __ATOMIC_SEQ_CST, so orders are passed straight through. */
+
+static inline size_t aws_atomic_load_int_explicit(volatile const struct aws_atomic_var *var, enum aws_memory_order order) {
+    return __atomic_load_n((volatile const size_t *)&var->value, (int)order);
+}
+
+static inline void *aws_atomic_load_ptr_explicit(volatile const struct aws_atomic_var *var, enum aws_memory_order order) {
+    return __atomic_load_n(&var->value, (int)order);
+}
+
+static inline void aws_atomic_store_int_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    __atomic_store_n((volatile size_t *)&var->value, n, (int)order);
+}
+
+static inline void aws_atomic_store_ptr_explicit(volatile struct aws_atomic_var *var, void *p, enum aws_memory_order order) {
+    __atomic_store_n(&var->value, p, (int)order);
+}
+
+static inline size_t aws_atomic_exchange_int_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    return __atomic_exchange_n((volatile size_t *)&var->value, n, (int)order);
+}
+
+static inline void *aws_atomic_exchange_ptr_explicit(volatile struct aws_atomic_var *var, void *p, enum aws_memory_order order) {
+    return __atomic_exchange_n(&var->value, p, (int)order);
+}
+
+static inline int aws_atomic_compare_exchange_int_explicit(volatile struct aws_atomic_var *var, size_t *expected,
+        size_t desired, enum aws_memory_order order_success, enum aws_memory_order order_failure) {
+    return __atomic_compare_exchange_n((volatile size_t *)&var->value, expected, desired, 0,
+            (int)order_success, (int)order_failure);
+}
+
+static inline int aws_atomic_compare_exchange_ptr_explicit(volatile struct aws_atomic_var *var, void **expected,
+        void *desired, enum aws_memory_order order_success, enum aws_memory_order order_failure) {
+    return __atomic_compare_exchange_n(&var->value, expected, desired, 0, (int)order_success, (int)order_failure);
+}
+
+static inline size_t aws_atomic_fetch_add_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    return __atomic_fetch_add((volatile size_t *)&var->value, n, (int)order);
+}
+
+static inline size_t aws_atomic_fetch_sub_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    return __atomic_fetch_sub((volatile size_t *)&var->value, n, (int)order);
+}
+
+static inline size_t aws_atomic_fetch_or_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    return __atomic_fetch_or((volatile size_t *)&var->value, n, (int)order);
+}
+
+static inline size_t aws_atomic_fetch_and_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    return __atomic_fetch_and((volatile size_t *)&var->value, n, (int)order);
+}
+
+static inline size_t aws_atomic_fetch_xor_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    return __atomic_fetch_xor((volatile size_t *)&var->value, n, (int)order);
+}
+
+static inline void aws_atomic_thread_fence(enum aws_memory_order order) {
+    __atomic_thread_fence((int)order);
+}
+
+#elif defined(AWS_ATOMICS_C11)
+
+/* atomic_size_t and atomic_uintptr_t have the same size and representation as their plain counterparts on every
+ * platform we support, which is what lets the public struct stay free of _Atomic. */
+#define AWS_ATOMIC_SIZE(var) ((volatile atomic_size_t *)&(var)->value)
+#define AWS_ATOMIC_UPTR(var) ((volatile atomic_uintptr_t *)&(var)->value)
+
+static inline size_t aws_atomic_load_int_explicit(volatile const struct aws_atomic_var *var, enum aws_memory_order order) {
+    return atomic_load_explicit(AWS_ATOMIC_SIZE(var), (memory_order)order);
+}
+
+static inline void *aws_atomic_load_ptr_explicit(volatile const struct aws_atomic_var *var, enum aws_memory_order order) {
+    return (void *)atomic_load_explicit(AWS_ATOMIC_UPTR(var), (memory_order)order);
+}
+
+static inline void aws_atomic_store_int_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    atomic_store_explicit(AWS_ATOMIC_SIZE(var), n, (memory_order)order);
+}
+
+static inline void aws_atomic_store_ptr_explicit(volatile struct aws_atomic_var *var, void *p, enum aws_memory_order order) {
+    atomic_store_explicit(AWS_ATOMIC_UPTR(var), (uintptr_t)p, (memory_order)order);
+}
+
+static inline size_t aws_atomic_exchange_int_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    return atomic_exchange_explicit(AWS_ATOMIC_SIZE(var), n, (memory_order)order);
+}
+
+static inline void *aws_atomic_exchange_ptr_explicit(volatile struct aws_atomic_var *var, void *p, enum aws_memory_order order) {
+    return (void *)atomic_exchange_explicit(AWS_ATOMIC_UPTR(var), (uintptr_t)p, (memory_order)order);
+}
+
+static inline int aws_atomic_compare_exchange_int_explicit(volatile struct aws_atomic_var *var, size_t *expected,
+        size_t desired, enum aws_memory_order order_success, enum aws_memory_order order_failure) {
+    return atomic_compare_exchange_strong_explicit(AWS_ATOMIC_SIZE(var), expected, desired,
+            (memory_order)order_success, (memory_order)order_failure);
+}
+
+static inline int aws_atomic_compare_exchange_ptr_explicit(volatile struct aws_atomic_var *var, void **expected,
+        void *desired, enum aws_memory_order order_success, enum aws_memory_order order_failure) {
+    return atomic_compare_exchange_strong_explicit(AWS_ATOMIC_UPTR(var), (uintptr_t *)expected, (uintptr_t)desired,
+            (memory_order)order_success, (memory_order)order_failure);
+}
+
+static inline size_t aws_atomic_fetch_add_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    return atomic_fetch_add_explicit(AWS_ATOMIC_SIZE(var), n, (memory_order)order);
+}
+
+static inline size_t aws_atomic_fetch_sub_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    return atomic_fetch_sub_explicit(AWS_ATOMIC_SIZE(var), n, (memory_order)order);
+}
+
+static inline size_t aws_atomic_fetch_or_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    return atomic_fetch_or_explicit(AWS_ATOMIC_SIZE(var), n, (memory_order)order);
+}
+
+static inline size_t aws_atomic_fetch_and_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    return atomic_fetch_and_explicit(AWS_ATOMIC_SIZE(var), n, (memory_order)order);
+}
+
+static inline size_t aws_atomic_fetch_xor_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    return atomic_fetch_xor_explicit(AWS_ATOMIC_SIZE(var), n, (memory_order)order);
+}
+
+static inline void aws_atomic_thread_fence(enum aws_memory_order order) {
+    atomic_thread_fence((memory_order)order);
+}
+
+#undef AWS_ATOMIC_SIZE
+#undef AWS_ATOMIC_UPTR
+
+#elif defined(AWS_ATOMICS_MSVC)
+
+/*
+ * The Interlocked family is always a full barrier, so every read-modify-write is seq_cst regardless of the requested
+ * order. Plain loads and stores rely on x86/x64 ordering (loads are acquire, stores are release) plus a compiler barrier,
+ * and seq_cst stores go through an exchange.
+ */
+#ifdef _WIN64
+#define AWS_INTERLOCKED_INT(name) name##64
+#define AWS_INTERLOCKED_TYPE LONG64
+#else
+#define AWS_INTERLOCKED_INT(name) name
+#define AWS_INTERLOCKED_TYPE LONG
+#endif
+
+#define AWS_INTERLOCKED_PTR(var) ((volatile AWS_INTERLOCKED_TYPE *)&(var)->value)
+
+static inline size_t aws_atomic_load_int_explicit(volatile const struct aws_atomic_var *var, enum aws_memory_order order) {
+    size_t result = (size_t)var->value;
+    if (order != aws_memory_order_relaxed) {
+        _ReadWriteBarrier();
+    }
+    return result;
+}
+
+static inline void *aws_atomic_load_ptr_explicit(volatile const struct aws_atomic_var *var, enum aws_memory_order order) {
+    return (void *)aws_atomic_load_int_explicit(var, order);
+}
+
+static inline void aws_atomic_store_int_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    if (order == aws_memory_order_seq_cst) {
+        AWS_INTERLOCKED_INT(InterlockedExchange)(AWS_INTERLOCKED_PTR(var), (AWS_INTERLOCKED_TYPE)n);
+        return;
+    }
+
+    if (order != aws_memory_order_relaxed) {
+        _ReadWriteBarrier();
+    }
+    var->value = (void *)n;
+}
+
+static inline void aws_atomic_store_ptr_explicit(volatile struct aws_atomic_var *var, void *p, enum aws_memory_order order) {
+    aws_atomic_store_int_explicit(var, (size_t)p, order);
+}
+
+static inline size_t aws_atomic_exchange_int_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    (void)order;
+    return (size_t)AWS_INTERLOCKED_INT(InterlockedExchange)(AWS_INTERLOCKED_PTR(var), (AWS_INTERLOCKED_TYPE)n);
+}
+
+static inline void *aws_atomic_exchange_ptr_explicit(volatile struct aws_atomic_var *var, void *p, enum aws_memory_order order) {
+    return (void *)aws_atomic_exchange_int_explicit(var, (size_t)p, order);
+}
+
+static inline int aws_atomic_compare_exchange_int_explicit(volatile struct aws_atomic_var *var, size_t *expected,
+        size_t desired, enum aws_memory_order order_success, enum aws_memory_order order_failure) {
+    (void)order_success;
+    (void)order_failure;
+    size_t previous = (size_t)AWS_INTERLOCKED_INT(InterlockedCompareExchange)(AWS_INTERLOCKED_PTR(var),
+            (AWS_INTERLOCKED_TYPE)desired, (AWS_INTERLOCKED_TYPE)*expected);
+    if (previous == *expected) {
+        return 1;
+    }
+
+    *expected = previous;
+    return 0;
+}
+
+static inline int aws_atomic_compare_exchange_ptr_explicit(volatile struct aws_atomic_var *var, void **expected,
+        void *desired, enum aws_memory_order order_success, enum aws_memory_order order_failure) {
+    return aws_atomic_compare_exchange_int_explicit(var, (size_t *)expected, (size_t)desired, order_success, order_failure);
+}
+
+static inline size_t aws_atomic_fetch_add_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    (void)order;
+    return (size_t)AWS_INTERLOCKED_INT(InterlockedExchangeAdd)(AWS_INTERLOCKED_PTR(var), (AWS_INTERLOCKED_TYPE)n);
+}
+
+static inline size_t aws_atomic_fetch_sub_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    (void)order;
+    return (size_t)AWS_INTERLOCKED_INT(InterlockedExchangeAdd)(AWS_INTERLOCKED_PTR(var), -(AWS_INTERLOCKED_TYPE)n);
+}
+
+static inline size_t aws_atomic_fetch_or_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    (void)order;
+    return (size_t)AWS_INTERLOCKED_INT(InterlockedOr)(AWS_INTERLOCKED_PTR(var), (AWS_INTERLOCKED_TYPE)n);
+}
+
+static inline size_t aws_atomic_fetch_and_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    (void)order;
+    return (size_t)AWS_INTERLOCKED_INT(InterlockedAnd)(AWS_INTERLOCKED_PTR(var), (AWS_INTERLOCKED_TYPE)n);
+}
+
+static inline size_t aws_atomic_fetch_xor_explicit(volatile struct aws_atomic_var *var, size_t n, enum aws_memory_order order) {
+    (void)order;
+    return (size_t)AWS_INTERLOCKED_INT(InterlockedXor)(AWS_INTERLOCKED_PTR(var), (AWS_INTERLOCKED_TYPE)n);
+}
+
+static inline void aws_atomic_thread_fence(enum aws_memory_order order) {
+    switch (order) {
+        case aws_memory_order_relaxed:
+            break;
+        case aws_memory_order_seq_cst:
+            MemoryBarrier();
+            break;
+        default:
+            _ReadWriteBarrier();
+            break;
+    }
+}
+
+#undef AWS_INTERLOCKED_PTR
+#undef AWS_INTERLOCKED_TYPE
+#undef AWS_INTERLOCKED_INT
+
+#endif /* AWS_ATOMICS_MSVC */
+
+static inline void aws_atomic_cpu_relax(void) {
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    _mm_pause();
+#elif defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
+    __yield();
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    __asm__ __volatile__("pause" ::: "memory");
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__aarch64__) || defined(__arm__))
+    __asm__ __volatile__("yield" ::: "memory");
+#endif
+}
+
+#endif /* AWS_COMMON_ATOMICS_H_ */
@@ -0,0 +1,56 @@
+#ifndef AWS_COMMON_BARRIER_H_
+#define AWS_COMMON_BARRIER_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/atomics.h>
+
+/*
+ * A reusable barrier for a fixed number of threads, e.g. to line up benchmark threads before each phase.
+ *
+ * This is a sense-reversing barrier with a generation counter standing in for the sense flag: arrivals decrement a
+ * shared count, and the last one resets it and bumps the generation, which releases everybody else. Waiters spin on the
+ * generation for a short while before sleeping in the kernel, and the last arrival only makes a wake up call when
+ * someone is actually asleep.
+ */
+struct aws_barrier {
+    size_t parties;
+    struct aws_atomic_var remaining;
+    struct aws_atomic_var generation;
+    /* threads sleeping (or about to sleep) on generation. */
+    struct aws_atomic_var sleepers;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a barrier for parties threads. parties must be at least 1.
+ */
+AWS_COMMON_API void aws_barrier_init(struct aws_barrier *barrier, size_t parties);
+
+/**
+ * Blocks until parties threads have called aws_barrier_wait() for the current phase. Returns non-zero in exactly one
+ * of them (the last to arrive), and zero in the others. The barrier is ready for the next phase as soon as it opens.
+ */
+AWS_COMMON_API int aws_barrier_wait(struct aws_barrier *barrier);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWS_COMMON_BARRIER_H_ */
@@ -0,0 +1,119 @@
+#ifndef AWS_COMMON_CHANNEL_H_
+#define AWS_COMMON_CHANNEL_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/atomics.h>
+#include <aws/common/mutex.h>
+
+/*
+ * A bounded, multi-producer multi-consumer channel of fixed size elements, for passing work between pipeline stages
+ * with backpressure: senders block (or fail) while the channel is full, receivers while it is empty.
+ *
+ * The ring buffer is guarded by an aws_mutex. Blocked threads sleep on an event count (a sequence number bumped when
+ * space or items show up) instead of polling, and are only woken when someone is actually waiting. The batch calls move
+ * as many elements as fit per lock acquisition, which amortizes the synchronization over the batch.
+ *
+ * Closing the channel fails further sends, wakes every blocked thread, and lets receivers drain what is left before
+ * they too fail with AWS_ERROR_CHANNEL_CLOSED.
+ */
+struct aws_channel {
+    struct aws_allocator *allocator;
+    struct aws_mutex lock;
+    uint8_t *buffer;
+    size_t element_size;
+    size_t capacity;
+    /* the fields below are guarded by lock. */
+    size_t head;
+    size_t count;
+    int closed;
+    size_t blocked_senders;
+    size_t blocked_receivers;
+    /* event counts for blocked senders and receivers. */
+    struct aws_atomic_var space_available;
+    struct aws_atomic_var items_available;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a channel holding up to capacity elements of element_size bytes each.
+ */
+AWS_COMMON_API int aws_channel_init(struct aws_channel *channel, struct aws_allocator *allocator, size_t element_size,
+        size_t capacity);
+
+/**
+ * Cleans up the channel. No thread may be using it anymore; elements still queued are dropped.
+ */
+AWS_COMMON_API void aws_channel_clean_up(struct aws_channel *channel);
+
+/**
+ * Closes the channel. Further sends fail with AWS_ERROR_CHANNEL_CLOSED, and receives do too once the channel is
+ * drained. Every blocked thread is woken up.
+ */
+AWS_COMMON_API void aws_channel_close(struct aws_channel *channel);
+
+/**
+ * Copies item into the channel, blocking while it is full.
+ */
+AWS_COMMON_API int aws_channel_send(struct aws_channel *channel, const void *item);
+
+/**
+ * Copies item into the channel, or raises AWS_ERROR_CHANNEL_FULL if it is full.
+ */
+AWS_COMMON_API int aws_channel_try_send(struct aws_channel *channel, const void *item);
+
+/**
+ * Copies item into the channel, blocking for at most timeout_ns nanoseconds while it is full. Raises
+ * AWS_ERROR_WAIT_TIMEOUT if no space became available in time.
+ */
+AWS_COMMON_API int aws_channel_send_timeout(struct aws_channel *channel, const void *item, uint64_t timeout_ns);
+
+/**
+ * Copies count contiguous items into the channel, blocking until all of them are in. If the channel is closed midway,
+ * raises AWS_ERROR_CHANNEL_CLOSED. If sent is not NULL, it is set to the number of items sent either way.
+ */
+AWS_COMMON_API int aws_channel_send_n(struct aws_channel *channel, const void *items, size_t count, size_t *sent);
+
+/**
+ * Moves the oldest element into item, blocking while the channel is empty.
+ */
+AWS_COMMON_API int aws_channel_recv(struct aws_channel *channel, void *item);
+
+/**
+ * Moves the oldest element into item, or raises AWS_ERROR_CHANNEL_EMPTY if there is none.
+ */
+AWS_COMMON_API int aws_channel_try_recv(struct aws_channel *channel, void *item);
+
+/**
+ * Moves the oldest element into item, blocking for at most timeout_ns nanoseconds while the channel is empty. Raises
+ * AWS_ERROR_WAIT_TIMEOUT if nothing arrived in time.
+ */
+AWS_COMMON_API int aws_channel_recv_timeout(struct aws_channel *channel, void *item, uint64_t timeout_ns);
+
+/**
+ * Blocks until the channel holds at least one element, then moves up to max of the oldest elements into items and sets
+ * received to their number.
+ */
+AWS_COMMON_API int aws_channel_recv_n(struct aws_channel *channel, void *items, size_t max, size_t *received);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWS_COMMON_CHANNEL_H_ */
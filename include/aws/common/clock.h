@@ -16,9 +16,31 @@
 * permissions and limitations under the License.
 */
 
+#include <aws/common/atomics.h>
 #include <aws/common/common.h>
+#include <aws/common/seqlock.h>
 #include <stdint.h>
 
+/*
+ * A clock that time dependent code reads instead of calling a particular clock function, so that tests and benchmarks
+ * can substitute their own time. aws_high_res_clock() and aws_sys_clock() are the system clocks; an
+ * aws_manual_clock only moves when told to, which lets hours of simulated timer load run in seconds.
+ */
+struct aws_clock {
+    int(*get_ticks)(struct aws_clock *clock, uint64_t *timestamp);
+    void *impl;
+};
+
+/*
+ * A clock that stands still until advanced, for driving time dependent code through simulated time.
+ */
+struct aws_manual_clock {
+    struct aws_clock clock;
+    /* guards now, which doesn't fit in an atomic word on 32 bit targets. */
+    struct aws_seqlock lock;
+    uint64_t now;
+};
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -34,8 +56,42 @@ AWS_COMMON_API int aws_high_res_clock_get_ticks(uint64_t *timestamp);
  */
 AWS_COMMON_API int aws_sys_clock_get_ticks(uint64_t *timestamp);
 
+/**
+ * Returns the clock instance for aws_high_res_clock_get_ticks().
+ */
+AWS_COMMON_API struct aws_clock *aws_high_res_clock(void);
+
+/**
+ * Returns the clock instance for aws_sys_clock_get_ticks().
+ */
+AWS_COMMON_API struct aws_clock *aws_sys_clock(void);
+
+/**
+ * Initializes a manual clock reading start_ticks. Read it through its clock member.
+ */
+AWS_COMMON_API void aws_manual_clock_init(struct aws_manual_clock *clock, uint64_t start_ticks);
+
+/**
+ * Moves a manual clock forward by ns nanoseconds.
+ */
+AWS_COMMON_API void aws_manual_clock_advance(struct aws_manual_clock *clock, uint64_t ns);
+
+/**
+ * Sets a manual clock to ticks. Setting it backwards is allowed, but most code reading a clock assumes it doesn't.
+ */
+AWS_COMMON_API void aws_manual_clock_set(struct aws_manual_clock *clock, uint64_t ticks);
+
+/**
+ * Reads clock. On success, timestamp will be set.
+ */
+static inline int aws_clock_get_ticks(struct aws_clock *clock, uint64_t *timestamp);
+
 #ifdef __cplusplus
 }
 #endif
 
+static inline int aws_clock_get_ticks(struct aws_clock *clock, uint64_t *timestamp) {
+    return clock->get_ticks(clock, timestamp);
+}
+
 #endif /* AWS_COMMON_CLOCK_H_*/
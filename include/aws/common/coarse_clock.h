@@ -0,0 +1,78 @@
+#ifndef AWS_COMMON_COARSE_CLOCK_H_
+#define AWS_COMMON_COARSE_CLOCK_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/clock.h>
+
+/*
+ * Cheap, millisecond-ish timestamps for code that reads the clock constantly but doesn't need precision: cache entry
+ * ages, idle timeouts, log lines.
+ *
+ * By default readings come from the OS coarse clocks (CLOCK_MONOTONIC_COARSE and CLOCK_REALTIME_COARSE on Linux,
+ * GetTickCount64() and GetSystemTimeAsFileTime() on Windows), which return the time as of the last scheduler tick
+ * without touching the clock hardware. Where the OS has no coarse clock, or to make reads cheaper still, a process can
+ * start the ticker: a background thread that caches both clocks every interval, after which a read is a single relaxed
+ * atomic load.
+ *
+ * Coarse monotonic ticks are only comparable with other coarse monotonic ticks, not with
+ * aws_high_res_clock_get_ticks(). Coarse system ticks are nanoseconds since the unix epoch, like
+ * aws_sys_clock_get_ticks().
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Gets coarse monotonic ticks in nanoseconds. The reading can be up to aws_coarse_clock_resolution() old.
+ */
+AWS_COMMON_API int aws_coarse_clock_get_ticks(uint64_t *timestamp);
+
+/**
+ * Returns the clock instance for aws_coarse_clock_get_ticks().
+ */
+AWS_COMMON_API struct aws_clock *aws_coarse_clock(void);
+
+/**
+ * Gets coarse system time in nanoseconds since the unix epoch. The reading can be up to
+ * aws_coarse_clock_resolution() old.
+ */
+AWS_COMMON_API int aws_coarse_sys_clock_get_ticks(uint64_t *timestamp);
+
+/**
+ * Returns how far behind the actual time a coarse reading can be, in nanoseconds: the OS clock's tick, plus the
+ * ticker interval while the ticker runs.
+ */
+AWS_COMMON_API uint64_t aws_coarse_clock_resolution(void);
+
+/**
+ * Starts the ticker thread, which refreshes the cached clocks every interval_ns. Starts nest: if the ticker is already
+ * running it keeps its interval and only a matching number of aws_coarse_clock_ticker_stop() calls stops it. Raises
+ * AWS_ERROR_UNSUPPORTED_OPERATION where nanosecond timestamps don't fit in an atomic word (32 bit platforms).
+ */
+AWS_COMMON_API int aws_coarse_clock_ticker_start(struct aws_allocator *allocator, uint64_t interval_ns);
+
+/**
+ * Undoes one aws_coarse_clock_ticker_start(), stopping and joining the ticker thread after the last one.
+ */
+AWS_COMMON_API void aws_coarse_clock_ticker_stop(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWS_COMMON_COARSE_CLOCK_H_ */
@@ -113,6 +113,17 @@ typedef enum aws_common_error {
     AWS_ERROR_LIST_STATIC_MODE_CANT_SHRINK,
     AWS_ERROR_PRIORITY_QUEUE_FULL,
     AWS_ERROR_PRIORITY_QUEUE_EMPTY,
+    AWS_ERROR_WAIT_TIMEOUT,
+    AWS_ERROR_CHANNEL_CLOSED,
+    AWS_ERROR_CHANNEL_FULL,
+    AWS_ERROR_CHANNEL_EMPTY,
+    AWS_ERROR_INVALID_ARGUMENT,
+    AWS_ERROR_RATE_LIMIT_EXCEEDED,
+    AWS_ERROR_UNSUPPORTED_OPERATION,
+    AWS_ERROR_INVALID_DATE_STR,
+    AWS_ERROR_INVALID_HISTOGRAM_ENCODING,
+    AWS_ERROR_INVALID_METRICS_ENCODING,
+    AWS_ERROR_INVALID_STATE,
 
     AWS_ERROR_END_COMMON_RANGE = 0x03FF
 } aws_common_error;
@@ -0,0 +1,99 @@
+#ifndef AWS_COMMON_DATE_TIME_H_
+#define AWS_COMMON_DATE_TIME_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/common.h>
+#include <stdint.h>
+
+/*
+ * Conversions between nanoseconds since the unix epoch (as returned by aws_sys_clock_get_ticks()) and calendar dates,
+ * plus formatters and parsers for RFC 3339 ("1994-11-06T08:49:37.123Z", i.e. ISO 8601 timestamps) and RFC 1123
+ * ("Sun, 06 Nov 1994 08:49:37 GMT", i.e. HTTP dates). Everything is UTC and locale independent, and nothing calls
+ * gmtime(), strftime() or strptime().
+ *
+ * Formatting caches the part of the string that only changes once a second, per thread, so formatting timestamps in
+ * the same second as the previous call is a copy plus the sub-second digits.
+ *
+ * Only dates from 1970 up to where nanoseconds since the epoch overflow 64 bits (2554) can be represented.
+ */
+
+/* the largest RFC 3339 string the formatter writes (nine fraction digits), including the terminating NUL. */
+#define AWS_DATE_TIME_RFC3339_MAX_LEN 31
+
+/* the length of an RFC 1123 string, including the terminating NUL. */
+#define AWS_DATE_TIME_RFC1123_LEN 30
+
+/* a broken down UTC date. */
+struct aws_date_time {
+    uint32_t year;
+    /* 1 - 12. */
+    uint8_t month;
+    /* 1 - 31. */
+    uint8_t day;
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    /* 0 is Sunday. */
+    uint8_t day_of_week;
+    uint32_t nanosecond;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Breaks epoch_ns down into a calendar date.
+ */
+AWS_COMMON_API void aws_date_time_from_epoch_ns(uint64_t epoch_ns, struct aws_date_time *date_time);
+
+/**
+ * Converts a calendar date back to nanoseconds since the epoch. day_of_week is ignored. Raises
+ * AWS_ERROR_INVALID_DATE_STR if any field is out of range or the date can't be represented.
+ */
+AWS_COMMON_API int aws_date_time_to_epoch_ns(const struct aws_date_time *date_time, uint64_t *epoch_ns);
+
+/**
+ * Writes epoch_ns as a NUL terminated RFC 3339 UTC timestamp with fraction_digits (at most 9) digits after the
+ * seconds, e.g. "2018-03-04T05:06:07.123Z". Raises AWS_ERROR_INVALID_BUFFER_SIZE if output_size is too small.
+ */
+AWS_COMMON_API int aws_date_time_format_rfc3339(uint64_t epoch_ns, size_t fraction_digits, char *output,
+        size_t output_size);
+
+/**
+ * Writes epoch_ns as a NUL terminated RFC 1123 date, e.g. "Sun, 04 Mar 2018 05:06:07 GMT". Raises
+ * AWS_ERROR_INVALID_BUFFER_SIZE if output_size is less than AWS_DATE_TIME_RFC1123_LEN.
+ */
+AWS_COMMON_API int aws_date_time_format_rfc1123(uint64_t epoch_ns, char *output, size_t output_size);
+
+/**
+ * Parses an RFC 3339 timestamp of len characters into nanoseconds since the epoch. Accepts any number of fraction
+ * digits (keeping nine), and a "Z" or numeric UTC offset. Raises AWS_ERROR_INVALID_DATE_STR if date_str isn't one.
+ */
+AWS_COMMON_API int aws_date_time_parse_rfc3339(const char *date_str, size_t len, uint64_t *epoch_ns);
+
+/**
+ * Parses an RFC 1123 date of len characters into nanoseconds since the epoch. Accepts the GMT, UT, UTC and Z zone
+ * names or a numeric offset. Raises AWS_ERROR_INVALID_DATE_STR if date_str isn't one.
+ */
+AWS_COMMON_API int aws_date_time_parse_rfc1123(const char *date_str, size_t len, uint64_t *epoch_ns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWS_COMMON_DATE_TIME_H_ */
@@ -0,0 +1,148 @@
+#ifndef AWS_COMMON_EPOCH_H_
+#define AWS_COMMON_EPOCH_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/array_list.h>
+#include <aws/common/atomics.h>
+#include <aws/common/linked_list.h>
+#include <aws/common/mutex.h>
+
+/*
+ * Epoch based reclamation (EBR) for lock-free data structures.
+ *
+ * Every thread touching a protected structure registers an aws_epoch_thread with the domain, and wraps its accesses in
+ * aws_epoch_enter()/aws_epoch_exit(). Nodes unlinked from the structure are handed to aws_epoch_retire() instead of
+ * being released; they are released through their allocator once every thread that could still hold a reference has
+ * left its critical section, i.e. once the global epoch has advanced twice.
+ *
+ * Retired nodes are batched per thread: the global epoch is only advanced (and nodes reclaimed) every
+ * AWS_EPOCH_RETIRE_BATCH retirements, so the common path is a push onto a thread local list. A thread that stays
+ * inside a critical section stalls reclamation for everyone; see hazard_ptr.h for a scheme with bounded garbage.
+ */
+
+#ifndef AWS_EPOCH_RETIRE_BATCH
+#define AWS_EPOCH_RETIRE_BATCH 64
+#endif
+
+/* retired nodes are kept in one list per epoch, and only the last three epochs can have live nodes. */
+#define AWS_EPOCH_LIMBO_LISTS 3
+
+struct aws_epoch_domain {
+    struct aws_allocator *allocator;
+    struct aws_atomic_var global_epoch;
+    /* guards threads and orphans. */
+    struct aws_mutex lock;
+    struct aws_linked_list_node threads;
+    /* nodes left behind by unregistered threads. */
+    struct aws_array_list orphans;
+};
+
+struct aws_epoch_thread {
+    struct aws_epoch_domain *domain;
+    struct aws_linked_list_node node;
+    /* (announced epoch << 1) | 1 while inside a critical section. */
+    struct aws_atomic_var state;
+    uint64_t owner_thread_id;
+    size_t nesting;
+    size_t retired_since_advance;
+    struct aws_array_list limbo[AWS_EPOCH_LIMBO_LISTS];
+    size_t limbo_epoch[AWS_EPOCH_LIMBO_LISTS];
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a reclamation domain. allocator is used for the domain's internal bookkeeping only; retired nodes are
+ * released through the allocator passed to aws_epoch_retire().
+ */
+AWS_COMMON_API int aws_epoch_domain_init(struct aws_epoch_domain *domain, struct aws_allocator *allocator);
+
+/**
+ * Releases every node still awaiting reclamation and cleans up the domain. All threads must have been unregistered.
+ */
+AWS_COMMON_API void aws_epoch_domain_clean_up(struct aws_epoch_domain *domain);
+
+/**
+ * Registers the calling aws_thread with the domain. thread must stay valid, and must only be used from the calling
+ * thread, until aws_epoch_thread_unregister() is called.
+ */
+AWS_COMMON_API int aws_epoch_thread_register(struct aws_epoch_domain *domain, struct aws_epoch_thread *thread);
+
+/**
+ * Unregisters a thread. Nodes it retired that are not yet safe to release are handed over to the domain. Must not be
+ * called inside a critical section.
+ */
+AWS_COMMON_API void aws_epoch_thread_unregister(struct aws_epoch_thread *thread);
+
+/**
+ * Hands ptr to the domain; it will be released with aws_mem_release(allocator, ptr) once no thread can still be
+ * reading it. ptr must already be unreachable for threads entering a critical section from now on.
+ * On failure (out of memory), ptr has not been retired and is still owned by the caller.
+ */
+AWS_COMMON_API int aws_epoch_retire(struct aws_epoch_thread *thread, void *ptr, struct aws_allocator *allocator);
+
+/**
+ * Tries to advance the global epoch, and releases whatever this thread retired that has become safe to release.
+ * Returns the number of nodes released.
+ */
+AWS_COMMON_API size_t aws_epoch_thread_reclaim(struct aws_epoch_thread *thread);
+
+/**
+ * Blocks until everything this thread has retired has been released. Must not be called inside a critical section,
+ * and waits for every other thread to leave the critical section it is in.
+ */
+AWS_COMMON_API void aws_epoch_thread_flush(struct aws_epoch_thread *thread);
+
+/**
+ * Returns the number of nodes retired by this thread that are still waiting to be released.
+ */
+AWS_COMMON_API size_t aws_epoch_thread_pending(const struct aws_epoch_thread *thread);
+
+/**
+ * Enters a critical section. Pointers loaded from a protected structure stay valid until the matching
+ * aws_epoch_exit(). Critical sections nest.
+ */
+static inline void aws_epoch_enter(struct aws_epoch_thread *thread);
+
+/**
+ * Leaves a critical section.
+ */
+static inline void aws_epoch_exit(struct aws_epoch_thread *thread);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline void aws_epoch_enter(struct aws_epoch_thread *thread) {
+    if (thread->nesting++ == 0) {
+        size_t epoch = aws_atomic_load_int_explicit(&thread->domain->global_epoch, aws_memory_order_relaxed);
+        aws_atomic_store_int_explicit(&thread->state, (epoch << 1) | 1, aws_memory_order_relaxed);
+        /* the announcement must be visible to reclaimers before any protected pointer is loaded. */
+        aws_atomic_thread_fence(aws_memory_order_seq_cst);
+    }
+}
+
+static inline void aws_epoch_exit(struct aws_epoch_thread *thread) {
+    if (--thread->nesting == 0) {
+        size_t state = aws_atomic_load_int_explicit(&thread->state, aws_memory_order_relaxed);
+        aws_atomic_store_int_explicit(&thread->state, state & ~(size_t)1, aws_memory_order_release);
+    }
+}
+
+#endif /* AWS_COMMON_EPOCH_H_ */
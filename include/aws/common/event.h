@@ -0,0 +1,84 @@
+#ifndef AWS_COMMON_EVENT_H_
+#define AWS_COMMON_EVENT_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/atomics.h>
+
+/*
+ * A manual reset event in a single word, for waking up a thread waiting on something (e.g. the consumer of a queue).
+ *
+ * The word is either unset, set, or unset with waiters. Waiters mark the event before going to sleep, so setting an
+ * event nobody waits on is a single atomic exchange with no system call, and setting one somebody waits on wakes them up
+ * with a single futex wake.
+ */
+struct aws_event {
+    struct aws_atomic_var state;
+};
+
+enum aws_event_state {
+    AWS_EVENT_UNSET = 0,
+    AWS_EVENT_SET = 1,
+    AWS_EVENT_WAITERS = 2,
+};
+
+#define AWS_EVENT_INIT { AWS_ATOMIC_INIT_INT(AWS_EVENT_UNSET) }
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes an unset event.
+ */
+AWS_COMMON_API void aws_event_init(struct aws_event *event);
+
+/**
+ * Sets the event, waking up every thread waiting on it. Writes made before setting the event are visible to the
+ * threads it wakes up.
+ */
+AWS_COMMON_API void aws_event_set(struct aws_event *event);
+
+/**
+ * Resets the event, if it is set. Threads already waiting keep waiting for the next aws_event_set().
+ */
+AWS_COMMON_API void aws_event_reset(struct aws_event *event);
+
+/**
+ * Blocks until the event is set.
+ */
+AWS_COMMON_API int aws_event_wait(struct aws_event *event);
+
+/**
+ * Blocks for at most timeout_ns nanoseconds until the event is set. Raises AWS_ERROR_WAIT_TIMEOUT if it was not set in
+ * time.
+ */
+AWS_COMMON_API int aws_event_wait_timeout(struct aws_event *event, uint64_t timeout_ns);
+
+/**
+ * Returns non-zero if the event is set, without blocking.
+ */
+static inline int aws_event_is_set(const struct aws_event *event);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline int aws_event_is_set(const struct aws_event *event) {
+    return aws_atomic_load_int_explicit(&event->state, aws_memory_order_acquire) == AWS_EVENT_SET;
+}
+
+#endif /* AWS_COMMON_EVENT_H_ */
@@ -0,0 +1,151 @@
+#ifndef AWS_COMMON_HAZARD_PTR_H_
+#define AWS_COMMON_HAZARD_PTR_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/array_list.h>
+#include <aws/common/atomics.h>
+#include <aws/common/linked_list.h>
+#include <aws/common/mutex.h>
+
+/*
+ * Hazard pointer reclamation for lock-free data structures.
+ *
+ * Each registered thread owns AWS_HAZARD_PTR_SLOTS slots. Before dereferencing a shared pointer, a thread publishes it
+ * in one of its slots with aws_hazard_protect(); retired nodes are only released once no slot holds them. Unlike epochs
+ * (see epoch.h), a stalled reader only pins the nodes it actually protects, so the number of unreleased nodes per
+ * thread stays bounded by the scan threshold plus the total number of slots, at the cost of a fence per protected load.
+ */
+
+#ifndef AWS_HAZARD_PTR_SLOTS
+#define AWS_HAZARD_PTR_SLOTS 4
+#endif
+
+/* a thread scans once it has at least this many retired nodes, or twice the number of slots in the domain. */
+#ifndef AWS_HAZARD_PTR_SCAN_THRESHOLD
+#define AWS_HAZARD_PTR_SCAN_THRESHOLD 32
+#endif
+
+struct aws_hazard_domain {
+    struct aws_allocator *allocator;
+    /* guards threads and orphans. */
+    struct aws_mutex lock;
+    struct aws_linked_list_node threads;
+    struct aws_atomic_var thread_count;
+    /* nodes left behind by unregistered threads. */
+    struct aws_array_list orphans;
+};
+
+struct aws_hazard_thread {
+    struct aws_hazard_domain *domain;
+    struct aws_linked_list_node node;
+    struct aws_atomic_var slots[AWS_HAZARD_PTR_SLOTS];
+    uint64_t owner_thread_id;
+    struct aws_array_list retired;
+    /* reused buffer for the hazard snapshot taken during a scan. */
+    struct aws_array_list hazards;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a hazard pointer domain. allocator is used for the domain's internal bookkeeping only; retired nodes are
+ * released through the allocator passed to aws_hazard_retire().
+ */
+AWS_COMMON_API int aws_hazard_domain_init(struct aws_hazard_domain *domain, struct aws_allocator *allocator);
+
+/**
+ * Releases every node still awaiting reclamation and cleans up the domain. All threads must have been unregistered.
+ */
+AWS_COMMON_API void aws_hazard_domain_clean_up(struct aws_hazard_domain *domain);
+
+/**
+ * Registers the calling aws_thread with the domain. thread must stay valid, and must only be used from the calling
+ * thread, until aws_hazard_thread_unregister() is called.
+ */
+AWS_COMMON_API int aws_hazard_thread_register(struct aws_hazard_domain *domain, struct aws_hazard_thread *thread);
+
+/**
+ * Clears the thread's slots and unregisters it. Nodes it retired that are still protected are handed over to the
+ * domain.
+ */
+AWS_COMMON_API void aws_hazard_thread_unregister(struct aws_hazard_thread *thread);
+
+/**
+ * Hands ptr to the domain; it will be released with aws_mem_release(allocator, ptr) once no slot protects it. ptr must
+ * already be unreachable from the shared structure. On failure (out of memory), ptr is still owned by the caller.
+ */
+AWS_COMMON_API int aws_hazard_retire(struct aws_hazard_thread *thread, void *ptr, struct aws_allocator *allocator);
+
+/**
+ * Releases every node retired by this thread that no slot protects. Returns the number of nodes released.
+ */
+AWS_COMMON_API size_t aws_hazard_scan(struct aws_hazard_thread *thread);
+
+/**
+ * Returns the number of nodes retired by this thread that are still waiting to be released.
+ */
+AWS_COMMON_API size_t aws_hazard_thread_pending(const struct aws_hazard_thread *thread);
+
+/**
+ * Loads the pointer stored in src and protects it in slot. The returned pointer stays valid until the slot is cleared
+ * or reused, as long as it is retired only after being unlinked from src.
+ */
+static inline void *aws_hazard_protect(struct aws_hazard_thread *thread, size_t slot, const struct aws_atomic_var *src);
+
+/**
+ * Protects a pointer the caller already knows to be safe (e.g. one protected by another slot), for hand-over-hand
+ * traversal.
+ */
+static inline void aws_hazard_set(struct aws_hazard_thread *thread, size_t slot, void *ptr);
+
+/**
+ * Releases the protection held in slot.
+ */
+static inline void aws_hazard_clear(struct aws_hazard_thread *thread, size_t slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline void *aws_hazard_protect(struct aws_hazard_thread *thread, size_t slot, const struct aws_atomic_var *src) {
+    void *ptr = aws_atomic_load_ptr_explicit(src, aws_memory_order_relaxed);
+
+    for (;;) {
+        aws_atomic_store_ptr_explicit(&thread->slots[slot], ptr, aws_memory_order_relaxed);
+        /* the slot must be visible to scanners before we re-validate src. */
+        aws_atomic_thread_fence(aws_memory_order_seq_cst);
+
+        void *current = aws_atomic_load_ptr_explicit(src, aws_memory_order_acquire);
+        if (AWS_LIKELY(current == ptr)) {
+            return ptr;
+        }
+        ptr = current;
+    }
+}
+
+static inline void aws_hazard_set(struct aws_hazard_thread *thread, size_t slot, void *ptr) {
+    aws_atomic_store_ptr_explicit(&thread->slots[slot], ptr, aws_memory_order_relaxed);
+    aws_atomic_thread_fence(aws_memory_order_seq_cst);
+}
+
+static inline void aws_hazard_clear(struct aws_hazard_thread *thread, size_t slot) {
+    aws_atomic_store_ptr_explicit(&thread->slots[slot], NULL, aws_memory_order_release);
+}
+
+#endif /* AWS_COMMON_HAZARD_PTR_H_ */
@@ -0,0 +1,160 @@
+#ifndef AWS_COMMON_HISTOGRAM_H_
+#define AWS_COMMON_HISTOGRAM_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/common.h>
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*
+ * A high dynamic range histogram for latencies and other positive values, e.g. nanoseconds measured with
+ * aws_high_res_clock_get_ticks(), that reports percentiles within a fixed relative error in constant memory.
+ *
+ * Buckets are log-linear: values below 2^b each get their own bucket, and every power of two range above that is
+ * split into 2^(b - 1) equal buckets, where b is picked from the requested number of significant decimal figures.
+ * Finding a value's bucket is a count-leading-zeros, a shift and an add, so recording is a handful of instructions and
+ * no loops.
+ *
+ * A histogram is not thread safe: give each thread its own and merge them for reporting. The encoded form stores runs
+ * of empty buckets compactly, for shipping histograms between processes.
+ */
+struct aws_histogram {
+    struct aws_allocator *allocator;
+    /* larger values are recorded as this. */
+    uint64_t highest_trackable_value;
+    /* b above. */
+    uint32_t sub_bucket_bits;
+    size_t counts_len;
+    uint64_t *counts;
+    uint64_t total_count;
+    /* the smallest and largest values recorded, before clamping. */
+    uint64_t min;
+    uint64_t max;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes an empty histogram for values up to highest_trackable_value, keeping significant_figures (1 to 5)
+ * decimal digits of precision: with 3, any reported value is within 0.1% of the actual value.
+ */
+AWS_COMMON_API int aws_histogram_init(struct aws_histogram *histogram, struct aws_allocator *allocator,
+        uint64_t highest_trackable_value, int significant_figures);
+
+/**
+ * Releases the histogram's buckets.
+ */
+AWS_COMMON_API void aws_histogram_clean_up(struct aws_histogram *histogram);
+
+/**
+ * Forgets every recorded value.
+ */
+AWS_COMMON_API void aws_histogram_reset(struct aws_histogram *histogram);
+
+/**
+ * Records count occurrences of value.
+ */
+AWS_COMMON_API void aws_histogram_record_n(struct aws_histogram *histogram, uint64_t value, uint64_t count);
+
+/**
+ * Adds every value recorded in from to to. The histograms may have different precisions and ranges, in which case
+ * from's values are re-bucketed at to's precision.
+ */
+AWS_COMMON_API void aws_histogram_merge(struct aws_histogram *to, const struct aws_histogram *from);
+
+/**
+ * Returns the value that percentile percent (0 to 100) of recorded values are less than or equal to, to within the
+ * histogram's precision, e.g. 99.9 for the p999. Returns 0 if nothing has been recorded.
+ */
+AWS_COMMON_API uint64_t aws_histogram_value_at_percentile(const struct aws_histogram *histogram, double percentile);
+
+/**
+ * Returns the mean of the recorded values, to within the histogram's precision.
+ */
+AWS_COMMON_API double aws_histogram_mean(const struct aws_histogram *histogram);
+
+/**
+ * Computes the length of aws_histogram_encode()'s output.
+ */
+AWS_COMMON_API int aws_histogram_compute_encoded_len(const struct aws_histogram *histogram, size_t *encoded_len);
+
+/**
+ * Encodes histogram into output, setting encoded_len to the number of bytes written. Raises
+ * AWS_ERROR_INVALID_BUFFER_SIZE if output_size is too small.
+ */
+AWS_COMMON_API int aws_histogram_encode(const struct aws_histogram *histogram, uint8_t *output, size_t output_size,
+        size_t *encoded_len);
+
+/**
+ * Initializes histogram from the output of aws_histogram_encode(). Raises AWS_ERROR_INVALID_HISTOGRAM_ENCODING if
+ * input isn't one.
+ */
+AWS_COMMON_API int aws_histogram_decode(struct aws_histogram *histogram, struct aws_allocator *allocator,
+        const uint8_t *input, size_t input_len);
+
+/**
+ * Records one occurrence of value.
+ */
+static inline void aws_histogram_record(struct aws_histogram *histogram, uint64_t value);
+
+/**
+ * Returns the index of the bucket value falls in. value must not exceed the histogram's highest trackable value.
+ */
+static inline size_t aws_histogram_bucket_index(const struct aws_histogram *histogram, uint64_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+/* the index of the highest set bit of a non-zero value. */
+static inline uint32_t aws_histogram_highest_bit(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - (uint32_t)__builtin_clzll(value);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return (uint32_t)index;
+#else
+    uint32_t index = 0;
+    while (value >>= 1) {
+        index++;
+    }
+    return index;
+#endif
+}
+
+static inline size_t aws_histogram_bucket_index(const struct aws_histogram *histogram, uint64_t value) {
+    /* below 2^b the mask makes the shift 0, so small values index themselves. */
+    uint64_t sub_bucket_mask = ((uint64_t)1 << histogram->sub_bucket_bits) - 1;
+    uint32_t shift = aws_histogram_highest_bit(value | sub_bucket_mask) - (histogram->sub_bucket_bits - 1);
+    return ((size_t)shift << (histogram->sub_bucket_bits - 1)) + (size_t)(value >> shift);
+}
+
+static inline void aws_histogram_record(struct aws_histogram *histogram, uint64_t value) {
+    uint64_t clamped = value < histogram->highest_trackable_value ? value : histogram->highest_trackable_value;
+    histogram->counts[aws_histogram_bucket_index(histogram, clamped)]++;
+    histogram->total_count++;
+    histogram->min = value < histogram->min ? value : histogram->min;
+    histogram->max = value > histogram->max ? value : histogram->max;
+}
+
+#endif /* AWS_COMMON_HISTOGRAM_H_ */
@@ -0,0 +1,65 @@
+#ifndef AWS_COMMON_LATCH_H_
+#define AWS_COMMON_LATCH_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/atomics.h>
+
+/*
+ * A single use countdown latch: threads wait until the count, set at initialization, has been counted down to zero
+ * ("wait for N workers to start"). Waiters spin briefly and then sleep in the kernel instead of polling.
+ */
+struct aws_latch {
+    struct aws_atomic_var count;
+};
+
+#define AWS_LATCH_INIT(count) { AWS_ATOMIC_INIT_INT(count) }
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a latch that opens once it has been counted down count times.
+ */
+AWS_COMMON_API void aws_latch_init(struct aws_latch *latch, size_t count);
+
+/**
+ * Decrements the count by n, waking up every waiter if it reaches zero. Counting down past zero is a bug.
+ */
+AWS_COMMON_API void aws_latch_count_down(struct aws_latch *latch, size_t n);
+
+/**
+ * Returns success if the latch is open. Otherwise returns immediately and raises AWS_ERROR_WAIT_TIMEOUT.
+ */
+AWS_COMMON_API int aws_latch_try_wait(const struct aws_latch *latch);
+
+/**
+ * Blocks until the latch is open.
+ */
+AWS_COMMON_API int aws_latch_wait(struct aws_latch *latch);
+
+/**
+ * Blocks for at most timeout_ns nanoseconds until the latch is open. Raises AWS_ERROR_WAIT_TIMEOUT if it did not open in
+ * time.
+ */
+AWS_COMMON_API int aws_latch_wait_timeout(struct aws_latch *latch, uint64_t timeout_ns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWS_COMMON_LATCH_H_ */
@@ -0,0 +1,200 @@
+#ifndef AWS_COMMON_METRICS_H_
+#define AWS_COMMON_METRICS_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/histogram.h>
+#include <aws/common/mutex.h>
+#include <aws/common/percpu.h>
+#include <stdio.h>
+
+/*
+ * A registry of named counters, gauges and histograms. Registering a metric returns a handle that stays valid until the
+ * registry is cleaned up, so it can be looked up once and then updated from hot paths. Counter increments and histogram
+ * records go to per-CPU shards and never contend; a gauge is one atomic word, since setting it can't be sharded.
+ *
+ * aws_metrics_registry_snapshot() sums up the shards into a snapshot, which can be written out in the Prometheus text
+ * exposition format or encoded into a compact binary form for shipping to another process.
+ *
+ * The library keeps its own registry (see aws_metrics_library_registry()) with counters of allocations, thread
+ * launches, contended mutex locks and raised errors, which are collected while aws_metrics_library_set_enabled() is on.
+ */
+
+enum aws_metric_type {
+    AWS_METRIC_COUNTER,
+    AWS_METRIC_GAUGE,
+    AWS_METRIC_HISTOGRAM
+};
+
+struct aws_metric {
+    /* a Prometheus metric name, [a-zA-Z_:][a-zA-Z0-9_:]*. */
+    char *name;
+    char *help;
+    enum aws_metric_type type;
+    union {
+        struct aws_sharded_counter counter;
+        /* an intptr_t, so on 32 bit targets gauges only hold values in its range. */
+        struct aws_atomic_var gauge;
+        /* one set of atomic buckets per slot. */
+        struct aws_percpu histogram;
+    } value;
+    /* the layout of a histogram's shards. */
+    uint64_t highest_trackable_value;
+    int significant_figures;
+};
+
+struct aws_metrics_registry {
+    struct aws_allocator *allocator;
+    struct aws_mutex lock;
+    /* struct aws_metric *, in registration order. */
+    struct aws_array_list metrics;
+};
+
+/*
+ * The value of one metric at the time of a snapshot.
+ */
+struct aws_metric_sample {
+    char *name;
+    char *help;
+    enum aws_metric_type type;
+    uint64_t counter;
+    int64_t gauge;
+    /* only initialized for histograms. */
+    struct aws_histogram histogram;
+};
+
+struct aws_metrics_snapshot {
+    struct aws_allocator *allocator;
+    /* struct aws_metric_sample, in registration order. */
+    struct aws_array_list samples;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes an empty registry.
+ */
+AWS_COMMON_API int aws_metrics_registry_init(struct aws_metrics_registry *registry, struct aws_allocator *allocator);
+
+/**
+ * Releases the registry and every metric registered in it.
+ */
+AWS_COMMON_API void aws_metrics_registry_clean_up(struct aws_metrics_registry *registry);
+
+/**
+ * Sets metric to the counter called name, registering it with help as its description if it doesn't exist yet. Raises
+ * AWS_ERROR_INVALID_ARGUMENT if name isn't a valid metric name or is already taken by a metric of another type.
+ */
+AWS_COMMON_API int aws_metrics_registry_counter(struct aws_metrics_registry *registry, const char *name,
+        const char *help, struct aws_metric **metric);
+
+/**
+ * Like aws_metrics_registry_counter(), for a gauge.
+ */
+AWS_COMMON_API int aws_metrics_registry_gauge(struct aws_metrics_registry *registry, const char *name,
+        const char *help, struct aws_metric **metric);
+
+/**
+ * Like aws_metrics_registry_counter(), for a histogram of values up to highest_trackable_value with
+ * significant_figures of precision (see aws_histogram_init()). Every processor gets its own copy of the buckets, so
+ * keep the range and precision to what is needed.
+ */
+AWS_COMMON_API int aws_metrics_registry_histogram(struct aws_metrics_registry *registry, const char *name,
+        const char *help, uint64_t highest_trackable_value, int significant_figures, struct aws_metric **metric);
+
+/**
+ * Sets a gauge to value. On 32 bit targets values outside the range of intptr_t wrap around.
+ */
+AWS_COMMON_API void aws_metric_gauge_set(struct aws_metric *metric, int64_t value);
+
+/**
+ * Adds delta, which may be negative, to a gauge.
+ */
+AWS_COMMON_API void aws_metric_gauge_add(struct aws_metric *metric, int64_t delta);
+
+/**
+ * Records value in a histogram. This never blocks: it is a few atomic updates of the calling processor's buckets.
+ */
+AWS_COMMON_API void aws_metric_histogram_record(struct aws_metric *metric, uint64_t value);
+
+/**
+ * Initializes snapshot with the current value of every metric in registry. Updates made while the snapshot is taken may
+ * or may not be included. The caller cleans up snapshot.
+ */
+AWS_COMMON_API int aws_metrics_registry_snapshot(struct aws_metrics_registry *registry,
+        struct aws_allocator *allocator, struct aws_metrics_snapshot *snapshot);
+
+/**
+ * Releases a snapshot.
+ */
+AWS_COMMON_API void aws_metrics_snapshot_clean_up(struct aws_metrics_snapshot *snapshot);
+
+/**
+ * Writes snapshot to out in the Prometheus text exposition format. Histograms are written as summaries of their p50,
+ * p90, p99 and p99.9.
+ */
+AWS_COMMON_API int aws_metrics_snapshot_write_prometheus(const struct aws_metrics_snapshot *snapshot, FILE *out);
+
+/**
+ * Computes the length of aws_metrics_snapshot_encode()'s output.
+ */
+AWS_COMMON_API int aws_metrics_snapshot_compute_encoded_len(const struct aws_metrics_snapshot *snapshot,
+        size_t *encoded_len);
+
+/**
+ * Encodes snapshot into output, setting encoded_len to the number of bytes written. Raises
+ * AWS_ERROR_INVALID_BUFFER_SIZE if output_size is too small.
+ */
+AWS_COMMON_API int aws_metrics_snapshot_encode(const struct aws_metrics_snapshot *snapshot, uint8_t *output,
+        size_t output_size, size_t *encoded_len);
+
+/**
+ * Initializes snapshot from the output of aws_metrics_snapshot_encode(). Raises AWS_ERROR_INVALID_METRICS_ENCODING if
+ * input isn't one.
+ */
+AWS_COMMON_API int aws_metrics_snapshot_decode(struct aws_metrics_snapshot *snapshot, struct aws_allocator *allocator,
+        const uint8_t *input, size_t input_len);
+
+/**
+ * Returns the library's own registry, holding the counters aws_allocations_total, aws_thread_launches_total,
+ * aws_mutex_contentions_total and aws_errors_raised_total, or NULL if it couldn't be created.
+ */
+AWS_COMMON_API struct aws_metrics_registry *aws_metrics_library_registry(void);
+
+/**
+ * Turns collection of the library's own metrics on or off. While it is off, each instrumented call (aws_mem_acquire(),
+ * aws_raise_error() and aws_mutex_lock()) pays an acquire load of the flag and a predictable branch; the load is a
+ * plain load on x86 but carries a barrier on weaker memory models. Turning collection on creates the library registry
+ * the first time, and raises AWS_ERROR_OOM if that fails.
+ */
+AWS_COMMON_API int aws_metrics_library_set_enabled(int enabled);
+
+/**
+ * Adds n to a counter.
+ */
+static inline void aws_metric_counter_add(struct aws_metric *metric, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline void aws_metric_counter_add(struct aws_metric *metric, size_t n) {
+    aws_sharded_counter_add(&metric->value.counter, n);
+}
+
+#endif /* AWS_COMMON_METRICS_H_ */
@@ -17,6 +17,8 @@
 */
 
 #include <aws/common/common.h>
+#include <aws/common/array_list.h>
+#include <stdio.h>
 #ifdef _WIN32
 #include <Windows.h>
 #else
@@ -30,6 +32,25 @@ struct aws_mutex {
 #else
     pthread_mutex_t mutex_handle;
 #endif
+    /* set while the lock is held by an aws_mutex_lock() call made with contention profiling on. */
+    uint64_t profile_acquired_at;
+    const void *profile_call_site;
+};
+
+/**
+ * Contention statistics for one mutex and call site of aws_mutex_lock(), as collected while profiling was on.
+ */
+struct aws_mutex_contention_stats {
+    const struct aws_mutex *mutex;
+    /* return address of the aws_mutex_lock() call. */
+    const void *call_site;
+    uint64_t acquisitions;
+    /* acquisitions that found the mutex already locked. */
+    uint64_t contentions;
+    uint64_t wait_ns;
+    uint64_t max_wait_ns;
+    uint64_t hold_ns;
+    uint64_t max_hold_ns;
 };
 
 #ifdef __cplusplus
@@ -64,6 +85,36 @@ AWS_COMMON_API int aws_mutex_try_lock(struct aws_mutex *mutex);
  */
 AWS_COMMON_API int aws_mutex_unlock(struct aws_mutex *mutex);
 
+/**
+ * Turns lock contention profiling on or off for every aws_mutex. While it is on, aws_mutex_lock() records per mutex
+ * and call site how often it had to wait, for how long, and how long the lock was then held. Statistics are
+ * accumulated in per-thread buffers, so profiling adds no shared writes, but it does read the clock on every lock and
+ * unlock. While it is off, the only cost is a relaxed load and a predictable branch.
+ */
+AWS_COMMON_API void aws_mutex_profiling_set_enabled(int enabled);
+
+/**
+ * Returns non-zero if lock contention profiling is on.
+ */
+AWS_COMMON_API int aws_mutex_profiling_enabled(void);
+
+/**
+ * Initializes stats as a list of struct aws_mutex_contention_stats merged across threads, ranked by total wait time.
+ * Mutexes are identified by address, so statistics of a cleaned up mutex merge with any mutex later created at the
+ * same address. Numbers collected while profiling is on are approximate. The caller cleans up stats.
+ */
+AWS_COMMON_API int aws_mutex_profiling_report(struct aws_allocator *allocator, struct aws_array_list *stats);
+
+/**
+ * Writes the max_entries most contended mutexes and call sites (all of them if max_entries is 0) to out, as a table.
+ */
+AWS_COMMON_API int aws_mutex_profiling_dump(FILE *out, size_t max_entries);
+
+/**
+ * Clears the statistics collected so far. Call with profiling off.
+ */
+AWS_COMMON_API void aws_mutex_profiling_reset(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,69 @@
+#ifndef AWS_COMMON_ONCE_H_
+#define AWS_COMMON_ONCE_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/atomics.h>
+
+/*
+ * Thread safe one time initialization. Once the function has run, aws_call_once() is a single acquire load and a
+ * predictable branch, so it is cheap enough to guard lazy initialization on hot paths. Threads that arrive while the
+ * function is running sleep until it returns.
+ */
+struct aws_once {
+    struct aws_atomic_var state;
+};
+
+#define AWS_ONCE_INIT { AWS_ATOMIC_INIT_INT(0) }
+
+/* once.state values. */
+enum aws_once_state {
+    AWS_ONCE_NOT_RUN = 0,
+    AWS_ONCE_RUNNING = 1,
+    AWS_ONCE_RUNNING_WITH_WAITERS = 2,
+    AWS_ONCE_DONE = 3,
+};
+
+typedef void(*aws_once_fn)(void *user_data);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Slow path of aws_call_once(); call that instead.
+ */
+AWS_COMMON_API void aws_call_once_slow(struct aws_once *flag, aws_once_fn fn, void *user_data);
+
+/**
+ * Calls fn(user_data) if no call on flag has done so yet. When this returns, fn has run to completion exactly once, and
+ * its writes are visible to the caller. fn must not call aws_call_once() on the same flag.
+ */
+static inline void aws_call_once(struct aws_once *flag, aws_once_fn fn, void *user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline void aws_call_once(struct aws_once *flag, aws_once_fn fn, void *user_data) {
+    if (AWS_LIKELY(aws_atomic_load_int_explicit(&flag->state, aws_memory_order_acquire) == AWS_ONCE_DONE)) {
+        return;
+    }
+
+    aws_call_once_slow(flag, fn, user_data);
+}
+
+#endif /* AWS_COMMON_ONCE_H_ */
@@ -0,0 +1,121 @@
+#ifndef AWS_COMMON_PERCPU_H_
+#define AWS_COMMON_PERCPU_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/atomics.h>
+
+/*
+ * Per-CPU data: one cache line aligned slot per processor, so threads updating "their" slot don't bounce cache lines
+ * between cores. Slots are chosen by the processor the caller is running on (see aws_system_info_current_cpu()), or by
+ * a per-thread hash where the platform can't tell. Threads can migrate, and two threads can share a slot, so slot
+ * contents must still be updated atomically; the point is that those atomics are almost never contended.
+ */
+struct aws_percpu {
+    struct aws_allocator *allocator;
+    /* a power of two, at least the number of processors. */
+    size_t slot_count;
+    /* element size rounded up to a multiple of the cache line. */
+    size_t slot_size;
+    void *allocation;
+    uint8_t *slots;
+};
+
+/*
+ * A counter sharded per CPU: increments are a single relaxed, almost always uncontended, atomic add; reading sums the
+ * shards, so it is only a snapshot while increments are in flight.
+ */
+struct aws_sharded_counter {
+    struct aws_percpu shards;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Allocates one zeroed, cache line aligned, element_size byte slot per processor.
+ */
+AWS_COMMON_API int aws_percpu_init(struct aws_percpu *percpu, struct aws_allocator *allocator, size_t element_size);
+
+/**
+ * Releases the slots.
+ */
+AWS_COMMON_API void aws_percpu_clean_up(struct aws_percpu *percpu);
+
+/**
+ * Returns a small index identifying the processor the caller runs on, or a stable per-thread value if the platform
+ * can't tell. Callers mask it down to their slot count.
+ */
+AWS_COMMON_API size_t aws_percpu_current_index(void);
+
+/**
+ * Initializes a sharded counter at zero.
+ */
+AWS_COMMON_API int aws_sharded_counter_init(struct aws_sharded_counter *counter, struct aws_allocator *allocator);
+
+/**
+ * Releases the counter's shards.
+ */
+AWS_COMMON_API void aws_sharded_counter_clean_up(struct aws_sharded_counter *counter);
+
+/**
+ * Returns the sum of all shards.
+ */
+AWS_COMMON_API size_t aws_sharded_counter_sum(const struct aws_sharded_counter *counter);
+
+/**
+ * Returns the number of slots.
+ */
+static inline size_t aws_percpu_slot_count(const struct aws_percpu *percpu);
+
+/**
+ * Returns slot index, which must be less than aws_percpu_slot_count().
+ */
+static inline void *aws_percpu_get(const struct aws_percpu *percpu, size_t index);
+
+/**
+ * Returns the slot for the processor the caller is currently running on.
+ */
+static inline void *aws_percpu_this_cpu(const struct aws_percpu *percpu);
+
+/**
+ * Adds n to the counter.
+ */
+static inline void aws_sharded_counter_add(struct aws_sharded_counter *counter, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline size_t aws_percpu_slot_count(const struct aws_percpu *percpu) {
+    return percpu->slot_count;
+}
+
+static inline void *aws_percpu_get(const struct aws_percpu *percpu, size_t index) {
+    return percpu->slots + index * percpu->slot_size;
+}
+
+static inline void *aws_percpu_this_cpu(const struct aws_percpu *percpu) {
+    return aws_percpu_get(percpu, aws_percpu_current_index() & (percpu->slot_count - 1));
+}
+
+static inline void aws_sharded_counter_add(struct aws_sharded_counter *counter, size_t n) {
+    struct aws_atomic_var *shard = (struct aws_atomic_var *)aws_percpu_this_cpu(&counter->shards);
+    aws_atomic_fetch_add_explicit(shard, n, aws_memory_order_relaxed);
+}
+
+#endif /* AWS_COMMON_PERCPU_H_ */
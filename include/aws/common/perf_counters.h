@@ -0,0 +1,142 @@
+#ifndef AWS_COMMON_PERF_COUNTERS_H_
+#define AWS_COMMON_PERF_COUNTERS_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/common.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Per thread hardware performance counters, for benchmarks and instrumented sections that need to know why code is
+ * slow and not only how slow it is. On Linux they are perf_event_open() events counting user space only, opened as one
+ * group so every counter covers exactly the same instructions.
+ *
+ * Counters degrade one at a time: any the kernel won't give us (no PMU in a VM, perf_event_paranoid, seccomp, other
+ * platforms) are left out of aws_perf_counter_values.available, and everything else keeps working, so benchmarks can
+ * use these unconditionally and report whatever was counted alongside their timings.
+ */
+
+enum aws_perf_counter_type {
+    AWS_PERF_COUNTER_CYCLES,
+    AWS_PERF_COUNTER_INSTRUCTIONS,
+    AWS_PERF_COUNTER_CACHE_MISSES,
+    AWS_PERF_COUNTER_BRANCH_MISSES,
+    /* CPU time in nanoseconds. A software counter, so usually there even where the hardware ones aren't. */
+    AWS_PERF_COUNTER_TASK_CLOCK,
+    AWS_PERF_COUNTER_COUNT
+};
+
+#define AWS_PERF_COUNTER_ALL ((1u << AWS_PERF_COUNTER_COUNT) - 1)
+
+struct aws_perf_counters {
+    /* -1 for counters that couldn't be opened. */
+    int fds[AWS_PERF_COUNTER_COUNT];
+    /* the first counter opened, which the others are grouped under; -1 if there are none. */
+    int leader;
+};
+
+struct aws_perf_counter_values {
+    uint64_t counts[AWS_PERF_COUNTER_COUNT];
+    /* bit (1 << type) is set for each counter in counts. */
+    uint32_t available;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Opens the counters for the calling thread; they only count that thread, and only between aws_perf_counters_start()
+ * and aws_perf_counters_stop(). Raises AWS_ERROR_UNSUPPORTED_OPERATION if none of them could be opened, but counters is
+ * usable either way, and simply counts nothing.
+ */
+AWS_COMMON_API int aws_perf_counters_init(struct aws_perf_counters *counters);
+
+/**
+ * Closes the counters.
+ */
+AWS_COMMON_API void aws_perf_counters_clean_up(struct aws_perf_counters *counters);
+
+/**
+ * Zeroes the counters and starts counting.
+ */
+AWS_COMMON_API void aws_perf_counters_start(struct aws_perf_counters *counters);
+
+/**
+ * Stops counting and stores the counts since aws_perf_counters_start() in values. When the kernel had to share the
+ * hardware with other counters the counts are scaled up to the whole period, as perf stat does.
+ */
+AWS_COMMON_API void aws_perf_counters_stop(struct aws_perf_counters *counters, struct aws_perf_counter_values *values);
+
+/**
+ * Adds the counts in from to to, e.g. to total the counters of several threads. A counter missing from either is
+ * dropped from to, so start the total out with available set to AWS_PERF_COUNTER_ALL.
+ */
+AWS_COMMON_API void aws_perf_counter_values_add(struct aws_perf_counter_values *to,
+        const struct aws_perf_counter_values *from);
+
+/**
+ * Writes a one line summary of values for benchmark output: instructions per cycle, cache and branch misses per
+ * thousand instructions and the average clock rate, as far as the counters needed were available.
+ */
+AWS_COMMON_API int aws_perf_counter_values_write_summary(FILE *out, const struct aws_perf_counter_values *values);
+
+/**
+ * Returns non-zero if values has a count for every counter in mask.
+ */
+static inline int aws_perf_counter_values_has(const struct aws_perf_counter_values *values, uint32_t mask);
+
+/**
+ * Returns instructions per cycle, or 0 if either wasn't counted.
+ */
+static inline double aws_perf_counter_values_ipc(const struct aws_perf_counter_values *values);
+
+/**
+ * Returns counter's count per thousand instructions (e.g. cache misses per kilo instruction), or 0 if either wasn't
+ * counted.
+ */
+static inline double aws_perf_counter_values_per_kilo_instruction(const struct aws_perf_counter_values *values,
+        enum aws_perf_counter_type counter);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline int aws_perf_counter_values_has(const struct aws_perf_counter_values *values, uint32_t mask) {
+    return (values->available & mask) == mask;
+}
+
+static inline double aws_perf_counter_values_ipc(const struct aws_perf_counter_values *values) {
+    uint32_t needed = (1u << AWS_PERF_COUNTER_CYCLES) | (1u << AWS_PERF_COUNTER_INSTRUCTIONS);
+    if (!aws_perf_counter_values_has(values, needed) || !values->counts[AWS_PERF_COUNTER_CYCLES]) {
+        return 0.0;
+    }
+
+    return (double)values->counts[AWS_PERF_COUNTER_INSTRUCTIONS] / (double)values->counts[AWS_PERF_COUNTER_CYCLES];
+}
+
+static inline double aws_perf_counter_values_per_kilo_instruction(const struct aws_perf_counter_values *values,
+        enum aws_perf_counter_type counter) {
+    uint32_t needed = (1u << counter) | (1u << AWS_PERF_COUNTER_INSTRUCTIONS);
+    if (!aws_perf_counter_values_has(values, needed) || !values->counts[AWS_PERF_COUNTER_INSTRUCTIONS]) {
+        return 0.0;
+    }
+
+    return (double)values->counts[counter] * 1000.0 / (double)values->counts[AWS_PERF_COUNTER_INSTRUCTIONS];
+}
+
+#endif /* AWS_COMMON_PERF_COUNTERS_H_ */
@@ -0,0 +1,40 @@
+#ifndef AWS_COMMON_PRIVATE_COARSE_CLOCK_H_
+#define AWS_COMMON_PRIVATE_COARSE_CLOCK_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/clock.h>
+
+/*
+ * The OS coarse clocks behind aws/common/coarse_clock.h, implemented next to the other clocks for each platform.
+ */
+
+/**
+ * Reads the OS coarse monotonic clock, in nanoseconds.
+ */
+int aws_coarse_clock_os_get_ticks(uint64_t *timestamp);
+
+/**
+ * Reads the OS coarse system clock, in nanoseconds since the unix epoch.
+ */
+int aws_coarse_sys_clock_os_get_ticks(uint64_t *timestamp);
+
+/**
+ * Returns the OS coarse clocks' resolution in nanoseconds.
+ */
+uint64_t aws_coarse_clock_os_resolution(void);
+
+#endif /* AWS_COMMON_PRIVATE_COARSE_CLOCK_H_ */
@@ -0,0 +1,96 @@
+#ifndef AWS_COMMON_PRIVATE_FUTEX_H_
+#define AWS_COMMON_PRIVATE_FUTEX_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/atomics.h>
+#include <aws/common/clock.h>
+
+/*
+ * Address based wait and wake, the building block for the blocking primitives. Linux uses futex(2), Windows uses
+ * WaitOnAddress(), and other platforms fall back to a table of mutex and condition variable pairs hashed by address.
+ *
+ * The kernel only compares the low 32 bits of the variable, so any change a waiter must not sleep through has to change
+ * the low 32 bits too.
+ */
+
+/* deadline meaning "never time out". */
+#define AWS_FUTEX_WAIT_FOREVER UINT64_MAX
+
+/* number of pause iterations a waiter spins before going to sleep. */
+#ifndef AWS_FUTEX_SPIN_COUNT
+#define AWS_FUTEX_SPIN_COUNT 128
+#endif
+
+/**
+ * Sleeps while var holds expected, until woken or until deadline (high res clock ticks) passes. Returns success on
+ * wake up, which may be spurious, so callers must re-check their condition. Raises AWS_ERROR_WAIT_TIMEOUT once the
+ * deadline has passed.
+ */
+int aws_futex_wait(struct aws_atomic_var *var, size_t expected, uint64_t deadline);
+
+/**
+ * Wakes up to count threads sleeping on var. SIZE_MAX wakes all of them.
+ */
+void aws_futex_wake(struct aws_atomic_var *var, size_t count);
+
+/**
+ * Converts a relative timeout in nanoseconds to a deadline for aws_futex_wait().
+ */
+static inline uint64_t aws_futex_deadline(uint64_t timeout_ns) {
+    uint64_t now = 0;
+    if (timeout_ns == AWS_FUTEX_WAIT_FOREVER || aws_high_res_clock_get_ticks(&now) ||
+            timeout_ns > AWS_FUTEX_WAIT_FOREVER - now) {
+        return AWS_FUTEX_WAIT_FOREVER;
+    }
+
+    return now + timeout_ns;
+}
+
+/**
+ * Sets remaining_ns to the time left until deadline. Raises AWS_ERROR_WAIT_TIMEOUT if it has already passed.
+ */
+static inline int aws_futex_remaining(uint64_t deadline, uint64_t *remaining_ns) {
+    uint64_t now = 0;
+    if (deadline == AWS_FUTEX_WAIT_FOREVER || aws_high_res_clock_get_ticks(&now)) {
+        *remaining_ns = AWS_FUTEX_WAIT_FOREVER;
+        return AWS_OP_SUCCESS;
+    }
+
+    if (now >= deadline) {
+        return aws_raise_error(AWS_ERROR_WAIT_TIMEOUT);
+    }
+
+    *remaining_ns = deadline - now;
+    return AWS_OP_SUCCESS;
+}
+
+/**
+ * Spins for a short while as long as var holds expected, and returns the last value loaded (with acquire semantics).
+ * Waiters call this before aws_futex_wait() so that short waits never enter the kernel.
+ */
+static inline size_t aws_futex_spin(const struct aws_atomic_var *var, size_t expected) {
+    size_t value = aws_atomic_load_int_explicit(var, aws_memory_order_acquire);
+
+    for (int i = 0; value == expected && i < AWS_FUTEX_SPIN_COUNT; ++i) {
+        aws_atomic_cpu_relax();
+        value = aws_atomic_load_int_explicit(var, aws_memory_order_acquire);
+    }
+
+    return value;
+}
+
+#endif /* AWS_COMMON_PRIVATE_FUTEX_H_ */
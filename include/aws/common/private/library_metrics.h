@@ -0,0 +1,45 @@
+#ifndef AWS_COMMON_PRIVATE_LIBRARY_METRICS_H_
+#define AWS_COMMON_PRIVATE_LIBRARY_METRICS_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/atomics.h>
+
+/*
+ * Hooks the library uses to feed its own metrics (see aws_metrics_library_set_enabled()).
+ */
+
+enum aws_library_metric {
+    AWS_LIBRARY_METRIC_ALLOCATIONS,
+    AWS_LIBRARY_METRIC_THREAD_LAUNCHES,
+    AWS_LIBRARY_METRIC_MUTEX_CONTENTIONS,
+    AWS_LIBRARY_METRIC_ERRORS_RAISED,
+    AWS_LIBRARY_METRIC_COUNT
+};
+
+extern struct aws_atomic_var aws_library_metrics_flag;
+
+static inline int aws_library_metrics_active(void) {
+    /* acquire, so the metrics set up before the flag went on are visible. */
+    return aws_atomic_load_int_explicit(&aws_library_metrics_flag, aws_memory_order_acquire) != 0;
+}
+
+/**
+ * Counts one occurrence of metric. Only call while aws_library_metrics_active().
+ */
+void aws_library_metrics_increment(enum aws_library_metric metric);
+
+#endif /* AWS_COMMON_PRIVATE_LIBRARY_METRICS_H_ */
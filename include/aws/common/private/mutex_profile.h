@@ -0,0 +1,57 @@
+#ifndef AWS_COMMON_PRIVATE_MUTEX_PROFILE_H_
+#define AWS_COMMON_PRIVATE_MUTEX_PROFILE_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/atomics.h>
+#include <aws/common/mutex.h>
+
+/*
+ * Hooks the platform aws_mutex implementations use to feed lock contention profiling (see
+ * aws_mutex_profiling_set_enabled()).
+ */
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AWS_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define AWS_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+extern struct aws_atomic_var aws_mutex_profiling_flag;
+
+static inline int aws_mutex_profiling_active(void) {
+    return aws_atomic_load_int_explicit(&aws_mutex_profiling_flag, aws_memory_order_relaxed) != 0;
+}
+
+/**
+ * Records an acquisition of mutex, made from call_site, which is now held by the calling thread. wait_start is the high
+ * res clock reading taken before blocking on a contended mutex, or 0 if it was acquired without waiting.
+ */
+void aws_mutex_profile_record_lock(struct aws_mutex *mutex, const void *call_site, uint64_t wait_start);
+
+/**
+ * Records the hold time of mutex. Must be called while still holding it, if mutex->profile_acquired_at is set.
+ */
+void aws_mutex_profile_record_unlock(struct aws_mutex *mutex);
+
+/**
+ * Called by each thread aws_thread_launch() started as it exits, to hand its statistics buffer on to the next thread
+ * that takes a profiled lock.
+ */
+void aws_mutex_profile_on_thread_exit(void);
+
+#endif /* AWS_COMMON_PRIVATE_MUTEX_PROFILE_H_ */
@@ -0,0 +1,95 @@
+#ifndef AWS_COMMON_PRIVATE_PROBES_H_
+#define AWS_COMMON_PRIVATE_PROBES_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <stdint.h>
+
+/*
+ * USDT (user space statically defined tracing) probes on the library's hot paths, for perf, bpftrace and SystemTap:
+ * e.g. `bpftrace -e 'usdt:./libaws-c-common.so:aws_c_common:mutex_lock { @[arg0] = count(); }'`. A probe compiles to a
+ * single nop plus an ELF note recording where it is and how to find its arguments; tools attach by patching the nop,
+ * so a probe nobody is attached to costs nothing but that nop. Arguments are passed as 64 bit integers.
+ *
+ * Probes are compiled in when AWS_ENABLE_USDT is defined (the AWS_ENABLE_USDT cmake option), using sys/sdt.h if it is
+ * available and otherwise emitting the same .note.stapsdt entries directly on x86-64 and aarch64 ELF targets. Elsewhere
+ * they compile to nothing.
+ */
+
+#if defined(AWS_ENABLE_USDT) && defined(AWS_HAVE_SYS_SDT_H)
+#include <sys/sdt.h>
+
+#define AWS_PROBES_ENABLED 1
+#define AWS_PROBE1(name, a1) STAP_PROBE1(aws_c_common, name, (uint64_t)(uintptr_t)(a1))
+#define AWS_PROBE2(name, a1, a2) \
+    STAP_PROBE2(aws_c_common, name, (uint64_t)(uintptr_t)(a1), (uint64_t)(uintptr_t)(a2))
+#define AWS_PROBE3(name, a1, a2, a3) STAP_PROBE3(aws_c_common, name, (uint64_t)(uintptr_t)(a1), \
+    (uint64_t)(uintptr_t)(a2), (uint64_t)(uintptr_t)(a3))
+
+#elif defined(AWS_ENABLE_USDT) && defined(__ELF__) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__aarch64__))
+
+#define AWS_PROBES_ENABLED 1
+
+/*
+ * What sys/sdt.h emits for a probe: a nop, a note in the format SystemTap defined (the nop's address, the address of
+ * .stapsdt.base for prelink adjustment, no semaphore, then the provider, name and argument specs), and a one byte
+ * .stapsdt.base section shared by every probe in the link.
+ */
+#define AWS_PROBE_ASM_(name, arg_specs, ...) \
+    __asm__ __volatile__( \
+        "990: nop\n" \
+        ".pushsection .note.stapsdt,\"\",\"note\"\n" \
+        ".balign 4\n" \
+        ".4byte 992f-991f, 994f-993f, 3\n" \
+        "991: .asciz \"stapsdt\"\n" \
+        "992: .balign 4\n" \
+        "993: .8byte 990b\n" \
+        ".8byte _.stapsdt.base\n" \
+        ".8byte 0\n" \
+        ".asciz \"aws_c_common\"\n" \
+        ".asciz \"" #name "\"\n" \
+        ".asciz \"" arg_specs "\"\n" \
+        "994: .balign 4\n" \
+        ".popsection\n" \
+        ".ifndef _.stapsdt.base\n" \
+        ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n" \
+        ".weak _.stapsdt.base\n" \
+        ".hidden _.stapsdt.base\n" \
+        "_.stapsdt.base: .space 1\n" \
+        ".size _.stapsdt.base, 1\n" \
+        ".popsection\n" \
+        ".endif\n" \
+        : : __VA_ARGS__)
+
+/* unsigned 8 byte arguments, wherever the compiler put them: a constant, a register or memory. */
+#define AWS_PROBE_ARG_(arg) "nor"((uint64_t)(uintptr_t)(arg))
+
+#define AWS_PROBE1(name, a1) AWS_PROBE_ASM_(name, "8@%0", AWS_PROBE_ARG_(a1))
+#define AWS_PROBE2(name, a1, a2) AWS_PROBE_ASM_(name, "8@%0 8@%1", AWS_PROBE_ARG_(a1), AWS_PROBE_ARG_(a2))
+#define AWS_PROBE3(name, a1, a2, a3) \
+    AWS_PROBE_ASM_(name, "8@%0 8@%1 8@%2", AWS_PROBE_ARG_(a1), AWS_PROBE_ARG_(a2), AWS_PROBE_ARG_(a3))
+
+#else
+
+#define AWS_PROBES_ENABLED 0
+#define AWS_PROBE1(name, a1) ((void)0)
+#define AWS_PROBE2(name, a1, a2) ((void)0)
+#define AWS_PROBE3(name, a1, a2, a3) ((void)0)
+
+#endif
+
+#endif /* AWS_COMMON_PRIVATE_PROBES_H_ */
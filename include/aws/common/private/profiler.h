@@ -0,0 +1,43 @@
+#ifndef AWS_COMMON_PRIVATE_PROFILER_H_
+#define AWS_COMMON_PRIVATE_PROFILER_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/profiler.h>
+#include <pthread.h>
+
+/*
+ * Hooks between the posix aws_thread implementation and the sampling profiler, so threads started while a profile is
+ * running are sampled too.
+ */
+
+/**
+ * Called by each thread aws_thread_launch() starts, before running its function.
+ */
+void aws_profiler_on_thread_start(void);
+
+/**
+ * Called by each thread aws_thread_launch() started, after its function returns or it calls pthread_exit().
+ */
+void aws_profiler_on_thread_exit(void);
+
+/**
+ * Calls fn with the pthread and kernel thread id (0 where there is none) of every thread started by aws_thread_launch()
+ * that is still running. fn runs with the thread registry locked.
+ */
+void aws_thread_registry_for_each(void (*fn)(pthread_t thread, long tid, void *user_data), void *user_data);
+
+#endif /* AWS_COMMON_PRIVATE_PROFILER_H_ */
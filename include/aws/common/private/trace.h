@@ -0,0 +1,27 @@
+#ifndef AWS_COMMON_PRIVATE_TRACE_H_
+#define AWS_COMMON_PRIVATE_TRACE_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/trace.h>
+
+/**
+ * Called by each thread aws_thread_launch() started as it exits, after its last trace event, to hand its event buffer
+ * on to the next thread that records one.
+ */
+void aws_trace_on_thread_exit(void);
+
+#endif /* AWS_COMMON_PRIVATE_TRACE_H_ */
@@ -0,0 +1,67 @@
+#ifndef AWS_COMMON_PRIVATE_VARINT_H_
+#define AWS_COMMON_PRIVATE_VARINT_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/common.h>
+#include <stdint.h>
+
+/*
+ * Little endian base 128 varints, as used by the library's compact binary encodings: 7 bits a byte, least significant
+ * first, with the high bit set on every byte but the last.
+ */
+
+/* a uint64_t takes at most 10 bytes. */
+#define AWS_VARINT_MAX_LEN 10
+
+static inline size_t aws_varint_len(uint64_t value) {
+    size_t len = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        len++;
+    }
+    return len;
+}
+
+/* writes value at output and returns the position after it. */
+static inline uint8_t *aws_varint_write(uint8_t *output, uint64_t value) {
+    while (value >= 0x80) {
+        *output++ = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    *output++ = (uint8_t)value;
+    return output;
+}
+
+/*
+ * Reads a varint at *input, which must be before end, and advances *input past it. Returns AWS_OP_ERR without raising
+ * an error if the varint is truncated or too long, so callers can raise their own format's error.
+ */
+static inline int aws_varint_read(const uint8_t **input, const uint8_t *end, uint64_t *value) {
+    uint64_t result = 0;
+    for (unsigned shift = 0; *input < end && shift < 7 * AWS_VARINT_MAX_LEN; shift += 7) {
+        uint8_t byte = *(*input)++;
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return AWS_OP_SUCCESS;
+        }
+    }
+
+    return AWS_OP_ERR;
+}
+
+#endif /* AWS_COMMON_PRIVATE_VARINT_H_ */
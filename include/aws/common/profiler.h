@@ -0,0 +1,95 @@
+#ifndef AWS_COMMON_PROFILER_H_
+#define AWS_COMMON_PROFILER_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/common.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * An in-process sampling CPU profiler, for where attaching an external profiler isn't allowed. While it runs, every
+ * thread launched with aws_thread_launch() (and any thread that calls aws_profiler_register_current_thread()) gets a
+ * SIGPROF timer on its own CPU time clock, so threads are sampled in proportion to the CPU they use. The signal handler
+ * walks the chain of frame pointers on the interrupted thread's stack into buffers allocated up front, which takes no
+ * locks and calls nothing, so a sample can land anywhere safely. Stacks are only as deep as that chain, though: code
+ * built without frame pointers cuts them short, and a leaf function without one loses its caller. Build the code being
+ * profiled with -fno-omit-frame-pointer -mno-omit-leaf-frame-pointer, as the library itself is.
+ *
+ * aws_profiler_write_folded() writes the samples as folded stacks, one "root;...;leaf count" line per distinct stack,
+ * the input format of flamegraph.pl and most flame graph viewers. Frames are named from the dynamic symbol table, or
+ * written as module+offset for addr2line when there is no symbol (e.g. static functions).
+ *
+ * There is one profiler per process. Only supported on Linux on x86, x86_64 and aarch64.
+ */
+
+struct aws_profiler_options {
+    /* samples per second of CPU time, per thread. The kernel checks CPU timers on its scheduler tick, which caps the
+     * rate actually achieved (at 250 Hz on many Linux builds). */
+    uint32_t frequency_hz;
+    /* samples kept; any more are counted as dropped. */
+    size_t max_samples;
+    /* frames kept per sample, counted from the interrupted function. */
+    size_t max_depth;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Discards any previous profile and starts sampling. Raises AWS_ERROR_INVALID_STATE if the profiler is already running
+ * and AWS_ERROR_UNSUPPORTED_OPERATION on platforms without it.
+ */
+AWS_COMMON_API int aws_profiler_start(struct aws_allocator *allocator, const struct aws_profiler_options *options);
+
+/**
+ * Stops sampling, keeping the samples taken for aws_profiler_write_folded(). Raises AWS_ERROR_INVALID_STATE if the
+ * profiler isn't running.
+ */
+AWS_COMMON_API int aws_profiler_stop(void);
+
+/**
+ * Samples the calling thread too, for threads not started with aws_thread_launch(), until the profiler stops or the
+ * thread exits. Does nothing if the profiler isn't running or isn't supported.
+ */
+AWS_COMMON_API int aws_profiler_register_current_thread(void);
+
+/**
+ * Returns the number of samples taken by the current or last profile.
+ */
+AWS_COMMON_API size_t aws_profiler_sample_count(void);
+
+/**
+ * Returns the number of samples dropped for want of space by the current or last profile.
+ */
+AWS_COMMON_API size_t aws_profiler_dropped_count(void);
+
+/**
+ * Writes the samples of the last profile to out as folded stacks. Call with the profiler stopped.
+ */
+AWS_COMMON_API int aws_profiler_write_folded(FILE *out);
+
+/**
+ * Releases the samples of the last profile. Call with the profiler stopped.
+ */
+AWS_COMMON_API void aws_profiler_clean_up(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWS_COMMON_PROFILER_H_ */
@@ -0,0 +1,121 @@
+#ifndef AWS_COMMON_RATE_LIMITER_H_
+#define AWS_COMMON_RATE_LIMITER_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/atomics.h>
+#include <aws/common/clock.h>
+#include <aws/common/percpu.h>
+
+/*
+ * A token bucket rate limiter whose entire state is one atomic word, so acquiring tokens is a load, some arithmetic
+ * and a compare and swap, with no lock.
+ *
+ * Instead of a token count plus a last-refill timestamp, the limiter tracks the time at which the bucket will be full
+ * again ("theoretical arrival time", as in the generic cell rate algorithm). Taking n tokens pushes that time n token
+ * intervals further out, and the request is refused if that would put it more than a full burst into the future.
+ * Refill is therefore implicit in the limiter's clock (aws_high_res_clock() unless the options name another) moving
+ * forward, and idle limiters cost nothing.
+ */
+struct aws_rate_limiter {
+    struct aws_clock *clock;
+    /* nanoseconds it takes to earn one token. */
+    uint64_t token_interval_ns;
+    /* token_interval_ns * burst. */
+    uint64_t burst_ns;
+    /* clock ticks at which the bucket is full again. This needs a 64 bit word, so limiters are unsupported on 32 bit
+     * targets. */
+    struct aws_atomic_var full_at;
+};
+
+struct aws_rate_limiter_options {
+    /* sustained rate, at most one per nanosecond. */
+    size_t tokens_per_second;
+    /* bucket size: the most tokens that can be taken at once after an idle period. */
+    size_t burst;
+    /* the clock to refill by. NULL means aws_high_res_clock(). */
+    struct aws_clock *clock;
+};
+
+/*
+ * A rate limiter split into one independent limiter per CPU, each with an equal share of the rate and burst, for rates
+ * high enough that even a single contended compare and swap would be a bottleneck. There are never more shards than
+ * tokens in the burst, and the shares add up to exactly the configured burst. A thread whose own shard is short tries
+ * the others, and then gathers tokens from several shards, before giving up.
+ */
+struct aws_sharded_rate_limiter {
+    struct aws_clock *clock;
+    struct aws_percpu shards;
+    /* the number of shards in use, a power of two no larger than either the burst or the number of slots. */
+    size_t shard_count;
+    size_t burst;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a limiter with a full bucket. Raises AWS_ERROR_INVALID_ARGUMENT if the rate or burst is zero or out of
+ * range, and AWS_ERROR_UNSUPPORTED_OPERATION on 32 bit targets.
+ */
+AWS_COMMON_API int aws_rate_limiter_init(struct aws_rate_limiter *limiter,
+        const struct aws_rate_limiter_options *options);
+
+/**
+ * Takes n tokens if they are available. Otherwise takes nothing and raises AWS_ERROR_RATE_LIMIT_EXCEEDED.
+ */
+AWS_COMMON_API int aws_rate_limiter_try_acquire(struct aws_rate_limiter *limiter, size_t n);
+
+/**
+ * Sets wait_ns to how long it will be until n tokens are available (zero if they are now). This is a hint: other
+ * threads may take the tokens in the meantime. Raises AWS_ERROR_RATE_LIMIT_EXCEEDED if n is larger than the burst and
+ * so will never be available.
+ */
+AWS_COMMON_API int aws_rate_limiter_time_until_available(struct aws_rate_limiter *limiter, size_t n,
+        uint64_t *wait_ns);
+
+/**
+ * Initializes a sharded limiter with full buckets, splitting the options' rate and burst evenly between the shards.
+ * Raises the same errors as aws_rate_limiter_init().
+ */
+AWS_COMMON_API int aws_sharded_rate_limiter_init(struct aws_sharded_rate_limiter *limiter,
+        struct aws_allocator *allocator, const struct aws_rate_limiter_options *options);
+
+/**
+ * Releases the limiter's shards.
+ */
+AWS_COMMON_API void aws_sharded_rate_limiter_clean_up(struct aws_sharded_rate_limiter *limiter);
+
+/**
+ * Takes n tokens from the calling CPU's shard, from any other shard that has them, or from several shards together.
+ * Otherwise takes nothing and raises AWS_ERROR_RATE_LIMIT_EXCEEDED. Tokens gathered from several shards that turn out
+ * to be too few are put back, except for any that the shards earned meanwhile.
+ */
+AWS_COMMON_API int aws_sharded_rate_limiter_try_acquire(struct aws_sharded_rate_limiter *limiter, size_t n);
+
+/**
+ * Sets wait_ns to how long it will be until some shard has n tokens available, or, if n is more than any one shard
+ * holds, until every shard is full. Raises AWS_ERROR_RATE_LIMIT_EXCEEDED if n is larger than the burst.
+ */
+AWS_COMMON_API int aws_sharded_rate_limiter_time_until_available(struct aws_sharded_rate_limiter *limiter, size_t n,
+        uint64_t *wait_ns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWS_COMMON_RATE_LIMITER_H_ */
@@ -0,0 +1,159 @@
+#ifndef AWS_COMMON_RCU_H_
+#define AWS_COMMON_RCU_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/array_list.h>
+#include <aws/common/atomics.h>
+#include <aws/common/linked_list.h>
+#include <aws/common/mutex.h>
+
+/*
+ * Read-copy-update publication of read-mostly objects (configuration, routing tables, ...).
+ *
+ * This is quiescent-state based RCU: reading an aws_rcu_ptr is a single acquire load, with no writes at all. In
+ * exchange, every reader thread registers with the domain and periodically calls aws_rcu_reader_quiescent() at a point
+ * where it holds no references to RCU protected objects (e.g. once per event loop iteration). A reader that is about to
+ * block for a long time should go offline so it does not hold up writers.
+ *
+ * Writers publish a new version with aws_rcu_ptr_publish(), and then either wait for a grace period with
+ * aws_rcu_synchronize() before releasing the old version, or hand it to aws_rcu_call() to be released later by
+ * aws_rcu_domain_poll().
+ */
+
+struct aws_rcu_domain {
+    struct aws_allocator *allocator;
+    /* incremented every time a writer starts waiting for a grace period. Never 0. */
+    struct aws_atomic_var grace_period;
+    /* guards readers and callbacks. */
+    struct aws_mutex lock;
+    struct aws_linked_list_node readers;
+    struct aws_array_list callbacks;
+};
+
+struct aws_rcu_reader {
+    struct aws_rcu_domain *domain;
+    struct aws_linked_list_node node;
+    /* the last grace period this reader observed at a quiescent state, or 0 while offline. */
+    struct aws_atomic_var observed;
+};
+
+struct aws_rcu_ptr {
+    struct aws_atomic_var ptr;
+};
+
+typedef void(*aws_rcu_callback)(void *object, void *user_data);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes an RCU domain.
+ */
+AWS_COMMON_API int aws_rcu_domain_init(struct aws_rcu_domain *domain, struct aws_allocator *allocator);
+
+/**
+ * Runs every pending callback and cleans up the domain. All readers must have been unregistered.
+ */
+AWS_COMMON_API void aws_rcu_domain_clean_up(struct aws_rcu_domain *domain);
+
+/**
+ * Registers the calling thread as an online reader. reader must stay valid until aws_rcu_reader_unregister().
+ */
+AWS_COMMON_API void aws_rcu_reader_register(struct aws_rcu_domain *domain, struct aws_rcu_reader *reader);
+
+/**
+ * Unregisters a reader. The reader must not hold references to RCU protected objects.
+ */
+AWS_COMMON_API void aws_rcu_reader_unregister(struct aws_rcu_reader *reader);
+
+/**
+ * Publishes new_object, and returns the previously published object. The previous object must not be released until a
+ * grace period has elapsed; see aws_rcu_synchronize() and aws_rcu_call().
+ */
+AWS_COMMON_API void *aws_rcu_ptr_publish(struct aws_rcu_ptr *ptr, void *new_object);
+
+/**
+ * Blocks until every online reader has passed through a quiescent state, after which no reader can hold a reference to
+ * an object unpublished before the call. Must not be called by an online reader of the same domain.
+ */
+AWS_COMMON_API void aws_rcu_synchronize(struct aws_rcu_domain *domain);
+
+/**
+ * Schedules fn(object, user_data) to run after a grace period, from a later call to aws_rcu_domain_poll() or
+ * aws_rcu_domain_clean_up().
+ */
+AWS_COMMON_API int aws_rcu_call(struct aws_rcu_domain *domain, aws_rcu_callback fn, void *object, void *user_data);
+
+/**
+ * Runs every callback whose grace period has elapsed, and returns how many ran. Never blocks on readers.
+ */
+AWS_COMMON_API size_t aws_rcu_domain_poll(struct aws_rcu_domain *domain);
+
+/**
+ * Initializes an RCU protected pointer.
+ */
+static inline void aws_rcu_ptr_init(struct aws_rcu_ptr *ptr, void *object);
+
+/**
+ * Returns the currently published object. It stays valid until the calling reader's next quiescent state.
+ */
+static inline void *aws_rcu_ptr_get(const struct aws_rcu_ptr *ptr);
+
+/**
+ * Announces that the calling reader holds no references to RCU protected objects.
+ */
+static inline void aws_rcu_reader_quiescent(struct aws_rcu_reader *reader);
+
+/**
+ * Takes the reader offline: writers stop waiting for it. It must not read RCU protected objects until it is back online.
+ */
+static inline void aws_rcu_reader_offline(struct aws_rcu_reader *reader);
+
+/**
+ * Brings an offline reader back online.
+ */
+static inline void aws_rcu_reader_online(struct aws_rcu_reader *reader);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline void aws_rcu_ptr_init(struct aws_rcu_ptr *ptr, void *object) {
+    aws_atomic_init_ptr(&ptr->ptr, object);
+}
+
+static inline void *aws_rcu_ptr_get(const struct aws_rcu_ptr *ptr) {
+    return aws_atomic_load_ptr_explicit(&ptr->ptr, aws_memory_order_acquire);
+}
+
+static inline void aws_rcu_reader_quiescent(struct aws_rcu_reader *reader) {
+    size_t grace_period = aws_atomic_load_int_explicit(&reader->domain->grace_period, aws_memory_order_acquire);
+    aws_atomic_store_int_explicit(&reader->observed, grace_period, aws_memory_order_release);
+    /* reads after the quiescent state must not be satisfied before the announcement is visible. */
+    aws_atomic_thread_fence(aws_memory_order_seq_cst);
+}
+
+static inline void aws_rcu_reader_offline(struct aws_rcu_reader *reader) {
+    aws_atomic_store_int_explicit(&reader->observed, 0, aws_memory_order_release);
+}
+
+static inline void aws_rcu_reader_online(struct aws_rcu_reader *reader) {
+    aws_rcu_reader_quiescent(reader);
+}
+
+#endif /* AWS_COMMON_RCU_H_ */
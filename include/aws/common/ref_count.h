@@ -0,0 +1,106 @@
+#ifndef AWS_COMMON_REF_COUNT_H_
+#define AWS_COMMON_REF_COUNT_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/atomics.h>
+
+/*
+ * Atomic reference counting with weak references, meant to be embedded in the object it counts.
+ *
+ * When the last strong reference is released, the destroy callback cleans up the object's contents. The object's
+ * memory itself (including the embedded aws_ref_count) stays allocated until the last weak reference is gone too, and is
+ * then released with aws_mem_release() on the allocator given at initialization. Weak references can be upgraded to
+ * strong ones for as long as a strong reference exists.
+ *
+ * A biased counter additionally has an owner thread (the one that initialized it), whose acquires and releases update a
+ * plain, non-atomic count. Other threads use the shared atomic count. When the owner's count drops to zero the two are
+ * merged, and from then on everybody uses the shared count. Other threads must only release strong references they
+ * acquired themselves, unless the owner called aws_ref_count_unbias() before handing them over.
+ */
+
+typedef void(*aws_ref_count_destroy_fn)(void *object);
+
+struct aws_ref_count {
+    struct aws_allocator *allocator;
+    void *object;
+    aws_ref_count_destroy_fn destroy;
+    /* strong count << 1, with the low bit set once there is no owner count left to merge. */
+    struct aws_atomic_var shared;
+    /* weak references, plus one for as long as any strong reference exists. */
+    struct aws_atomic_var weak;
+    /* the owner's strong count. Only touched by the owner thread. */
+    size_t biased;
+    uint64_t owner_thread_id;
+    int is_biased;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes ref_count with one strong reference, held by the caller. When the last weak and strong references are gone,
+ * object is released with aws_mem_release(allocator, object); pass a NULL allocator for objects that aren't heap
+ * allocated. destroy may be NULL.
+ */
+AWS_COMMON_API void aws_ref_count_init(struct aws_ref_count *ref_count, struct aws_allocator *allocator, void *object,
+        aws_ref_count_destroy_fn destroy);
+
+/**
+ * Same as aws_ref_count_init(), but makes the calling thread the owner: its acquires and releases use no atomics until
+ * its own count drops to zero.
+ */
+AWS_COMMON_API void aws_ref_count_init_biased(struct aws_ref_count *ref_count, struct aws_allocator *allocator,
+        void *object, aws_ref_count_destroy_fn destroy);
+
+/**
+ * Takes a strong reference. The caller must already hold a strong reference.
+ */
+AWS_COMMON_API void aws_ref_count_acquire(struct aws_ref_count *ref_count);
+
+/**
+ * Releases a strong reference, destroying the object if it was the last one.
+ */
+AWS_COMMON_API void aws_ref_count_release(struct aws_ref_count *ref_count);
+
+/**
+ * Moves the owner's references to the shared count, so that any thread may release them. Must be called on the owner
+ * thread; does nothing for unbiased counters.
+ */
+AWS_COMMON_API void aws_ref_count_unbias(struct aws_ref_count *ref_count);
+
+/**
+ * Takes a weak reference. The caller must already hold a strong or weak reference.
+ */
+AWS_COMMON_API void aws_ref_count_acquire_weak(struct aws_ref_count *ref_count);
+
+/**
+ * Releases a weak reference, releasing the object's memory if no references of either kind are left.
+ */
+AWS_COMMON_API void aws_ref_count_release_weak(struct aws_ref_count *ref_count);
+
+/**
+ * Takes a strong reference if the object has not been destroyed yet. Returns non-zero on success. The caller must hold a
+ * weak reference.
+ */
+AWS_COMMON_API int aws_ref_count_try_upgrade(struct aws_ref_count *ref_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWS_COMMON_REF_COUNT_H_ */
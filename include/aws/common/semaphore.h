@@ -0,0 +1,68 @@
+#ifndef AWS_COMMON_SEMAPHORE_H_
+#define AWS_COMMON_SEMAPHORE_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/atomics.h>
+
+/*
+ * A counting semaphore, e.g. for bounding the number of threads inside a section. Acquiring an available permit is a
+ * single compare and swap; waiters spin briefly and then sleep in the kernel (futex on Linux) instead of polling, and
+ * releases only make a wake up call when someone is actually asleep.
+ */
+struct aws_semaphore {
+    struct aws_atomic_var count;
+    /* threads sleeping (or about to sleep) on count. */
+    struct aws_atomic_var sleepers;
+};
+
+#define AWS_SEMAPHORE_INIT(initial_count) { AWS_ATOMIC_INIT_INT(initial_count), AWS_ATOMIC_INIT_INT(0) }
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a semaphore with initial_count permits.
+ */
+AWS_COMMON_API void aws_semaphore_init(struct aws_semaphore *semaphore, size_t initial_count);
+
+/**
+ * Blocks until a permit is available, and takes it.
+ */
+AWS_COMMON_API int aws_semaphore_acquire(struct aws_semaphore *semaphore);
+
+/**
+ * Takes a permit if one is available. Otherwise returns immediately and raises AWS_ERROR_WAIT_TIMEOUT.
+ */
+AWS_COMMON_API int aws_semaphore_try_acquire(struct aws_semaphore *semaphore);
+
+/**
+ * Blocks for at most timeout_ns nanoseconds until a permit is available, and takes it. Raises AWS_ERROR_WAIT_TIMEOUT
+ * if no permit became available in time.
+ */
+AWS_COMMON_API int aws_semaphore_acquire_timeout(struct aws_semaphore *semaphore, uint64_t timeout_ns);
+
+/**
+ * Returns count permits to the semaphore, waking up as many waiters.
+ */
+AWS_COMMON_API void aws_semaphore_release(struct aws_semaphore *semaphore, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWS_COMMON_SEMAPHORE_H_ */
@@ -0,0 +1,98 @@
+#ifndef AWS_COMMON_SEQLOCK_H_
+#define AWS_COMMON_SEQLOCK_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/atomics.h>
+
+/*
+ * A sequence lock for small, read-mostly records. Writers bump the sequence to an odd value, modify the record, then
+ * bump it back to even. Readers never write to the lock: they snapshot the sequence, copy the record, and retry if the
+ * sequence was odd or changed in the meantime.
+ *
+ * Writers are serialized against each other by the lock itself, but a writer spins while another writer is active, so
+ * write sections must be short. Readers may observe a torn record before the retry check fails, so never dereference
+ * pointers read from the protected record until aws_seqlock_read_retry() returns 0.
+ */
+struct aws_seqlock {
+    struct aws_atomic_var sequence;
+};
+
+#define AWS_SEQLOCK_INIT { AWS_ATOMIC_INIT_INT(0) }
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Initializes a seqlock.
+ */
+AWS_COMMON_API void aws_seqlock_init(struct aws_seqlock *lock);
+
+/**
+ * Begins a write section. Spins while another writer holds the lock.
+ */
+AWS_COMMON_API void aws_seqlock_write_begin(struct aws_seqlock *lock);
+
+/**
+ * Ends a write section started with aws_seqlock_write_begin(), publishing the modified record to readers.
+ */
+AWS_COMMON_API void aws_seqlock_write_end(struct aws_seqlock *lock);
+
+/**
+ * Copies size bytes from src into the protected record at payload inside a write section.
+ */
+AWS_COMMON_API void aws_seqlock_write(struct aws_seqlock *lock, void *payload, const void *src, size_t size);
+
+/**
+ * Copies a consistent snapshot of the size byte protected record at payload into dest, retrying until no writer
+ * interfered with the copy.
+ */
+AWS_COMMON_API void aws_seqlock_read(const struct aws_seqlock *lock, void *dest, const void *payload, size_t size);
+
+/**
+ * Begins a read section and returns the sequence to pass to aws_seqlock_read_retry(). Spins while a writer is active.
+ */
+static inline size_t aws_seqlock_read_begin(const struct aws_seqlock *lock);
+
+/**
+ * Returns non-zero if a writer modified the record since aws_seqlock_read_begin() returned seq, in which case everything
+ * read in the section must be discarded and the section restarted.
+ */
+static inline int aws_seqlock_read_retry(const struct aws_seqlock *lock, size_t seq);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline size_t aws_seqlock_read_begin(const struct aws_seqlock *lock) {
+    size_t seq = aws_atomic_load_int_explicit(&lock->sequence, aws_memory_order_acquire);
+
+    while (AWS_UNLIKELY(seq & 1)) {
+        aws_atomic_cpu_relax();
+        seq = aws_atomic_load_int_explicit(&lock->sequence, aws_memory_order_acquire);
+    }
+
+    return seq;
+}
+
+static inline int aws_seqlock_read_retry(const struct aws_seqlock *lock, size_t seq) {
+    /* keeps the reads of the record from sinking below the second load of the sequence. */
+    aws_atomic_thread_fence(aws_memory_order_acquire);
+    return aws_atomic_load_int_explicit(&lock->sequence, aws_memory_order_relaxed) != seq;
+}
+
+#endif /* AWS_COMMON_SEQLOCK_H_ */
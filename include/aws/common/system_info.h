@@ -0,0 +1,40 @@
+#ifndef AWS_COMMON_SYSTEM_INFO_H_
+#define AWS_COMMON_SYSTEM_INFO_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/common.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Returns the number of processors configured on the system. Always at least 1.
+ */
+AWS_COMMON_API size_t aws_system_info_processor_count(void);
+
+/**
+ * Returns the index of the processor the calling thread is running on, or -1 if the platform can't tell. The thread may
+ * be migrated at any time, so treat the result as a hint for spreading load, never for exclusive access.
+ */
+AWS_COMMON_API int aws_system_info_current_cpu(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWS_COMMON_SYSTEM_INFO_H_ */
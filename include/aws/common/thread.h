@@ -16,6 +16,7 @@
 * permissions and limitations under the License.
 */
 
+#include <aws/common/array_list.h>
 #include <aws/common/common.h>
 #include <stdint.h>
 
@@ -25,6 +26,16 @@
 #include <pthread.h>
 #endif
 
+/* how long before its deadline aws_thread_sleep_until() stops sleeping and starts spinning. */
+#ifndef AWS_THREAD_SLEEP_SPIN_NS
+#ifdef _WIN32
+/* Sleep() has millisecond granularity and usually rounds up to the scheduler tick. */
+#define AWS_THREAD_SLEEP_SPIN_NS 2000000
+#else
+#define AWS_THREAD_SLEEP_SPIN_NS 100000
+#endif
+#endif
+
 typedef enum aws_thread_detach_state {
     AWS_THREAD_NOT_CREATED = 1,
     AWS_THREAD_JOINABLE,
@@ -35,6 +46,20 @@ struct aws_thread_options {
     size_t stack_size;
 };
 
+/*
+ * Resource usage of one thread. Context switch counts are zero where the platform doesn't track them per thread.
+ */
+struct aws_thread_stats {
+    /* as returned by aws_thread_current_thread_id(). */
+    uint64_t thread_id;
+    /* user plus system CPU time. */
+    uint64_t cpu_time_ns;
+    /* times the thread blocked or slept. */
+    uint64_t voluntary_context_switches;
+    /* times the thread was preempted. */
+    uint64_t involuntary_context_switches;
+};
+
 struct aws_thread {
     struct aws_allocator *allocator;
     aws_thread_detach_state detach_state;
@@ -95,10 +120,42 @@ AWS_COMMON_API void aws_thread_clean_up(struct aws_thread *thread);
 AWS_COMMON_API uint64_t aws_thread_current_thread_id();
 
 /**
- * Sleeps the current thread by nanos.
+ * Sleeps the current thread by at least nanos, resuming the sleep if a signal interrupts it. How far past nanos the
+ * thread actually wakes up depends on the OS timer (and, on Linux, the thread's timer slack).
  */
 AWS_COMMON_API void aws_thread_current_sleep(uint64_t nanos);
 
+/**
+ * Sleeps the current thread until the high res clock reaches deadline (in aws_high_res_clock_get_ticks() ticks), for
+ * pacing where aws_thread_current_sleep() is too coarse. The thread sleeps until AWS_THREAD_SLEEP_SPIN_NS before the
+ * deadline and busy waits the rest, so wake ups are typically within a few microseconds of it, at the cost of burning
+ * a core for that final stretch.
+ */
+AWS_COMMON_API int aws_thread_sleep_until(uint64_t deadline);
+
+/**
+ * Sets the calling thread's timer slack: how late the kernel may wake it from sleeps so that wake ups can be batched.
+ * Lowering it makes sleeps more precise at some cost in power and CPU. Zero restores the default. Raises
+ * AWS_ERROR_UNSUPPORTED_OPERATION where the platform has no such setting (it is Linux only).
+ */
+AWS_COMMON_API int aws_thread_current_set_timer_slack(uint64_t slack_ns);
+
+/**
+ * Sets cpu_time_ns to the CPU time thread has used so far. thread must have been launched and not yet joined.
+ */
+AWS_COMMON_API int aws_thread_cpu_time(struct aws_thread *thread, uint64_t *cpu_time_ns);
+
+/**
+ * Fills stats in for the calling thread.
+ */
+AWS_COMMON_API int aws_thread_current_stats(struct aws_thread_stats *stats);
+
+/**
+ * Appends a struct aws_thread_stats to stats (a list of struct aws_thread_stats) for every thread launched with
+ * aws_thread_launch() that is still running, e.g. for dumping how much CPU each worker has used.
+ */
+AWS_COMMON_API int aws_thread_registry_get_stats(struct aws_array_list *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,109 @@
+#ifndef AWS_COMMON_TRACE_H_
+#define AWS_COMMON_TRACE_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/array_list.h>
+#include <stdio.h>
+
+/*
+ * Tracing of where time goes across threads. The AWS_TRACE_* macros record begin, end and instant events, timestamped
+ * with aws_high_res_clock_get_ticks(), into a ring buffer owned by the calling thread: recording takes no locks, makes
+ * no shared writes and allocates nothing past a thread's first event. aws_trace_collect() gathers what every thread
+ * recorded, and aws_trace_write_chrome_json() writes it out for chrome://tracing or the Perfetto UI.
+ *
+ * The macros compile to nothing unless AWS_ENABLE_TRACING is defined (the AWS_ENABLE_TRACING cmake option), in which
+ * case the library also traces thread lifetimes, waits on contended aws_mutexes and aws_array_list growth. Even then
+ * nothing is recorded until aws_trace_set_enabled() turns tracing on.
+ */
+
+#ifndef AWS_TRACE_BUFFER_EVENTS
+/* events each thread keeps before overwriting its oldest; must be a power of two. */
+#define AWS_TRACE_BUFFER_EVENTS 1024
+#endif
+
+enum aws_trace_event_type {
+    AWS_TRACE_EVENT_BEGIN,
+    AWS_TRACE_EVENT_END,
+    AWS_TRACE_EVENT_INSTANT
+};
+
+struct aws_trace_event {
+    /* high res clock ticks. */
+    uint64_t timestamp;
+    /* the thread that recorded the event, as aws_thread_current_thread_id() returned it. */
+    uint64_t thread_id;
+    /* must outlive the trace, e.g. a string literal. */
+    const char *name;
+    /* a value attached to instant events, e.g. a size. */
+    uint64_t arg;
+    enum aws_trace_event_type type;
+};
+
+#if defined(AWS_ENABLE_TRACING)
+#define AWS_TRACE_ACTIVE() aws_trace_enabled()
+#define AWS_TRACE_BEGIN(name) aws_trace_record(AWS_TRACE_EVENT_BEGIN, (name), 0)
+#define AWS_TRACE_END(name) aws_trace_record(AWS_TRACE_EVENT_END, (name), 0)
+#define AWS_TRACE_INSTANT(name, arg) aws_trace_record(AWS_TRACE_EVENT_INSTANT, (name), (arg))
+#else
+#define AWS_TRACE_ACTIVE() 0
+#define AWS_TRACE_BEGIN(name) ((void)0)
+#define AWS_TRACE_END(name) ((void)0)
+#define AWS_TRACE_INSTANT(name, arg) ((void)0)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Turns event recording on or off for every thread. While it is off, recording an event is a relaxed load and a
+ * predictable branch.
+ */
+AWS_COMMON_API void aws_trace_set_enabled(int enabled);
+
+/**
+ * Returns non-zero if event recording is on.
+ */
+AWS_COMMON_API int aws_trace_enabled(void);
+
+/**
+ * Records an event on the calling thread if tracing is on. Normally called through the AWS_TRACE_* macros.
+ */
+AWS_COMMON_API void aws_trace_record(enum aws_trace_event_type type, const char *name, uint64_t arg);
+
+/**
+ * Initializes events as a list of struct aws_trace_event holding the last AWS_TRACE_BUFFER_EVENTS events of every
+ * thread that has recorded any, including threads that have since exited. Events a thread overwrites while they are
+ * being collected are left out. The caller cleans up events.
+ */
+AWS_COMMON_API int aws_trace_collect(struct aws_allocator *allocator, struct aws_array_list *events);
+
+/**
+ * Writes events, as collected by aws_trace_collect(), to out in the Chrome trace_event JSON format.
+ */
+AWS_COMMON_API int aws_trace_write_chrome_json(FILE *out, const struct aws_array_list *events);
+
+/**
+ * Discards the events recorded so far. Call with tracing off.
+ */
+AWS_COMMON_API void aws_trace_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AWS_COMMON_TRACE_H_ */
@@ -0,0 +1,101 @@
+#ifndef AWS_COMMON_TSC_CLOCK_H_
+#define AWS_COMMON_TSC_CLOCK_H_
+
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/clock.h>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+/*
+ * A high resolution clock read from the CPU's time stamp counter, for hot paths where even the vDSO clock_gettime()
+ * behind aws_high_res_clock_get_ticks() shows up in profiles.
+ *
+ * It is only used on x86 processors that advertise an invariant TSC (one that ticks at a constant rate regardless of
+ * frequency scaling and sleep states). aws_tsc_clock_init() measures the TSC frequency against
+ * aws_high_res_clock_get_ticks(), after which aws_tsc_clock_get_ticks() returns nanoseconds on the same time base as
+ * that clock using a rdtsc and a fixed point multiply and shift. The calibration is refined about once every
+ * AWS_TSC_RECALIBRATE_NS by whichever reader notices it is due, and never steps the clock backwards.
+ *
+ * Before a successful aws_tsc_clock_init(), or where there is no usable TSC, aws_tsc_clock_get_ticks() simply calls
+ * aws_high_res_clock_get_ticks().
+ */
+
+/* how often the calibration is refined. */
+#ifndef AWS_TSC_RECALIBRATE_NS
+#define AWS_TSC_RECALIBRATE_NS 1000000000
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Returns non-zero if the processor has an invariant TSC.
+ */
+AWS_COMMON_API int aws_tsc_clock_is_supported(void);
+
+/**
+ * Calibrates the TSC clock, which takes around 10 milliseconds the first time and nothing afterwards. Raises
+ * AWS_ERROR_UNSUPPORTED_OPERATION if there is no invariant TSC, in which case the TSC clock keeps falling back to
+ * aws_high_res_clock_get_ticks().
+ */
+AWS_COMMON_API int aws_tsc_clock_init(void);
+
+/**
+ * Gets ticks in nanoseconds on the same time base as aws_high_res_clock_get_ticks(), from the TSC if it is calibrated.
+ */
+AWS_COMMON_API int aws_tsc_clock_get_ticks(uint64_t *timestamp);
+
+/**
+ * Returns the clock instance for aws_tsc_clock_get_ticks().
+ */
+AWS_COMMON_API struct aws_clock *aws_tsc_clock(void);
+
+/**
+ * Converts a difference between two aws_tsc_read() values to nanoseconds using the current calibration, so tight
+ * instrumentation can record raw counter values and convert them later. Returns tsc_delta unchanged if the TSC clock
+ * is not calibrated.
+ */
+AWS_COMMON_API uint64_t aws_tsc_to_ns(uint64_t tsc_delta);
+
+/**
+ * Reads the raw time stamp counter. This is not serializing: the CPU may execute it a little before or after the
+ * surrounding instructions. Where there is no TSC, returns aws_high_res_clock_get_ticks() nanoseconds instead.
+ */
+static inline uint64_t aws_tsc_read(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+static inline uint64_t aws_tsc_read(void) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return __rdtsc();
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    uint32_t low, high;
+    __asm__ __volatile__("rdtsc" : "=a"(low), "=d"(high));
+    return ((uint64_t)high << 32) | low;
+#else
+    uint64_t ticks = 0;
+    aws_high_res_clock_get_ticks(&ticks);
+    return ticks;
+#endif
+}
+
+#endif /* AWS_COMMON_TSC_CLOCK_H_ */
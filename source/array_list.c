@@ -14,6 +14,8 @@
 */
 
 #include <aws/common/array_list.h>
+#include <aws/common/trace.h>
+#include <aws/common/private/probes.h>
 #include <assert.h>
 
 #define SENTINAL 0xDD
@@ -100,6 +102,20 @@ int aws_array_list_pop_front(struct aws_array_list *list) {
     return aws_raise_error(AWS_ERROR_LIST_EMPTY);
 }
 
+int aws_array_list_pop_front_n(struct aws_array_list *list, size_t n) {
+    if (n > list->length) {
+        return aws_raise_error(AWS_ERROR_INVALID_INDEX);
+    }
+
+    size_t remaining_bytes = list->item_size * (list->length - n);
+    memmove(list->data, (void *)((uint8_t *)list->data + list->item_size * n), remaining_bytes);
+#ifdef DEBUG_BUILD
+    memset((void *)((uint8_t *)list->data + remaining_bytes), SENTINAL, list->item_size * n);
+#endif
+    list->length -= n;
+    return AWS_OP_SUCCESS;
+}
+
 int aws_array_list_back(const struct aws_array_list *list, void *val) {
     if (list->length > 0) {
         size_t last_item_offset = list->item_size * (list->length - 1);
@@ -235,13 +251,16 @@ int aws_array_list_set_at(struct aws_array_list *list, const void *val, size_t i
             return aws_raise_error(AWS_ERROR_LIST_EXCEEDS_MAX_SIZE);
         }
 
+        AWS_TRACE_BEGIN("aws_array_list_grow");
         void *temp = aws_mem_acquire(list->alloc, new_size);
 
         if(!temp) {
+            AWS_TRACE_END("aws_array_list_grow");
             return aws_raise_error(AWS_ERROR_OOM);
         }
 
         memcpy(temp, list->data, list->current_size);
+        AWS_PROBE3(array_list_grow, list, list->current_size, new_size);
 
 #ifdef DEBUG_BUILD
         memset((void *)((uint8_t *)temp + list->current_size), SENTINAL, new_size - list->current_size);
@@ -249,6 +268,8 @@ int aws_array_list_set_at(struct aws_array_list *list, const void *val, size_t i
         aws_mem_release(list->alloc, list->data);
         list->data = temp;
         list->current_size = new_size;
+        AWS_TRACE_INSTANT("aws_array_list_grow_bytes", new_size);
+        AWS_TRACE_END("aws_array_list_grow");
     }
 
     memcpy((void *)((uint8_t *)list->data + (list->item_size * index)), val, list->item_size);
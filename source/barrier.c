@@ -0,0 +1,53 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/barrier.h>
+#include <aws/common/private/futex.h>
+#include <assert.h>
+
+void aws_barrier_init(struct aws_barrier *barrier, size_t parties) {
+    assert(parties);
+    barrier->parties = parties;
+    aws_atomic_init_int(&barrier->remaining, parties);
+    aws_atomic_init_int(&barrier->generation, 0);
+    aws_atomic_init_int(&barrier->sleepers, 0);
+}
+
+int aws_barrier_wait(struct aws_barrier *barrier) {
+    size_t generation = aws_atomic_load_int_explicit(&barrier->generation, aws_memory_order_acquire);
+
+    if (aws_atomic_fetch_sub_explicit(&barrier->remaining, 1, aws_memory_order_acq_rel) == 1) {
+        /* nobody can arrive for the next phase before the generation changes, so the reset can't race. */
+        aws_atomic_store_int_explicit(&barrier->remaining, barrier->parties, aws_memory_order_relaxed);
+        aws_atomic_fetch_add_explicit(&barrier->generation, 1, aws_memory_order_seq_cst);
+
+        if (aws_atomic_load_int_explicit(&barrier->sleepers, aws_memory_order_seq_cst)) {
+            aws_futex_wake(&barrier->generation, SIZE_MAX);
+        }
+        return 1;
+    }
+
+    for (;;) {
+        if (aws_futex_spin(&barrier->generation, generation) != generation) {
+            return 0;
+        }
+
+        aws_atomic_fetch_add_explicit(&barrier->sleepers, 1, aws_memory_order_seq_cst);
+        if (aws_atomic_load_int_explicit(&barrier->generation, aws_memory_order_seq_cst) == generation) {
+            aws_futex_wait(&barrier->generation, generation, AWS_FUTEX_WAIT_FOREVER);
+        }
+        aws_atomic_fetch_sub_explicit(&barrier->sleepers, 1, aws_memory_order_relaxed);
+    }
+}
@@ -0,0 +1,261 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/channel.h>
+#include <aws/common/private/futex.h>
+#include <string.h>
+
+int aws_channel_init(struct aws_channel *channel, struct aws_allocator *allocator, size_t element_size,
+        size_t capacity) {
+    if (!element_size || !capacity || capacity > SIZE_MAX / element_size) {
+        return aws_raise_error(AWS_ERROR_INVALID_BUFFER_SIZE);
+    }
+
+    channel->allocator = allocator;
+    channel->element_size = element_size;
+    channel->capacity = capacity;
+    channel->head = 0;
+    channel->count = 0;
+    channel->closed = 0;
+    channel->blocked_senders = 0;
+    channel->blocked_receivers = 0;
+    aws_atomic_init_int(&channel->space_available, 0);
+    aws_atomic_init_int(&channel->items_available, 0);
+
+    channel->buffer = (uint8_t *)aws_mem_acquire(allocator, element_size * capacity);
+    if (!channel->buffer) {
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
+
+    if (aws_mutex_init(&channel->lock, allocator)) {
+        aws_mem_release(allocator, channel->buffer);
+        return AWS_OP_ERR;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_channel_clean_up(struct aws_channel *channel) {
+    aws_mutex_clean_up(&channel->lock);
+    aws_mem_release(channel->allocator, channel->buffer);
+    channel->buffer = NULL;
+}
+
+static void notify(struct aws_atomic_var *event_count, size_t waiters) {
+    aws_atomic_fetch_add_explicit(event_count, 1, aws_memory_order_release);
+    aws_futex_wake(event_count, waiters);
+}
+
+void aws_channel_close(struct aws_channel *channel) {
+    aws_mutex_lock(&channel->lock);
+    channel->closed = 1;
+    aws_mutex_unlock(&channel->lock);
+
+    notify(&channel->space_available, SIZE_MAX);
+    notify(&channel->items_available, SIZE_MAX);
+}
+
+/* copies as many of the count items as fit to the tail of the ring. Must be called with the lock held. */
+static size_t push_items(struct aws_channel *channel, const uint8_t *items, size_t count) {
+    size_t pushed = channel->capacity - channel->count;
+    if (count < pushed) {
+        pushed = count;
+    }
+
+    size_t tail = (channel->head + channel->count) % channel->capacity;
+    size_t first = channel->capacity - tail;
+    if (pushed < first) {
+        first = pushed;
+    }
+
+    size_t element_size = channel->element_size;
+    memcpy(channel->buffer + tail * element_size, items, first * element_size);
+    memcpy(channel->buffer, items + first * element_size, (pushed - first) * element_size);
+    channel->count += pushed;
+
+    return pushed;
+}
+
+/* moves up to max items from the head of the ring. Must be called with the lock held. */
+static size_t pop_items(struct aws_channel *channel, uint8_t *items, size_t max) {
+    size_t popped = channel->count < max ? channel->count : max;
+
+    size_t first = channel->capacity - channel->head;
+    if (popped < first) {
+        first = popped;
+    }
+
+    size_t element_size = channel->element_size;
+    memcpy(items, channel->buffer + channel->head * element_size, first * element_size);
+    memcpy(items + first * element_size, channel->buffer, (popped - first) * element_size);
+    channel->head = (channel->head + popped) % channel->capacity;
+    channel->count -= popped;
+
+    return popped;
+}
+
+/* sleeps on event_count until notified or until deadline. Called with the lock held, and returns with it held. */
+static int block(struct aws_channel *channel, struct aws_atomic_var *event_count, size_t *blocked,
+        uint64_t deadline) {
+    /* sampled under the lock, so any change made after we checked the ring also changes the event count. */
+    size_t seq = aws_atomic_load_int_explicit(event_count, aws_memory_order_acquire);
+    (*blocked)++;
+    aws_mutex_unlock(&channel->lock);
+
+    int err = aws_futex_wait(event_count, seq, deadline);
+
+    aws_mutex_lock(&channel->lock);
+    (*blocked)--;
+    return err;
+}
+
+static size_t min_size(size_t a, size_t b) {
+    return a < b ? a : b;
+}
+
+static int send_until(struct aws_channel *channel, const void *items, size_t count, size_t *sent, uint64_t deadline,
+        int nonblocking) {
+    const uint8_t *src = (const uint8_t *)items;
+    size_t done = 0;
+    size_t wake = 0;
+    int err = AWS_OP_SUCCESS;
+
+    aws_mutex_lock(&channel->lock);
+    for (;;) {
+        if (channel->closed) {
+            err = aws_raise_error(AWS_ERROR_CHANNEL_CLOSED);
+            break;
+        }
+
+        size_t pushed = push_items(channel, src + done * channel->element_size, count - done);
+        done += pushed;
+        wake += min_size(pushed, channel->blocked_receivers);
+
+        if (done == count) {
+            break;
+        }
+
+        if (nonblocking) {
+            err = aws_raise_error(AWS_ERROR_CHANNEL_FULL);
+            break;
+        }
+
+        /* hand what we have so far to receivers before going to sleep, or they may never make room for the rest. */
+        if (wake) {
+            aws_mutex_unlock(&channel->lock);
+            notify(&channel->items_available, wake);
+            wake = 0;
+            aws_mutex_lock(&channel->lock);
+            continue;
+        }
+
+        if (block(channel, &channel->space_available, &channel->blocked_senders, deadline)) {
+            err = AWS_OP_ERR;
+            break;
+        }
+    }
+    aws_mutex_unlock(&channel->lock);
+
+    if (wake) {
+        notify(&channel->items_available, wake);
+    }
+
+    if (sent) {
+        *sent = done;
+    }
+
+    return err;
+}
+
+static int recv_until(struct aws_channel *channel, void *items, size_t max, size_t *received, uint64_t deadline,
+        int nonblocking) {
+    size_t popped = 0;
+    size_t wake = 0;
+    int err = AWS_OP_SUCCESS;
+
+    if (!max) {
+        if (received) {
+            *received = 0;
+        }
+        return AWS_OP_SUCCESS;
+    }
+
+    aws_mutex_lock(&channel->lock);
+    for (;;) {
+        popped = pop_items(channel, (uint8_t *)items, max);
+        if (popped) {
+            wake = min_size(popped, channel->blocked_senders);
+            break;
+        }
+
+        if (channel->closed) {
+            err = aws_raise_error(AWS_ERROR_CHANNEL_CLOSED);
+            break;
+        }
+
+        if (nonblocking) {
+            err = aws_raise_error(AWS_ERROR_CHANNEL_EMPTY);
+            break;
+        }
+
+        if (block(channel, &channel->items_available, &channel->blocked_receivers, deadline)) {
+            err = AWS_OP_ERR;
+            break;
+        }
+    }
+    aws_mutex_unlock(&channel->lock);
+
+    if (wake) {
+        notify(&channel->space_available, wake);
+    }
+
+    if (received) {
+        *received = popped;
+    }
+
+    return err;
+}
+
+int aws_channel_send(struct aws_channel *channel, const void *item) {
+    return send_until(channel, item, 1, NULL, AWS_FUTEX_WAIT_FOREVER, 0);
+}
+
+int aws_channel_try_send(struct aws_channel *channel, const void *item) {
+    return send_until(channel, item, 1, NULL, AWS_FUTEX_WAIT_FOREVER, 1);
+}
+
+int aws_channel_send_timeout(struct aws_channel *channel, const void *item, uint64_t timeout_ns) {
+    return send_until(channel, item, 1, NULL, aws_futex_deadline(timeout_ns), 0);
+}
+
+int aws_channel_send_n(struct aws_channel *channel, const void *items, size_t count, size_t *sent) {
+    return send_until(channel, items, count, sent, AWS_FUTEX_WAIT_FOREVER, 0);
+}
+
+int aws_channel_recv(struct aws_channel *channel, void *item) {
+    return recv_until(channel, item, 1, NULL, AWS_FUTEX_WAIT_FOREVER, 0);
+}
+
+int aws_channel_try_recv(struct aws_channel *channel, void *item) {
+    return recv_until(channel, item, 1, NULL, AWS_FUTEX_WAIT_FOREVER, 1);
+}
+
+int aws_channel_recv_timeout(struct aws_channel *channel, void *item, uint64_t timeout_ns) {
+    return recv_until(channel, item, 1, NULL, aws_futex_deadline(timeout_ns), 0);
+}
+
+int aws_channel_recv_n(struct aws_channel *channel, void *items, size_t max, size_t *received) {
+    return recv_until(channel, items, max, received, AWS_FUTEX_WAIT_FOREVER, 0);
+}
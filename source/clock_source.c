@@ -0,0 +1,67 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/clock.h>
+
+static int high_res_get_ticks(struct aws_clock *clock, uint64_t *timestamp) {
+    (void)clock;
+    return aws_high_res_clock_get_ticks(timestamp);
+}
+
+static int sys_get_ticks(struct aws_clock *clock, uint64_t *timestamp) {
+    (void)clock;
+    return aws_sys_clock_get_ticks(timestamp);
+}
+
+static struct aws_clock high_res_clock = {
+    .get_ticks = high_res_get_ticks,
+    .impl = NULL,
+};
+
+static struct aws_clock sys_clock = {
+    .get_ticks = sys_get_ticks,
+    .impl = NULL,
+};
+
+struct aws_clock *aws_high_res_clock(void) {
+    return &high_res_clock;
+}
+
+struct aws_clock *aws_sys_clock(void) {
+    return &sys_clock;
+}
+
+static int manual_get_ticks(struct aws_clock *clock, uint64_t *timestamp) {
+    struct aws_manual_clock *manual = (struct aws_manual_clock *)clock->impl;
+    aws_seqlock_read(&manual->lock, timestamp, &manual->now, sizeof(manual->now));
+    return AWS_OP_SUCCESS;
+}
+
+void aws_manual_clock_init(struct aws_manual_clock *clock, uint64_t start_ticks) {
+    clock->clock.get_ticks = manual_get_ticks;
+    clock->clock.impl = clock;
+    aws_seqlock_init(&clock->lock);
+    clock->now = start_ticks;
+}
+
+void aws_manual_clock_advance(struct aws_manual_clock *clock, uint64_t ns) {
+    aws_seqlock_write_begin(&clock->lock);
+    clock->now += ns;
+    aws_seqlock_write_end(&clock->lock);
+}
+
+void aws_manual_clock_set(struct aws_manual_clock *clock, uint64_t ticks) {
+    aws_seqlock_write(&clock->lock, &clock->now, &ticks, sizeof(ticks));
+}
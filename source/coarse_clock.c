@@ -0,0 +1,154 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/coarse_clock.h>
+#include <aws/common/atomics.h>
+#include <aws/common/event.h>
+#include <aws/common/mutex.h>
+#include <aws/common/once.h>
+#include <aws/common/thread.h>
+#include <aws/common/private/coarse_clock.h>
+
+/* readings cached by the ticker, zero while it isn't running. */
+static struct aws_atomic_var cached_ticks = AWS_ATOMIC_INIT_INT(0);
+static struct aws_atomic_var cached_sys_ticks = AWS_ATOMIC_INIT_INT(0);
+static struct aws_atomic_var ticker_interval_ns = AWS_ATOMIC_INIT_INT(0);
+
+/* guards starting and stopping the ticker. */
+static struct aws_mutex ticker_lock;
+static struct aws_once ticker_lock_once = AWS_ONCE_INIT;
+static size_t ticker_users;
+static struct aws_thread ticker_thread;
+static struct aws_event ticker_stop;
+
+static void init_ticker_lock(void *user_data) {
+    (void)user_data;
+    aws_mutex_init(&ticker_lock, aws_default_allocator());
+}
+
+static void tick(void) {
+    uint64_t ticks = 0, sys_ticks = 0;
+
+    if (!aws_coarse_clock_os_get_ticks(&ticks) && !aws_coarse_sys_clock_os_get_ticks(&sys_ticks)) {
+        aws_atomic_store_int_explicit(&cached_ticks, (size_t)ticks, aws_memory_order_relaxed);
+        aws_atomic_store_int_explicit(&cached_sys_ticks, (size_t)sys_ticks, aws_memory_order_relaxed);
+    }
+}
+
+static void ticker_fn(void *arg) {
+    (void)arg;
+    uint64_t interval_ns = aws_atomic_load_int(&ticker_interval_ns);
+
+    /* the wait times out every interval, until aws_coarse_clock_ticker_stop() sets the event. */
+    while (aws_event_wait_timeout(&ticker_stop, interval_ns)) {
+        tick();
+    }
+}
+
+static void clear_cache(void) {
+    aws_atomic_store_int(&cached_ticks, 0);
+    aws_atomic_store_int(&cached_sys_ticks, 0);
+    aws_atomic_store_int(&ticker_interval_ns, 0);
+}
+
+int aws_coarse_clock_get_ticks(uint64_t *timestamp) {
+    size_t cached = aws_atomic_load_int_explicit(&cached_ticks, aws_memory_order_relaxed);
+    if (AWS_LIKELY(cached)) {
+        *timestamp = cached;
+        return AWS_OP_SUCCESS;
+    }
+
+    return aws_coarse_clock_os_get_ticks(timestamp);
+}
+
+int aws_coarse_sys_clock_get_ticks(uint64_t *timestamp) {
+    size_t cached = aws_atomic_load_int_explicit(&cached_sys_ticks, aws_memory_order_relaxed);
+    if (AWS_LIKELY(cached)) {
+        *timestamp = cached;
+        return AWS_OP_SUCCESS;
+    }
+
+    return aws_coarse_sys_clock_os_get_ticks(timestamp);
+}
+
+uint64_t aws_coarse_clock_resolution(void) {
+    return aws_coarse_clock_os_resolution() + aws_atomic_load_int_explicit(&ticker_interval_ns,
+            aws_memory_order_relaxed);
+}
+
+int aws_coarse_clock_ticker_start(struct aws_allocator *allocator, uint64_t interval_ns) {
+#if SIZE_MAX < UINT64_MAX
+    (void)allocator;
+    (void)interval_ns;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+#else
+    if (!interval_ns) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    aws_call_once(&ticker_lock_once, init_ticker_lock, NULL);
+    aws_mutex_lock(&ticker_lock);
+
+    if (ticker_users++) {
+        aws_mutex_unlock(&ticker_lock);
+        return AWS_OP_SUCCESS;
+    }
+
+    aws_atomic_store_int(&ticker_interval_ns, (size_t)interval_ns);
+    aws_event_init(&ticker_stop);
+    /* fill the cache before anyone can read it, so readings never go backwards when switching over. */
+    tick();
+
+    aws_thread_init(&ticker_thread, allocator);
+    if (aws_thread_launch(&ticker_thread, ticker_fn, NULL, NULL)) {
+        ticker_users = 0;
+        clear_cache();
+        aws_mutex_unlock(&ticker_lock);
+        return AWS_OP_ERR;
+    }
+
+    aws_mutex_unlock(&ticker_lock);
+    return AWS_OP_SUCCESS;
+#endif
+}
+
+void aws_coarse_clock_ticker_stop(void) {
+    aws_call_once(&ticker_lock_once, init_ticker_lock, NULL);
+    aws_mutex_lock(&ticker_lock);
+
+    if (ticker_users && !--ticker_users) {
+        aws_event_set(&ticker_stop);
+        aws_thread_join(&ticker_thread);
+        aws_thread_clean_up(&ticker_thread);
+        /* readers go back to the OS clock, which is at or past the last cached reading. */
+        clear_cache();
+    }
+
+    aws_mutex_unlock(&ticker_lock);
+}
+
+static int clock_get_ticks(struct aws_clock *clock, uint64_t *timestamp) {
+    (void)clock;
+    return aws_coarse_clock_get_ticks(timestamp);
+}
+
+static struct aws_clock clock_instance = {
+    .get_ticks = clock_get_ticks,
+    .impl = NULL,
+};
+
+struct aws_clock *aws_coarse_clock(void) {
+    return &clock_instance;
+}
@@ -14,6 +14,9 @@
 */
 
 #include <aws/common/common.h>
+#include <aws/common/once.h>
+#include <aws/common/private/library_metrics.h>
+#include <aws/common/private/probes.h>
 #include <stdlib.h>
 
 /* turn off unused named parameter warning on msvc.*/
@@ -40,15 +43,20 @@ struct aws_allocator *aws_default_allocator() {
 }
 
 void *aws_mem_acquire(struct aws_allocator *allocator, size_t size) {
-    return allocator->mem_acquire(allocator, size);
+    if (AWS_UNLIKELY(aws_library_metrics_active())) {
+        aws_library_metrics_increment(AWS_LIBRARY_METRIC_ALLOCATIONS);
+    }
+
+    void *mem = allocator->mem_acquire(allocator, size);
+    AWS_PROBE3(mem_acquire, allocator, size, mem);
+    return mem;
 }
 
 void aws_mem_release(struct aws_allocator *allocator, void *ptr) {
+    AWS_PROBE2(mem_release, allocator, ptr);
     allocator->mem_release(allocator, ptr);
 }
 
-static int8_t error_strings_loaded = 0;
-
 static struct aws_error_info errors[] = {
         AWS_DEFINE_ERROR_INFO(aws_error_success, AWS_ERROR_SUCCESS, "success", AWS_LIB_NAME),
         AWS_DEFINE_ERROR_INFO(aws_error_oom, AWS_ERROR_OOM, "out-of-memory", AWS_LIB_NAME),
@@ -72,6 +80,19 @@ static struct aws_error_info errors[] = {
         AWS_DEFINE_ERROR_INFO(aws_error_list_dest_copy_too_small, AWS_ERROR_LIST_DEST_COPY_TOO_SMALL, "destination of list copy is too small", AWS_LIB_NAME),
         AWS_DEFINE_ERROR_INFO(aws_error_list_exceeds_max_size, AWS_ERROR_LIST_EXCEEDS_MAX_SIZE, "a requested operation on a list would exceed it's max size.", AWS_LIB_NAME),
         AWS_DEFINE_ERROR_INFO(aws_error_list_static_mode_cant_shrink, AWS_ERROR_LIST_STATIC_MODE_CANT_SHRINK, "attempt to shrink a list in static mode", AWS_LIB_NAME),
+        AWS_DEFINE_ERROR_INFO(aws_error_priority_queue_full, AWS_ERROR_PRIORITY_QUEUE_FULL, "priority queue is full", AWS_LIB_NAME),
+        AWS_DEFINE_ERROR_INFO(aws_error_priority_queue_empty, AWS_ERROR_PRIORITY_QUEUE_EMPTY, "priority queue is empty", AWS_LIB_NAME),
+        AWS_DEFINE_ERROR_INFO(aws_error_wait_timeout, AWS_ERROR_WAIT_TIMEOUT, "timed out waiting on a synchronization primitive", AWS_LIB_NAME),
+        AWS_DEFINE_ERROR_INFO(aws_error_channel_closed, AWS_ERROR_CHANNEL_CLOSED, "channel is closed", AWS_LIB_NAME),
+        AWS_DEFINE_ERROR_INFO(aws_error_channel_full, AWS_ERROR_CHANNEL_FULL, "channel is full", AWS_LIB_NAME),
+        AWS_DEFINE_ERROR_INFO(aws_error_channel_empty, AWS_ERROR_CHANNEL_EMPTY, "channel is empty", AWS_LIB_NAME),
+        AWS_DEFINE_ERROR_INFO(aws_error_invalid_argument, AWS_ERROR_INVALID_ARGUMENT, "invalid argument", AWS_LIB_NAME),
+        AWS_DEFINE_ERROR_INFO(aws_error_rate_limit_exceeded, AWS_ERROR_RATE_LIMIT_EXCEEDED, "rate limit exceeded", AWS_LIB_NAME),
+        AWS_DEFINE_ERROR_INFO(aws_error_unsupported_operation, AWS_ERROR_UNSUPPORTED_OPERATION, "operation is not supported on this platform", AWS_LIB_NAME),
+        AWS_DEFINE_ERROR_INFO(aws_error_invalid_date_str, AWS_ERROR_INVALID_DATE_STR, "invalid date string", AWS_LIB_NAME),
+        AWS_DEFINE_ERROR_INFO(aws_error_invalid_histogram_encoding, AWS_ERROR_INVALID_HISTOGRAM_ENCODING, "invalid histogram encoding", AWS_LIB_NAME),
+        AWS_DEFINE_ERROR_INFO(aws_error_invalid_metrics_encoding, AWS_ERROR_INVALID_METRICS_ENCODING, "invalid metrics encoding", AWS_LIB_NAME),
+        AWS_DEFINE_ERROR_INFO(aws_error_invalid_state, AWS_ERROR_INVALID_STATE, "operation is not valid in the current state", AWS_LIB_NAME),
 };
 
 static struct aws_error_info_list list = {
@@ -79,9 +100,12 @@ static struct aws_error_info_list list = {
         .count = sizeof(errors) / sizeof(struct aws_error_info),
 };
 
+static struct aws_once error_strings_once = AWS_ONCE_INIT;
+
+static void register_error_strings(void *user_data) {
+    aws_register_error_info((const struct aws_error_info_list *)user_data);
+}
+
 void aws_load_error_strings(void) {
-    if(!error_strings_loaded) {
-        error_strings_loaded = 1;
-        aws_register_error_info(&list);
-    }
+    aws_call_once(&error_strings_once, register_error_strings, &list);
 }
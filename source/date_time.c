@@ -0,0 +1,393 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/date_time.h>
+
+#include <string.h>
+
+static const uint64_t NS_PER_SEC = 1000000000;
+static const uint64_t SECONDS_PER_DAY = 86400;
+/* 1970-01-01 was a Thursday. */
+static const uint64_t EPOCH_DAY_OF_WEEK = 4;
+
+static const char month_names[12][4] = {
+    "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec",
+};
+
+static const char day_names[7][4] = {
+    "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat",
+};
+
+/*
+ * The calendar conversions are H. Hinnant's days_from_civil() and civil_from_days(), restricted to dates after the
+ * epoch. They count in 400 year eras (146097 days) of years starting on March 1st, which puts the leap day last.
+ */
+static uint64_t days_from_civil(uint32_t year, uint32_t month, uint32_t day) {
+    year -= month <= 2;
+    uint32_t era = year / 400;
+    uint32_t year_of_era = year - era * 400;
+    uint32_t day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    uint32_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return (uint64_t)era * 146097 + day_of_era - 719468;
+}
+
+static void civil_from_days(uint64_t days, struct aws_date_time *date_time) {
+    days += 719468;
+    uint64_t era = days / 146097;
+    uint32_t day_of_era = (uint32_t)(days - era * 146097);
+    uint32_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    uint32_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    uint32_t month_index = (5 * day_of_year + 2) / 153;
+
+    date_time->day = (uint8_t)(day_of_year - (153 * month_index + 2) / 5 + 1);
+    date_time->month = (uint8_t)(month_index < 10 ? month_index + 3 : month_index - 9);
+    date_time->year = (uint32_t)(era * 400) + year_of_era + (date_time->month <= 2);
+}
+
+static uint32_t days_in_month(uint32_t year, uint32_t month) {
+    static const uint8_t days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    int leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return days[month - 1] + (month == 2 && leap);
+}
+
+void aws_date_time_from_epoch_ns(uint64_t epoch_ns, struct aws_date_time *date_time) {
+    uint64_t seconds = epoch_ns / NS_PER_SEC;
+    uint64_t days = seconds / SECONDS_PER_DAY;
+    uint32_t second_of_day = (uint32_t)(seconds % SECONDS_PER_DAY);
+
+    civil_from_days(days, date_time);
+    date_time->hour = (uint8_t)(second_of_day / 3600);
+    date_time->minute = (uint8_t)(second_of_day / 60 % 60);
+    date_time->second = (uint8_t)(second_of_day % 60);
+    date_time->day_of_week = (uint8_t)((days + EPOCH_DAY_OF_WEEK) % 7);
+    date_time->nanosecond = (uint32_t)(epoch_ns % NS_PER_SEC);
+}
+
+int aws_date_time_to_epoch_ns(const struct aws_date_time *date_time, uint64_t *epoch_ns) {
+    /* a second of 60 is a leap second, which unix time folds into the next minute. */
+    if (date_time->year < 1970 || date_time->year > 9999 || date_time->month < 1 || date_time->month > 12 ||
+            date_time->day < 1 || date_time->day > days_in_month(date_time->year, date_time->month) ||
+            date_time->hour > 23 || date_time->minute > 59 || date_time->second > 60 ||
+            date_time->nanosecond >= NS_PER_SEC) {
+        return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+    }
+
+    uint64_t seconds = days_from_civil(date_time->year, date_time->month, date_time->day) * SECONDS_PER_DAY +
+            date_time->hour * 3600 + date_time->minute * 60 + date_time->second;
+    if (seconds > (UINT64_MAX - date_time->nanosecond) / NS_PER_SEC) {
+        return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+    }
+
+    *epoch_ns = seconds * NS_PER_SEC + date_time->nanosecond;
+    return AWS_OP_SUCCESS;
+}
+
+static void write_digits(char *output, uint32_t value, size_t width) {
+    while (width) {
+        output[--width] = (char)('0' + value % 10);
+        value /= 10;
+    }
+}
+
+/* the parts of the formatted strings that only change once a second, for the last second formatted on this thread. */
+#define RFC3339_PREFIX_LEN 19
+
+struct format_cache {
+    uint64_t rfc3339_second;
+    uint64_t rfc1123_second;
+    char rfc3339_prefix[RFC3339_PREFIX_LEN];
+    char rfc1123[AWS_DATE_TIME_RFC1123_LEN];
+};
+
+static AWS_THREAD_LOCAL struct format_cache format_cache = { UINT64_MAX, UINT64_MAX, { 0 }, { 0 } };
+
+int aws_date_time_format_rfc3339(uint64_t epoch_ns, size_t fraction_digits, char *output, size_t output_size) {
+    if (fraction_digits > 9) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    /* "YYYY-MM-DDTHH:MM:SS", ".fff", "Z", NUL. */
+    size_t length = RFC3339_PREFIX_LEN + (fraction_digits ? fraction_digits + 1 : 0) + 1;
+    if (output_size < length + 1) {
+        return aws_raise_error(AWS_ERROR_INVALID_BUFFER_SIZE);
+    }
+
+    uint64_t second = epoch_ns / NS_PER_SEC;
+    if (format_cache.rfc3339_second != second) {
+        struct aws_date_time date_time;
+        char *prefix = format_cache.rfc3339_prefix;
+
+        aws_date_time_from_epoch_ns(epoch_ns, &date_time);
+        write_digits(prefix, date_time.year, 4);
+        prefix[4] = '-';
+        write_digits(prefix + 5, date_time.month, 2);
+        prefix[7] = '-';
+        write_digits(prefix + 8, date_time.day, 2);
+        prefix[10] = 'T';
+        write_digits(prefix + 11, date_time.hour, 2);
+        prefix[13] = ':';
+        write_digits(prefix + 14, date_time.minute, 2);
+        prefix[16] = ':';
+        write_digits(prefix + 17, date_time.second, 2);
+        format_cache.rfc3339_second = second;
+    }
+
+    memcpy(output, format_cache.rfc3339_prefix, RFC3339_PREFIX_LEN);
+    char *cursor = output + RFC3339_PREFIX_LEN;
+
+    if (fraction_digits) {
+        uint32_t fraction = (uint32_t)(epoch_ns % NS_PER_SEC);
+        for (size_t i = fraction_digits; i < 9; ++i) {
+            fraction /= 10;
+        }
+        *cursor++ = '.';
+        write_digits(cursor, fraction, fraction_digits);
+        cursor += fraction_digits;
+    }
+
+    *cursor++ = 'Z';
+    *cursor = '\0';
+    return AWS_OP_SUCCESS;
+}
+
+int aws_date_time_format_rfc1123(uint64_t epoch_ns, char *output, size_t output_size) {
+    if (output_size < AWS_DATE_TIME_RFC1123_LEN) {
+        return aws_raise_error(AWS_ERROR_INVALID_BUFFER_SIZE);
+    }
+
+    uint64_t second = epoch_ns / NS_PER_SEC;
+    if (format_cache.rfc1123_second != second) {
+        struct aws_date_time date_time;
+        char *date = format_cache.rfc1123;
+
+        /* "Sun, 06 Nov 1994 08:49:37 GMT" */
+        aws_date_time_from_epoch_ns(epoch_ns, &date_time);
+        memcpy(date, day_names[date_time.day_of_week], 3);
+        date[3] = ',';
+        date[4] = ' ';
+        write_digits(date + 5, date_time.day, 2);
+        date[7] = ' ';
+        memcpy(date + 8, month_names[date_time.month - 1], 3);
+        date[11] = ' ';
+        write_digits(date + 12, date_time.year, 4);
+        date[16] = ' ';
+        write_digits(date + 17, date_time.hour, 2);
+        date[19] = ':';
+        write_digits(date + 20, date_time.minute, 2);
+        date[22] = ':';
+        write_digits(date + 23, date_time.second, 2);
+        memcpy(date + 25, " GMT", 5);
+        format_cache.rfc1123_second = second;
+    }
+
+    memcpy(output, format_cache.rfc1123, AWS_DATE_TIME_RFC1123_LEN);
+    return AWS_OP_SUCCESS;
+}
+
+struct date_parser {
+    const char *cursor;
+    const char *end;
+};
+
+static int is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static int peek(const struct date_parser *parser, char c) {
+    return parser->cursor < parser->end && *parser->cursor == c;
+}
+
+static int accept(struct date_parser *parser, char c) {
+    if (peek(parser, c)) {
+        parser->cursor++;
+        return 1;
+    }
+
+    return 0;
+}
+
+static int accept_word(struct date_parser *parser, const char *word) {
+    size_t len = strlen(word);
+    if ((size_t)(parser->end - parser->cursor) < len || memcmp(parser->cursor, word, len)) {
+        return 0;
+    }
+
+    parser->cursor += len;
+    return 1;
+}
+
+/* parses between min_digits and max_digits decimal digits. */
+static int accept_number(struct date_parser *parser, size_t min_digits, size_t max_digits, uint32_t *value) {
+    size_t digits = 0;
+    *value = 0;
+
+    while (digits < max_digits && parser->cursor < parser->end && is_digit(*parser->cursor)) {
+        *value = *value * 10 + (uint32_t)(*parser->cursor++ - '0');
+        digits++;
+    }
+
+    return digits >= min_digits;
+}
+
+/* shifts a local time by a UTC offset ("+" means ahead of UTC) and checks the result is still representable. */
+static int apply_offset(uint64_t *epoch_ns, int ahead, uint32_t offset_seconds) {
+    uint64_t offset_ns = (uint64_t)offset_seconds * NS_PER_SEC;
+
+    if (ahead) {
+        if (*epoch_ns < offset_ns) {
+            return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+        }
+        *epoch_ns -= offset_ns;
+    }
+    else {
+        if (*epoch_ns > UINT64_MAX - offset_ns) {
+            return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+        }
+        *epoch_ns += offset_ns;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static int fields_to_epoch_ns(uint32_t year, uint32_t month, uint32_t day, uint32_t hour, uint32_t minute,
+        uint32_t second, uint32_t nanosecond, uint64_t *epoch_ns) {
+    if (month > 12 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+        return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+    }
+
+    struct aws_date_time date_time = {
+        .year = year,
+        .month = (uint8_t)month,
+        .day = (uint8_t)day,
+        .hour = (uint8_t)hour,
+        .minute = (uint8_t)minute,
+        .second = (uint8_t)second,
+        .day_of_week = 0,
+        .nanosecond = nanosecond,
+    };
+
+    return aws_date_time_to_epoch_ns(&date_time, epoch_ns);
+}
+
+int aws_date_time_parse_rfc3339(const char *date_str, size_t len, uint64_t *epoch_ns) {
+    struct date_parser parser = { date_str, date_str + len };
+    uint32_t year, month, day, hour, minute, second, nanosecond = 0;
+
+    /* "1994-11-06T08:49:37" */
+    if (!accept_number(&parser, 4, 4, &year) || !accept(&parser, '-') || !accept_number(&parser, 2, 2, &month) ||
+            !accept(&parser, '-') || !accept_number(&parser, 2, 2, &day) ||
+            !(accept(&parser, 'T') || accept(&parser, 't') || accept(&parser, ' ')) ||
+            !accept_number(&parser, 2, 2, &hour) || !accept(&parser, ':') ||
+            !accept_number(&parser, 2, 2, &minute) || !accept(&parser, ':') ||
+            !accept_number(&parser, 2, 2, &second)) {
+        return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+    }
+
+    /* ".123456789", keeping at most nanosecond precision. */
+    if (accept(&parser, '.')) {
+        const char *fraction = parser.cursor;
+        if (!accept_number(&parser, 1, 9, &nanosecond)) {
+            return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+        }
+        for (size_t digits = (size_t)(parser.cursor - fraction); digits < 9; ++digits) {
+            nanosecond *= 10;
+        }
+        while (parser.cursor < parser.end && is_digit(*parser.cursor)) {
+            parser.cursor++;
+        }
+    }
+
+    int ahead = 0;
+    uint32_t offset_hours = 0, offset_minutes = 0;
+    if (!accept(&parser, 'Z') && !accept(&parser, 'z')) {
+        ahead = peek(&parser, '+');
+        if (!(accept(&parser, '+') || accept(&parser, '-')) || !accept_number(&parser, 2, 2, &offset_hours) ||
+                !accept(&parser, ':') || !accept_number(&parser, 2, 2, &offset_minutes) || offset_hours > 23 ||
+                offset_minutes > 59) {
+            return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+        }
+    }
+
+    if (parser.cursor != parser.end) {
+        return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+    }
+
+    if (fields_to_epoch_ns(year, month, day, hour, minute, second, nanosecond, epoch_ns)) {
+        return AWS_OP_ERR;
+    }
+
+    return apply_offset(epoch_ns, ahead, offset_hours * 3600 + offset_minutes * 60);
+}
+
+int aws_date_time_parse_rfc1123(const char *date_str, size_t len, uint64_t *epoch_ns) {
+    struct date_parser parser = { date_str, date_str + len };
+    uint32_t year, month = 0, day, hour, minute, second = 0;
+
+    /* the day name is optional and redundant: like most HTTP parsers, don't check it against the date. */
+    if (parser.cursor < parser.end && !is_digit(*parser.cursor)) {
+        int found = 0;
+        for (size_t i = 0; i < 7 && !found; ++i) {
+            found = accept_word(&parser, day_names[i]);
+        }
+        if (!found || !accept(&parser, ',') || !accept(&parser, ' ')) {
+            return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+        }
+    }
+
+    /* "06 Nov 1994 08:49:37" */
+    if (!accept_number(&parser, 1, 2, &day) || !accept(&parser, ' ')) {
+        return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+    }
+    while (month < 12 && !accept_word(&parser, month_names[month])) {
+        month++;
+    }
+    if (month++ == 12 || !accept(&parser, ' ') || !accept_number(&parser, 4, 4, &year) || !accept(&parser, ' ') ||
+            !accept_number(&parser, 2, 2, &hour) || !accept(&parser, ':') ||
+            !accept_number(&parser, 2, 2, &minute)) {
+        return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+    }
+    if (accept(&parser, ':') && !accept_number(&parser, 2, 2, &second)) {
+        return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+    }
+
+    int ahead = 0;
+    uint32_t offset = 0;
+    if (!accept(&parser, ' ')) {
+        return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+    }
+    if (peek(&parser, '+') || peek(&parser, '-')) {
+        ahead = accept(&parser, '+');
+        if (!ahead) {
+            accept(&parser, '-');
+        }
+        if (!accept_number(&parser, 4, 4, &offset) || offset / 100 > 23 || offset % 100 > 59) {
+            return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+        }
+    }
+    else if (!accept_word(&parser, "GMT") && !accept_word(&parser, "UTC") && !accept_word(&parser, "UT") &&
+            !accept_word(&parser, "Z")) {
+        return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+    }
+
+    if (parser.cursor != parser.end) {
+        return aws_raise_error(AWS_ERROR_INVALID_DATE_STR);
+    }
+
+    if (fields_to_epoch_ns(year, month, day, hour, minute, second, 0, epoch_ns)) {
+        return AWS_OP_ERR;
+    }
+
+    return apply_offset(epoch_ns, ahead, offset / 100 * 3600 + offset % 100 * 60);
+}
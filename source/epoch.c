@@ -0,0 +1,259 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/epoch.h>
+#include <aws/common/thread.h>
+#include <assert.h>
+
+struct retired_node {
+    void *ptr;
+    struct aws_allocator *allocator;
+};
+
+struct orphaned_node {
+    struct retired_node node;
+    size_t epoch;
+};
+
+/* a node retired in epoch e may still be referenced by threads in e - 1 and e, both of which are gone once the
+ * global epoch reaches e + 2. */
+static int is_safe_to_release(size_t retired_epoch, size_t global_epoch) {
+    return global_epoch - retired_epoch >= 2;
+}
+
+static size_t release_list(struct aws_array_list *list) {
+    size_t count = aws_array_list_length(list);
+
+    for (size_t i = 0; i < count; ++i) {
+        struct retired_node *node = NULL;
+        aws_array_list_get_at_ptr(list, (void **)&node, i);
+        aws_mem_release(node->allocator, node->ptr);
+    }
+
+    aws_array_list_clear(list);
+    return count;
+}
+
+int aws_epoch_domain_init(struct aws_epoch_domain *domain, struct aws_allocator *allocator) {
+    domain->allocator = allocator;
+    aws_atomic_init_int(&domain->global_epoch, 0);
+    aws_linked_list_init(&domain->threads);
+
+    if (aws_mutex_init(&domain->lock, allocator)) {
+        return AWS_OP_ERR;
+    }
+
+    if (aws_array_list_init_dynamic(&domain->orphans, allocator, 16, sizeof(struct orphaned_node))) {
+        aws_mutex_clean_up(&domain->lock);
+        return AWS_OP_ERR;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_epoch_domain_clean_up(struct aws_epoch_domain *domain) {
+    assert(aws_linked_list_empty(&domain->threads));
+
+    size_t count = aws_array_list_length(&domain->orphans);
+    for (size_t i = 0; i < count; ++i) {
+        struct orphaned_node *orphan = NULL;
+        aws_array_list_get_at_ptr(&domain->orphans, (void **)&orphan, i);
+        aws_mem_release(orphan->node.allocator, orphan->node.ptr);
+    }
+
+    aws_array_list_clean_up(&domain->orphans);
+    aws_mutex_clean_up(&domain->lock);
+}
+
+/* must be called with the domain lock held. */
+static void release_orphans(struct aws_epoch_domain *domain, size_t global_epoch) {
+    size_t count = aws_array_list_length(&domain->orphans);
+    size_t kept = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        struct orphaned_node *orphan = NULL;
+        aws_array_list_get_at_ptr(&domain->orphans, (void **)&orphan, i);
+
+        if (is_safe_to_release(orphan->epoch, global_epoch)) {
+            aws_mem_release(orphan->node.allocator, orphan->node.ptr);
+        }
+        else {
+            if (i != kept) {
+                aws_array_list_set_at(&domain->orphans, orphan, kept);
+            }
+            kept++;
+        }
+    }
+
+    while (aws_array_list_length(&domain->orphans) > kept) {
+        aws_array_list_pop_back(&domain->orphans);
+    }
+}
+
+/* advances the global epoch if every thread inside a critical section has already observed it. */
+static void try_advance(struct aws_epoch_domain *domain) {
+    aws_mutex_lock(&domain->lock);
+
+    size_t epoch = aws_atomic_load_int_explicit(&domain->global_epoch, aws_memory_order_relaxed);
+    /* pairs with the fence in aws_epoch_enter(): either we see the thread's announcement, or it sees our epoch. */
+    aws_atomic_thread_fence(aws_memory_order_seq_cst);
+
+    int can_advance = 1;
+    struct aws_linked_list_node *iter = domain->threads.next;
+    while (iter != &domain->threads) {
+        struct aws_epoch_thread *thread = aws_container_of(iter, struct aws_epoch_thread, node);
+        size_t state = aws_atomic_load_int_explicit(&thread->state, aws_memory_order_acquire);
+
+        if ((state & 1) && (state >> 1) != epoch) {
+            can_advance = 0;
+            break;
+        }
+        iter = iter->next;
+    }
+
+    if (can_advance) {
+        /* only ever advanced under the lock, so a plain store is enough. */
+        aws_atomic_store_int_explicit(&domain->global_epoch, epoch + 1, aws_memory_order_release);
+        release_orphans(domain, epoch + 1);
+    }
+
+    aws_mutex_unlock(&domain->lock);
+}
+
+int aws_epoch_thread_register(struct aws_epoch_domain *domain, struct aws_epoch_thread *thread) {
+    thread->domain = domain;
+    thread->owner_thread_id = aws_thread_current_thread_id();
+    thread->nesting = 0;
+    thread->retired_since_advance = 0;
+    aws_atomic_init_int(&thread->state, 0);
+
+    for (size_t i = 0; i < AWS_EPOCH_LIMBO_LISTS; ++i) {
+        thread->limbo_epoch[i] = 0;
+        if (aws_array_list_init_dynamic(&thread->limbo[i], domain->allocator, AWS_EPOCH_RETIRE_BATCH,
+                sizeof(struct retired_node))) {
+            while (i-- > 0) {
+                aws_array_list_clean_up(&thread->limbo[i]);
+            }
+            return AWS_OP_ERR;
+        }
+    }
+
+    aws_mutex_lock(&domain->lock);
+    struct aws_linked_list_node *head = &domain->threads;
+    aws_linked_list_push_back(head, &thread->node);
+    aws_mutex_unlock(&domain->lock);
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_epoch_thread_unregister(struct aws_epoch_thread *thread) {
+    assert(thread->nesting == 0);
+    struct aws_epoch_domain *domain = thread->domain;
+
+    aws_epoch_thread_reclaim(thread);
+
+    aws_mutex_lock(&domain->lock);
+    aws_linked_list_remove(&thread->node);
+
+    for (size_t i = 0; i < AWS_EPOCH_LIMBO_LISTS; ++i) {
+        size_t count = aws_array_list_length(&thread->limbo[i]);
+
+        for (size_t j = 0; j < count; ++j) {
+            struct orphaned_node orphan;
+            aws_array_list_get_at(&thread->limbo[i], &orphan.node, j);
+            orphan.epoch = thread->limbo_epoch[i];
+
+            if (aws_array_list_push_back(&domain->orphans, &orphan)) {
+                /* out of memory with nowhere to park the node: wait it out rather than leak or free early. */
+                aws_mutex_unlock(&domain->lock);
+                while (!is_safe_to_release(orphan.epoch,
+                        aws_atomic_load_int_explicit(&domain->global_epoch, aws_memory_order_acquire))) {
+                    try_advance(domain);
+                    aws_thread_current_sleep(1000);
+                }
+                aws_mem_release(orphan.node.allocator, orphan.node.ptr);
+                aws_mutex_lock(&domain->lock);
+            }
+        }
+
+        aws_array_list_clean_up(&thread->limbo[i]);
+    }
+
+    aws_mutex_unlock(&domain->lock);
+}
+
+size_t aws_epoch_thread_reclaim(struct aws_epoch_thread *thread) {
+    try_advance(thread->domain);
+    thread->retired_since_advance = 0;
+
+    size_t epoch = aws_atomic_load_int_explicit(&thread->domain->global_epoch, aws_memory_order_acquire);
+    size_t released = 0;
+
+    for (size_t i = 0; i < AWS_EPOCH_LIMBO_LISTS; ++i) {
+        if (is_safe_to_release(thread->limbo_epoch[i], epoch)) {
+            released += release_list(&thread->limbo[i]);
+        }
+    }
+
+    return released;
+}
+
+int aws_epoch_retire(struct aws_epoch_thread *thread, void *ptr, struct aws_allocator *allocator) {
+    assert(thread->owner_thread_id == aws_thread_current_thread_id());
+
+    size_t epoch = aws_atomic_load_int_explicit(&thread->domain->global_epoch, aws_memory_order_acquire);
+    size_t index = epoch % AWS_EPOCH_LIMBO_LISTS;
+
+    /* the list for this slot was last used at least three epochs ago, so everything in it is safe to release. */
+    if (thread->limbo_epoch[index] != epoch) {
+        release_list(&thread->limbo[index]);
+        thread->limbo_epoch[index] = epoch;
+    }
+
+    struct retired_node node = {
+        .ptr = ptr,
+        .allocator = allocator,
+    };
+
+    if (aws_array_list_push_back(&thread->limbo[index], &node)) {
+        return AWS_OP_ERR;
+    }
+
+    if (++thread->retired_since_advance >= AWS_EPOCH_RETIRE_BATCH) {
+        aws_epoch_thread_reclaim(thread);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_epoch_thread_flush(struct aws_epoch_thread *thread) {
+    assert(thread->nesting == 0);
+
+    aws_epoch_thread_reclaim(thread);
+    while (aws_epoch_thread_pending(thread)) {
+        aws_thread_current_sleep(1000);
+        aws_epoch_thread_reclaim(thread);
+    }
+}
+
+size_t aws_epoch_thread_pending(const struct aws_epoch_thread *thread) {
+    size_t pending = 0;
+
+    for (size_t i = 0; i < AWS_EPOCH_LIMBO_LISTS; ++i) {
+        pending += aws_array_list_length(&thread->limbo[i]);
+    }
+
+    return pending;
+}
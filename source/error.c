@@ -15,6 +15,9 @@
 
 #include <aws/common/error.h>
 #include <aws/common/common.h>
+#include <aws/common/atomics.h>
+#include <aws/common/private/library_metrics.h>
+#include <aws/common/private/probes.h>
 #include <assert.h>
 
 static AWS_THREAD_LOCAL int last_error = 0;
@@ -38,7 +41,9 @@ AWS_THREAD_LOCAL void *thread_handler_context = NULL;
 
 static const int max_error_code = AWS_ERROR_SLOT_SIZE * AWS_MAX_ERROR_SLOTS;
 
-static const struct aws_error_info_list *volatile error_slots[AWS_MAX_ERROR_SLOTS] = { 0 };
+/* Slots are published with release semantics by aws_register_error_info() and read with acquire semantics, so a reader
+ * that observes a slot also observes the fully initialized list behind it. */
+static struct aws_atomic_var error_slots[AWS_MAX_ERROR_SLOTS] = { AWS_ATOMIC_INIT_PTR(NULL) };
 
 int aws_last_error(void) {
     return last_error;
@@ -52,7 +57,8 @@ static const struct aws_error_info *get_error_by_code(int err) {
     int slot_index = err >> SLOT_DIV_SHIFT;
     int error_index = err & SLOT_MASK;
 
-    const struct aws_error_info_list *error_slot = error_slots[slot_index];
+    const struct aws_error_info_list *error_slot =
+            (const struct aws_error_info_list *)aws_atomic_load_ptr_explicit(&error_slots[slot_index], aws_memory_order_acquire);
 
     if(!error_slot || error_index >= error_slot->count) {
         return NULL;
@@ -99,6 +105,11 @@ const char *aws_error_debug_str(int err) {
 
 int aws_raise_error(int err) {
     last_error = err;
+    AWS_PROBE1(raise_error, err);
+
+    if (AWS_UNLIKELY(aws_library_metrics_active())) {
+        aws_library_metrics_increment(AWS_LIBRARY_METRIC_ERRORS_RAISED);
+    }
 
     if(thread_handler) {
         thread_handler(last_error, thread_handler_context);
@@ -144,6 +155,5 @@ void aws_register_error_info(const struct aws_error_info_list *error_info) {
     int slot_index = min_range >> SLOT_DIV_SHIFT;
     assert(slot_index < AWS_MAX_ERROR_SLOTS);
 
-
-    error_slots[slot_index] = error_info;
+    aws_atomic_store_ptr_explicit(&error_slots[slot_index], (void *)error_info, aws_memory_order_release);
 }
@@ -0,0 +1,62 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/event.h>
+#include <aws/common/private/futex.h>
+
+void aws_event_init(struct aws_event *event) {
+    aws_atomic_init_int(&event->state, AWS_EVENT_UNSET);
+}
+
+void aws_event_set(struct aws_event *event) {
+    size_t previous = aws_atomic_exchange_int_explicit(&event->state, AWS_EVENT_SET, aws_memory_order_acq_rel);
+
+    if (previous == AWS_EVENT_WAITERS) {
+        aws_futex_wake(&event->state, SIZE_MAX);
+    }
+}
+
+void aws_event_reset(struct aws_event *event) {
+    size_t expected = AWS_EVENT_SET;
+    aws_atomic_compare_exchange_int_explicit(&event->state, &expected, AWS_EVENT_UNSET, aws_memory_order_relaxed,
+            aws_memory_order_relaxed);
+}
+
+static int wait_until(struct aws_event *event, uint64_t deadline) {
+    for (;;) {
+        size_t state = aws_futex_spin(&event->state, AWS_EVENT_UNSET);
+        if (state == AWS_EVENT_SET) {
+            return AWS_OP_SUCCESS;
+        }
+
+        /* tell aws_event_set() someone needs waking up; if it got there first, the exchange fails and we loop. */
+        if (state == AWS_EVENT_UNSET && !aws_atomic_compare_exchange_int_explicit(&event->state, &state,
+                AWS_EVENT_WAITERS, aws_memory_order_relaxed, aws_memory_order_relaxed)) {
+            continue;
+        }
+
+        if (aws_futex_wait(&event->state, AWS_EVENT_WAITERS, deadline)) {
+            return AWS_OP_ERR;
+        }
+    }
+}
+
+int aws_event_wait(struct aws_event *event) {
+    return wait_until(event, AWS_FUTEX_WAIT_FOREVER);
+}
+
+int aws_event_wait_timeout(struct aws_event *event, uint64_t timeout_ns) {
+    return wait_until(event, aws_futex_deadline(timeout_ns));
+}
@@ -0,0 +1,212 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/hazard_ptr.h>
+#include <aws/common/thread.h>
+#include <assert.h>
+#include <stdlib.h>
+
+struct retired_node {
+    void *ptr;
+    struct aws_allocator *allocator;
+};
+
+static int compare_ptrs(const void *a, const void *b) {
+    uintptr_t left = (uintptr_t)*(void *const *)a;
+    uintptr_t right = (uintptr_t)*(void *const *)b;
+    return (left > right) - (left < right);
+}
+
+int aws_hazard_domain_init(struct aws_hazard_domain *domain, struct aws_allocator *allocator) {
+    domain->allocator = allocator;
+    aws_linked_list_init(&domain->threads);
+    aws_atomic_init_int(&domain->thread_count, 0);
+
+    if (aws_mutex_init(&domain->lock, allocator)) {
+        return AWS_OP_ERR;
+    }
+
+    if (aws_array_list_init_dynamic(&domain->orphans, allocator, 16, sizeof(struct retired_node))) {
+        aws_mutex_clean_up(&domain->lock);
+        return AWS_OP_ERR;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_hazard_domain_clean_up(struct aws_hazard_domain *domain) {
+    assert(aws_linked_list_empty(&domain->threads));
+
+    size_t count = aws_array_list_length(&domain->orphans);
+    for (size_t i = 0; i < count; ++i) {
+        struct retired_node *node = NULL;
+        aws_array_list_get_at_ptr(&domain->orphans, (void **)&node, i);
+        aws_mem_release(node->allocator, node->ptr);
+    }
+
+    aws_array_list_clean_up(&domain->orphans);
+    aws_mutex_clean_up(&domain->lock);
+}
+
+int aws_hazard_thread_register(struct aws_hazard_domain *domain, struct aws_hazard_thread *thread) {
+    thread->domain = domain;
+    thread->owner_thread_id = aws_thread_current_thread_id();
+
+    for (size_t i = 0; i < AWS_HAZARD_PTR_SLOTS; ++i) {
+        aws_atomic_init_ptr(&thread->slots[i], NULL);
+    }
+
+    if (aws_array_list_init_dynamic(&thread->retired, domain->allocator, AWS_HAZARD_PTR_SCAN_THRESHOLD,
+            sizeof(struct retired_node))) {
+        return AWS_OP_ERR;
+    }
+
+    if (aws_array_list_init_dynamic(&thread->hazards, domain->allocator, AWS_HAZARD_PTR_SLOTS * 4, sizeof(void *))) {
+        aws_array_list_clean_up(&thread->retired);
+        return AWS_OP_ERR;
+    }
+
+    aws_mutex_lock(&domain->lock);
+    struct aws_linked_list_node *head = &domain->threads;
+    aws_linked_list_push_back(head, &thread->node);
+    aws_atomic_fetch_add_explicit(&domain->thread_count, 1, aws_memory_order_relaxed);
+    aws_mutex_unlock(&domain->lock);
+
+    return AWS_OP_SUCCESS;
+}
+
+/* releases every node in list that is not in the sorted hazards snapshot, and compacts the list. */
+static size_t release_unprotected(struct aws_array_list *list, const struct aws_array_list *hazards) {
+    size_t count = aws_array_list_length(list);
+    size_t hazard_count = aws_array_list_length(hazards);
+    size_t kept = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        struct retired_node *node = NULL;
+        aws_array_list_get_at_ptr(list, (void **)&node, i);
+
+        if (hazard_count && bsearch(&node->ptr, hazards->data, hazard_count, sizeof(void *), compare_ptrs)) {
+            if (i != kept) {
+                aws_array_list_set_at(list, node, kept);
+            }
+            kept++;
+        }
+        else {
+            aws_mem_release(node->allocator, node->ptr);
+        }
+    }
+
+    while (aws_array_list_length(list) > kept) {
+        aws_array_list_pop_back(list);
+    }
+
+    return count - kept;
+}
+
+/* must be called with the domain lock held. */
+static int snapshot_hazards(struct aws_hazard_thread *thread) {
+    struct aws_hazard_domain *domain = thread->domain;
+    aws_array_list_clear(&thread->hazards);
+
+    /* pairs with the fence in aws_hazard_protect(): either we see the slot, or the protector sees the node unlinked. */
+    aws_atomic_thread_fence(aws_memory_order_seq_cst);
+
+    struct aws_linked_list_node *iter = domain->threads.next;
+    while (iter != &domain->threads) {
+        struct aws_hazard_thread *other = aws_container_of(iter, struct aws_hazard_thread, node);
+
+        for (size_t i = 0; i < AWS_HAZARD_PTR_SLOTS; ++i) {
+            void *hazard = aws_atomic_load_ptr_explicit(&other->slots[i], aws_memory_order_acquire);
+            if (hazard && aws_array_list_push_back(&thread->hazards, &hazard)) {
+                return AWS_OP_ERR;
+            }
+        }
+        iter = iter->next;
+    }
+
+    qsort(thread->hazards.data, aws_array_list_length(&thread->hazards), sizeof(void *), compare_ptrs);
+    return AWS_OP_SUCCESS;
+}
+
+size_t aws_hazard_scan(struct aws_hazard_thread *thread) {
+    struct aws_hazard_domain *domain = thread->domain;
+    size_t released = 0;
+
+    aws_mutex_lock(&domain->lock);
+    /* without a complete snapshot nothing can be proven safe; try again on the next scan. */
+    if (!snapshot_hazards(thread)) {
+        released += release_unprotected(&thread->retired, &thread->hazards);
+        released += release_unprotected(&domain->orphans, &thread->hazards);
+    }
+    aws_mutex_unlock(&domain->lock);
+
+    return released;
+}
+
+int aws_hazard_retire(struct aws_hazard_thread *thread, void *ptr, struct aws_allocator *allocator) {
+    assert(thread->owner_thread_id == aws_thread_current_thread_id());
+
+    struct retired_node node = {
+        .ptr = ptr,
+        .allocator = allocator,
+    };
+
+    if (aws_array_list_push_back(&thread->retired, &node)) {
+        return AWS_OP_ERR;
+    }
+
+    size_t threshold = 2 * AWS_HAZARD_PTR_SLOTS *
+        aws_atomic_load_int_explicit(&thread->domain->thread_count, aws_memory_order_relaxed);
+    if (threshold < AWS_HAZARD_PTR_SCAN_THRESHOLD) {
+        threshold = AWS_HAZARD_PTR_SCAN_THRESHOLD;
+    }
+
+    if (aws_array_list_length(&thread->retired) >= threshold) {
+        aws_hazard_scan(thread);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_hazard_thread_unregister(struct aws_hazard_thread *thread) {
+    struct aws_hazard_domain *domain = thread->domain;
+
+    for (size_t i = 0; i < AWS_HAZARD_PTR_SLOTS; ++i) {
+        aws_hazard_clear(thread, i);
+    }
+
+    aws_hazard_scan(thread);
+
+    aws_mutex_lock(&domain->lock);
+    aws_linked_list_remove(&thread->node);
+    aws_atomic_fetch_sub_explicit(&domain->thread_count, 1, aws_memory_order_relaxed);
+
+    size_t count = aws_array_list_length(&thread->retired);
+    for (size_t i = 0; i < count; ++i) {
+        struct retired_node *node = NULL;
+        aws_array_list_get_at_ptr(&thread->retired, (void **)&node, i);
+
+        /* out of memory with nowhere to park the node: leaking it is the only safe option left. */
+        aws_array_list_push_back(&domain->orphans, node);
+    }
+    aws_mutex_unlock(&domain->lock);
+
+    aws_array_list_clean_up(&thread->retired);
+    aws_array_list_clean_up(&thread->hazards);
+}
+
+size_t aws_hazard_thread_pending(const struct aws_hazard_thread *thread) {
+    return aws_array_list_length(&thread->retired);
+}
@@ -0,0 +1,326 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/histogram.h>
+#include <aws/common/private/varint.h>
+#include <string.h>
+
+#define ENCODING_VERSION 1
+/* 5 significant figures. */
+#define MAX_SUB_BUCKET_BITS 18
+
+static int init_with_bits(struct aws_histogram *histogram, struct aws_allocator *allocator,
+        uint64_t highest_trackable_value, uint32_t sub_bucket_bits) {
+    if (highest_trackable_value < 2 || sub_bucket_bits < 2 || sub_bucket_bits > MAX_SUB_BUCKET_BITS) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    histogram->allocator = allocator;
+    histogram->highest_trackable_value = highest_trackable_value;
+    histogram->sub_bucket_bits = sub_bucket_bits;
+    histogram->counts_len = aws_histogram_bucket_index(histogram, highest_trackable_value) + 1;
+
+    histogram->counts = (uint64_t *)aws_mem_acquire(allocator, histogram->counts_len * sizeof(uint64_t));
+    if (!histogram->counts) {
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
+
+    aws_histogram_reset(histogram);
+    return AWS_OP_SUCCESS;
+}
+
+int aws_histogram_init(struct aws_histogram *histogram, struct aws_allocator *allocator,
+        uint64_t highest_trackable_value, int significant_figures) {
+    if (significant_figures < 1 || significant_figures > 5) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    uint64_t resolution = 1;
+    for (int i = 0; i < significant_figures; ++i) {
+        resolution *= 10;
+    }
+
+    /* the narrowest buckets above 2^b are 1/2^(b - 1) of their value wide, so that has to be at most 1/resolution. */
+    uint32_t sub_bucket_bits = 1;
+    while (((uint64_t)1 << (sub_bucket_bits - 1)) < resolution) {
+        sub_bucket_bits++;
+    }
+
+    return init_with_bits(histogram, allocator, highest_trackable_value, sub_bucket_bits);
+}
+
+void aws_histogram_clean_up(struct aws_histogram *histogram) {
+    aws_mem_release(histogram->allocator, histogram->counts);
+    histogram->counts = NULL;
+}
+
+void aws_histogram_reset(struct aws_histogram *histogram) {
+    memset(histogram->counts, 0, histogram->counts_len * sizeof(uint64_t));
+    histogram->total_count = 0;
+    histogram->min = UINT64_MAX;
+    histogram->max = 0;
+}
+
+/* the log2 of the width of bucket index. */
+static uint32_t bucket_shift(const struct aws_histogram *histogram, size_t index) {
+    size_t shift = index >> (histogram->sub_bucket_bits - 1);
+    return shift ? (uint32_t)shift - 1 : 0;
+}
+
+static uint64_t lowest_value_at(const struct aws_histogram *histogram, size_t index) {
+    uint32_t shift = bucket_shift(histogram, index);
+    return (uint64_t)(index - ((size_t)shift << (histogram->sub_bucket_bits - 1))) << shift;
+}
+
+static uint64_t highest_value_at(const struct aws_histogram *histogram, size_t index) {
+    return lowest_value_at(histogram, index) + (((uint64_t)1 << bucket_shift(histogram, index)) - 1);
+}
+
+static void add_to_bucket(struct aws_histogram *histogram, uint64_t value, uint64_t count) {
+    if (value > histogram->highest_trackable_value) {
+        value = histogram->highest_trackable_value;
+    }
+
+    histogram->counts[aws_histogram_bucket_index(histogram, value)] += count;
+    histogram->total_count += count;
+}
+
+void aws_histogram_record_n(struct aws_histogram *histogram, uint64_t value, uint64_t count) {
+    if (!count) {
+        return;
+    }
+
+    add_to_bucket(histogram, value, count);
+    histogram->min = value < histogram->min ? value : histogram->min;
+    histogram->max = value > histogram->max ? value : histogram->max;
+}
+
+void aws_histogram_merge(struct aws_histogram *to, const struct aws_histogram *from) {
+    if (to->sub_bucket_bits == from->sub_bucket_bits && from->counts_len <= to->counts_len) {
+        /* same bucket boundaries, so this is just adding the counts up. */
+        for (size_t i = 0; i < from->counts_len; ++i) {
+            to->counts[i] += from->counts[i];
+        }
+        to->total_count += from->total_count;
+    }
+    else {
+        for (size_t i = 0; i < from->counts_len; ++i) {
+            if (from->counts[i]) {
+                uint64_t lowest = lowest_value_at(from, i);
+                add_to_bucket(to, lowest + (highest_value_at(from, i) - lowest) / 2, from->counts[i]);
+            }
+        }
+    }
+
+    to->min = from->min < to->min ? from->min : to->min;
+    to->max = from->max > to->max ? from->max : to->max;
+}
+
+uint64_t aws_histogram_value_at_percentile(const struct aws_histogram *histogram, double percentile) {
+    if (!histogram->total_count) {
+        return 0;
+    }
+
+    if (percentile <= 0.0) {
+        return histogram->min;
+    }
+
+    if (percentile >= 100.0) {
+        return histogram->max;
+    }
+
+    /* the rank of the value we want, rounded up, so that e.g. the p50 of 1 and 2 is 1. */
+    double rank = percentile / 100.0 * (double)histogram->total_count;
+    uint64_t target = (uint64_t)rank;
+    if ((double)target < rank || !target) {
+        target++;
+    }
+
+    uint64_t seen = 0;
+    size_t index = 0;
+    for (; index < histogram->counts_len - 1; ++index) {
+        seen += histogram->counts[index];
+        if (seen >= target) {
+            break;
+        }
+    }
+
+    /* every value in the bucket is equivalent at our precision: report the largest, bounded by what we saw. */
+    uint64_t value = highest_value_at(histogram, index);
+    if (value > histogram->max) {
+        value = histogram->max;
+    }
+    if (value < histogram->min) {
+        value = histogram->min;
+    }
+
+    return value;
+}
+
+double aws_histogram_mean(const struct aws_histogram *histogram) {
+    if (!histogram->total_count) {
+        return 0.0;
+    }
+
+    double sum = 0.0;
+    for (size_t i = 0; i < histogram->counts_len; ++i) {
+        if (histogram->counts[i]) {
+            uint64_t lowest = lowest_value_at(histogram, i);
+            double middle = (double)lowest + (double)(highest_value_at(histogram, i) - lowest) / 2.0;
+            sum += middle * (double)histogram->counts[i];
+        }
+    }
+
+    return sum / (double)histogram->total_count;
+}
+
+/*
+ * The encoding is a version byte and the sub bucket bits, followed by varints (see private/varint.h) for the highest
+ * trackable value, the total count, the min and the max, and then one varint per run of buckets from the first: a
+ * count c of a non empty bucket is c << 1, and n consecutive empty buckets are (n << 1) | 1. Trailing empty buckets are
+ * left out. The total count lets a truncated encoding be told apart from a histogram with fewer values.
+ */
+
+/* calls fn for each varint describing histogram's buckets, and returns the sum of what fn returned. */
+static size_t for_each_run(const struct aws_histogram *histogram, size_t (*fn)(uint64_t token, void *ctx),
+        void *ctx) {
+    size_t total = 0;
+    uint64_t empty_run = 0;
+
+    for (size_t i = 0; i < histogram->counts_len; ++i) {
+        uint64_t count = histogram->counts[i];
+        if (!count) {
+            empty_run++;
+            continue;
+        }
+
+        if (empty_run) {
+            total += fn((empty_run << 1) | 1, ctx);
+            empty_run = 0;
+        }
+        total += fn(count << 1, ctx);
+    }
+
+    return total;
+}
+
+static size_t measure_token(uint64_t token, void *ctx) {
+    (void)ctx;
+    return aws_varint_len(token);
+}
+
+static size_t write_token(uint64_t token, void *ctx) {
+    uint8_t **output = (uint8_t **)ctx;
+    uint8_t *start = *output;
+    *output = aws_varint_write(start, token);
+    return (size_t)(*output - start);
+}
+
+int aws_histogram_compute_encoded_len(const struct aws_histogram *histogram, size_t *encoded_len) {
+    *encoded_len = 2 + aws_varint_len(histogram->highest_trackable_value) + aws_varint_len(histogram->total_count) +
+        aws_varint_len(histogram->min) + aws_varint_len(histogram->max) + for_each_run(histogram, measure_token, NULL);
+    return AWS_OP_SUCCESS;
+}
+
+int aws_histogram_encode(const struct aws_histogram *histogram, uint8_t *output, size_t output_size,
+        size_t *encoded_len) {
+    size_t len = 0;
+    aws_histogram_compute_encoded_len(histogram, &len);
+
+    if (output_size < len) {
+        return aws_raise_error(AWS_ERROR_INVALID_BUFFER_SIZE);
+    }
+
+    uint8_t *cursor = output;
+    *cursor++ = ENCODING_VERSION;
+    *cursor++ = (uint8_t)histogram->sub_bucket_bits;
+    cursor = aws_varint_write(cursor, histogram->highest_trackable_value);
+    cursor = aws_varint_write(cursor, histogram->total_count);
+    cursor = aws_varint_write(cursor, histogram->min);
+    cursor = aws_varint_write(cursor, histogram->max);
+    for_each_run(histogram, write_token, &cursor);
+
+    *encoded_len = len;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_histogram_decode(struct aws_histogram *histogram, struct aws_allocator *allocator, const uint8_t *input,
+        size_t input_len) {
+    const uint8_t *end = input + input_len;
+    uint64_t highest_trackable_value = 0;
+    uint64_t total_count = 0;
+    uint64_t min = 0;
+    uint64_t max = 0;
+
+    if (input_len < 2 || input[0] != ENCODING_VERSION) {
+        return aws_raise_error(AWS_ERROR_INVALID_HISTOGRAM_ENCODING);
+    }
+
+    uint32_t sub_bucket_bits = input[1];
+    input += 2;
+    if (aws_varint_read(&input, end, &highest_trackable_value) || aws_varint_read(&input, end, &total_count) ||
+            aws_varint_read(&input, end, &min) || aws_varint_read(&input, end, &max)) {
+        return aws_raise_error(AWS_ERROR_INVALID_HISTOGRAM_ENCODING);
+    }
+
+    if (highest_trackable_value < 2 || sub_bucket_bits < 2 || sub_bucket_bits > MAX_SUB_BUCKET_BITS) {
+        return aws_raise_error(AWS_ERROR_INVALID_HISTOGRAM_ENCODING);
+    }
+
+    if (init_with_bits(histogram, allocator, highest_trackable_value, sub_bucket_bits)) {
+        return AWS_OP_ERR;
+    }
+
+    size_t index = 0;
+    while (input < end) {
+        uint64_t token = 0;
+        if (aws_varint_read(&input, end, &token)) {
+            aws_raise_error(AWS_ERROR_INVALID_HISTOGRAM_ENCODING);
+            goto error;
+        }
+
+        uint64_t run = token & 1 ? token >> 1 : 1;
+        if (!(token >> 1) || run > histogram->counts_len - index) {
+            aws_raise_error(AWS_ERROR_INVALID_HISTOGRAM_ENCODING);
+            goto error;
+        }
+
+        if (!(token & 1)) {
+            histogram->counts[index] = token >> 1;
+            histogram->total_count += token >> 1;
+        }
+        index += (size_t)run;
+    }
+
+    if (histogram->total_count != total_count) {
+        aws_raise_error(AWS_ERROR_INVALID_HISTOGRAM_ENCODING);
+        goto error;
+    }
+
+    if (total_count) {
+        if (min > max) {
+            aws_raise_error(AWS_ERROR_INVALID_HISTOGRAM_ENCODING);
+            goto error;
+        }
+        histogram->min = min;
+        histogram->max = max;
+    }
+
+    return AWS_OP_SUCCESS;
+
+error:
+    aws_histogram_clean_up(histogram);
+    return AWS_OP_ERR;
+}
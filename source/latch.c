@@ -0,0 +1,64 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/latch.h>
+#include <aws/common/private/futex.h>
+#include <assert.h>
+
+void aws_latch_init(struct aws_latch *latch, size_t count) {
+    aws_atomic_init_int(&latch->count, count);
+}
+
+void aws_latch_count_down(struct aws_latch *latch, size_t n) {
+    size_t previous = aws_atomic_fetch_sub_explicit(&latch->count, n, aws_memory_order_acq_rel);
+    assert(previous >= n);
+
+    if (previous == n) {
+        aws_futex_wake(&latch->count, SIZE_MAX);
+    }
+}
+
+int aws_latch_try_wait(const struct aws_latch *latch) {
+    if (!aws_atomic_load_int_explicit(&latch->count, aws_memory_order_acquire)) {
+        return AWS_OP_SUCCESS;
+    }
+
+    return aws_raise_error(AWS_ERROR_WAIT_TIMEOUT);
+}
+
+static int wait_until(struct aws_latch *latch, uint64_t deadline) {
+    for (;;) {
+        size_t count = aws_atomic_load_int_explicit(&latch->count, aws_memory_order_acquire);
+        if (!count) {
+            return AWS_OP_SUCCESS;
+        }
+
+        if (aws_futex_spin(&latch->count, count) != count) {
+            continue;
+        }
+
+        if (aws_futex_wait(&latch->count, count, deadline)) {
+            return AWS_OP_ERR;
+        }
+    }
+}
+
+int aws_latch_wait(struct aws_latch *latch) {
+    return wait_until(latch, AWS_FUTEX_WAIT_FOREVER);
+}
+
+int aws_latch_wait_timeout(struct aws_latch *latch, uint64_t timeout_ns) {
+    return wait_until(latch, aws_futex_deadline(timeout_ns));
+}
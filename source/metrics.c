@@ -0,0 +1,695 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/metrics.h>
+#include <aws/common/once.h>
+#include <aws/common/private/library_metrics.h>
+#include <aws/common/private/varint.h>
+#include <inttypes.h>
+#include <string.h>
+
+#define ENCODING_VERSION 1
+
+/*
+ * A histogram shard is updated with atomic adds rather than under a lock: two threads only share a slot when one of
+ * them was preempted on its processor, or permanently where slots are picked by hashing the thread, and a spinning
+ * recorder would burn its timeslice waiting on a holder that can't run. On 32 bit targets the counts and bounds are
+ * word sized, so a shard's buckets wrap after 2^32 records and values above SIZE_MAX are kept as SIZE_MAX in min and
+ * max.
+ */
+struct histogram_shard {
+    /* the bucket layout only: counts is NULL, the buckets are below. */
+    struct aws_histogram layout;
+    struct aws_atomic_var *counts;
+    struct aws_atomic_var min;
+    struct aws_atomic_var max;
+};
+
+static int is_valid_name(const char *name, size_t len) {
+    if (!len) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < len; ++i) {
+        char c = name[i];
+        int valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':' ||
+            (i && c >= '0' && c <= '9');
+        if (!valid) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static char *copy_string(struct aws_allocator *allocator, const char *str, size_t len) {
+    char *copy = (char *)aws_mem_acquire(allocator, len + 1);
+    if (copy) {
+        memcpy(copy, str, len);
+        copy[len] = 0;
+    }
+    return copy;
+}
+
+int aws_metrics_registry_init(struct aws_metrics_registry *registry, struct aws_allocator *allocator) {
+    registry->allocator = allocator;
+
+    if (aws_array_list_init_dynamic(&registry->metrics, allocator, 16, sizeof(struct aws_metric *))) {
+        return AWS_OP_ERR;
+    }
+
+    if (aws_mutex_init(&registry->lock, allocator)) {
+        aws_array_list_clean_up(&registry->metrics);
+        return AWS_OP_ERR;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static void clean_up_histogram_shards(struct aws_allocator *allocator, struct aws_percpu *shards, size_t initialized) {
+    for (size_t i = 0; i < initialized; ++i) {
+        struct histogram_shard *shard = (struct histogram_shard *)aws_percpu_get(shards, i);
+        aws_mem_release(allocator, shard->counts);
+    }
+    aws_percpu_clean_up(shards);
+}
+
+static void destroy_metric(struct aws_allocator *allocator, struct aws_metric *metric) {
+    switch (metric->type) {
+        case AWS_METRIC_COUNTER:
+            aws_sharded_counter_clean_up(&metric->value.counter);
+            break;
+        case AWS_METRIC_HISTOGRAM:
+            clean_up_histogram_shards(allocator, &metric->value.histogram,
+                    aws_percpu_slot_count(&metric->value.histogram));
+            break;
+        default:
+            break;
+    }
+
+    aws_mem_release(allocator, metric->name);
+    aws_mem_release(allocator, metric->help);
+    aws_mem_release(allocator, metric);
+}
+
+void aws_metrics_registry_clean_up(struct aws_metrics_registry *registry) {
+    for (size_t i = 0; i < aws_array_list_length(&registry->metrics); ++i) {
+        struct aws_metric *metric = NULL;
+        aws_array_list_get_at(&registry->metrics, &metric, i);
+        destroy_metric(registry->allocator, metric);
+    }
+
+    aws_array_list_clean_up(&registry->metrics);
+    aws_mutex_clean_up(&registry->lock);
+}
+
+static int init_value(struct aws_allocator *allocator, struct aws_metric *metric) {
+    switch (metric->type) {
+        case AWS_METRIC_COUNTER:
+            return aws_sharded_counter_init(&metric->value.counter, allocator);
+        case AWS_METRIC_GAUGE:
+            aws_atomic_init_int(&metric->value.gauge, 0);
+            return AWS_OP_SUCCESS;
+        default:
+            break;
+    }
+
+    /* validates the range and precision and works out the bucket layout, then gives its buckets back. */
+    struct aws_histogram layout;
+    if (aws_histogram_init(&layout, allocator, metric->highest_trackable_value, metric->significant_figures)) {
+        return AWS_OP_ERR;
+    }
+    aws_histogram_clean_up(&layout);
+
+    struct aws_percpu *shards = &metric->value.histogram;
+    if (aws_percpu_init(shards, allocator, sizeof(struct histogram_shard))) {
+        return AWS_OP_ERR;
+    }
+
+    for (size_t i = 0; i < aws_percpu_slot_count(shards); ++i) {
+        struct histogram_shard *shard = (struct histogram_shard *)aws_percpu_get(shards, i);
+        shard->layout = layout;
+        shard->counts = (struct aws_atomic_var *)aws_mem_acquire(allocator,
+                layout.counts_len * sizeof(struct aws_atomic_var));
+        if (!shard->counts) {
+            clean_up_histogram_shards(allocator, shards, i);
+            return aws_raise_error(AWS_ERROR_OOM);
+        }
+
+        for (size_t j = 0; j < layout.counts_len; ++j) {
+            aws_atomic_init_int(&shard->counts[j], 0);
+        }
+        aws_atomic_init_int(&shard->min, SIZE_MAX);
+        aws_atomic_init_int(&shard->max, 0);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static struct aws_metric *create_metric(struct aws_allocator *allocator, const char *name, const char *help,
+        enum aws_metric_type type, uint64_t highest_trackable_value, int significant_figures) {
+    struct aws_metric *metric = (struct aws_metric *)aws_mem_acquire(allocator, sizeof(struct aws_metric));
+    if (!metric) {
+        aws_raise_error(AWS_ERROR_OOM);
+        return NULL;
+    }
+
+    memset(metric, 0, sizeof(struct aws_metric));
+    metric->type = type;
+    metric->highest_trackable_value = highest_trackable_value;
+    metric->significant_figures = significant_figures;
+    metric->name = copy_string(allocator, name, strlen(name));
+    metric->help = copy_string(allocator, help, strlen(help));
+
+    if (!metric->name || !metric->help) {
+        aws_mem_release(allocator, metric->name);
+        aws_mem_release(allocator, metric->help);
+        aws_mem_release(allocator, metric);
+        aws_raise_error(AWS_ERROR_OOM);
+        return NULL;
+    }
+
+    if (init_value(allocator, metric)) {
+        aws_mem_release(allocator, metric->name);
+        aws_mem_release(allocator, metric->help);
+        aws_mem_release(allocator, metric);
+        return NULL;
+    }
+
+    return metric;
+}
+
+static int register_metric(struct aws_metrics_registry *registry, const char *name, const char *help,
+        enum aws_metric_type type, uint64_t highest_trackable_value, int significant_figures,
+        struct aws_metric **metric) {
+    if (!is_valid_name(name, strlen(name))) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    int err = AWS_OP_SUCCESS;
+    *metric = NULL;
+
+    aws_mutex_lock(&registry->lock);
+    for (size_t i = 0; i < aws_array_list_length(&registry->metrics); ++i) {
+        struct aws_metric *existing = NULL;
+        aws_array_list_get_at(&registry->metrics, &existing, i);
+
+        if (!strcmp(existing->name, name)) {
+            if (existing->type != type) {
+                err = aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+            }
+            else {
+                *metric = existing;
+            }
+            break;
+        }
+    }
+
+    if (!err && !*metric) {
+        struct aws_metric *created = create_metric(registry->allocator, name, help, type, highest_trackable_value,
+                significant_figures);
+        if (!created) {
+            err = AWS_OP_ERR;
+        }
+        else if (aws_array_list_push_back(&registry->metrics, &created)) {
+            destroy_metric(registry->allocator, created);
+            err = AWS_OP_ERR;
+        }
+        else {
+            *metric = created;
+        }
+    }
+    aws_mutex_unlock(&registry->lock);
+
+    return err;
+}
+
+int aws_metrics_registry_counter(struct aws_metrics_registry *registry, const char *name, const char *help,
+        struct aws_metric **metric) {
+    return register_metric(registry, name, help, AWS_METRIC_COUNTER, 0, 0, metric);
+}
+
+int aws_metrics_registry_gauge(struct aws_metrics_registry *registry, const char *name, const char *help,
+        struct aws_metric **metric) {
+    return register_metric(registry, name, help, AWS_METRIC_GAUGE, 0, 0, metric);
+}
+
+int aws_metrics_registry_histogram(struct aws_metrics_registry *registry, const char *name, const char *help,
+        uint64_t highest_trackable_value, int significant_figures, struct aws_metric **metric) {
+    return register_metric(registry, name, help, AWS_METRIC_HISTOGRAM, highest_trackable_value, significant_figures,
+            metric);
+}
+
+void aws_metric_gauge_set(struct aws_metric *metric, int64_t value) {
+    aws_atomic_store_int_explicit(&metric->value.gauge, (size_t)(intptr_t)value, aws_memory_order_relaxed);
+}
+
+void aws_metric_gauge_add(struct aws_metric *metric, int64_t delta) {
+    /* two's complement: adding a negative delta's bit pattern subtracts it. */
+    aws_atomic_fetch_add_explicit(&metric->value.gauge, (size_t)(intptr_t)delta, aws_memory_order_relaxed);
+}
+
+void aws_metric_histogram_record(struct aws_metric *metric, uint64_t value) {
+    struct histogram_shard *shard = (struct histogram_shard *)aws_percpu_this_cpu(&metric->value.histogram);
+    size_t bound = value < SIZE_MAX ? (size_t)value : SIZE_MAX;
+
+    /* the bounds go first, so a snapshot that sees the count also sees them. */
+    size_t min = aws_atomic_load_int_explicit(&shard->min, aws_memory_order_relaxed);
+    while (bound < min && !aws_atomic_compare_exchange_int_explicit(&shard->min, &min, bound,
+            aws_memory_order_relaxed, aws_memory_order_relaxed)) {
+    }
+
+    size_t max = aws_atomic_load_int_explicit(&shard->max, aws_memory_order_relaxed);
+    while (bound > max && !aws_atomic_compare_exchange_int_explicit(&shard->max, &max, bound,
+            aws_memory_order_relaxed, aws_memory_order_relaxed)) {
+    }
+
+    uint64_t clamped = value < shard->layout.highest_trackable_value ? value : shard->layout.highest_trackable_value;
+    /* release pairs with the acquire in sample_histogram(). */
+    aws_atomic_fetch_add_explicit(&shard->counts[aws_histogram_bucket_index(&shard->layout, clamped)], 1,
+            aws_memory_order_release);
+}
+
+static void clean_up_sample(struct aws_allocator *allocator, struct aws_metric_sample *sample) {
+    if (sample->type == AWS_METRIC_HISTOGRAM) {
+        aws_histogram_clean_up(&sample->histogram);
+    }
+    aws_mem_release(allocator, sample->name);
+    aws_mem_release(allocator, sample->help);
+}
+
+void aws_metrics_snapshot_clean_up(struct aws_metrics_snapshot *snapshot) {
+    for (size_t i = 0; i < aws_array_list_length(&snapshot->samples); ++i) {
+        struct aws_metric_sample *sample = NULL;
+        aws_array_list_get_at_ptr(&snapshot->samples, (void **)&sample, i);
+        clean_up_sample(snapshot->allocator, sample);
+    }
+    aws_array_list_clean_up(&snapshot->samples);
+}
+
+/*
+ * Adds every shard's buckets up without stopping recorders. The total is summed from the buckets read rather than kept
+ * separately, so it always agrees with them even while values are being recorded.
+ */
+static void sample_histogram(struct aws_metric *metric, struct aws_histogram *histogram) {
+    struct aws_percpu *shards = &metric->value.histogram;
+    for (size_t i = 0; i < aws_percpu_slot_count(shards); ++i) {
+        struct histogram_shard *shard = (struct histogram_shard *)aws_percpu_get(shards, i);
+
+        for (size_t j = 0; j < shard->layout.counts_len; ++j) {
+            uint64_t count = aws_atomic_load_int_explicit(&shard->counts[j], aws_memory_order_acquire);
+            histogram->counts[j] += count;
+            histogram->total_count += count;
+        }
+
+        size_t min = aws_atomic_load_int_explicit(&shard->min, aws_memory_order_relaxed);
+        size_t max = aws_atomic_load_int_explicit(&shard->max, aws_memory_order_relaxed);
+        if (min <= max) {
+            histogram->min = min < histogram->min ? min : histogram->min;
+            histogram->max = max > histogram->max ? max : histogram->max;
+        }
+    }
+}
+
+static int sample_metric(struct aws_allocator *allocator, struct aws_metric *metric,
+        struct aws_metric_sample *sample) {
+    memset(sample, 0, sizeof(struct aws_metric_sample));
+    sample->type = metric->type;
+
+    if (metric->type == AWS_METRIC_HISTOGRAM) {
+        if (aws_histogram_init(&sample->histogram, allocator, metric->highest_trackable_value,
+                metric->significant_figures)) {
+            return AWS_OP_ERR;
+        }
+
+        sample_histogram(metric, &sample->histogram);
+    }
+    else if (metric->type == AWS_METRIC_COUNTER) {
+        sample->counter = aws_sharded_counter_sum(&metric->value.counter);
+    }
+    else {
+        /* through intptr_t, so a negative gauge is sign extended where the word is narrower than 64 bits. */
+        sample->gauge = (int64_t)(intptr_t)aws_atomic_load_int_explicit(&metric->value.gauge,
+                aws_memory_order_relaxed);
+    }
+
+    sample->name = copy_string(allocator, metric->name, strlen(metric->name));
+    sample->help = copy_string(allocator, metric->help, strlen(metric->help));
+    if (!sample->name || !sample->help) {
+        clean_up_sample(allocator, sample);
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_metrics_registry_snapshot(struct aws_metrics_registry *registry, struct aws_allocator *allocator,
+        struct aws_metrics_snapshot *snapshot) {
+    snapshot->allocator = allocator;
+
+    aws_mutex_lock(&registry->lock);
+    size_t count = aws_array_list_length(&registry->metrics);
+    if (aws_array_list_init_dynamic(&snapshot->samples, allocator, count ? count : 1,
+            sizeof(struct aws_metric_sample))) {
+        aws_mutex_unlock(&registry->lock);
+        return AWS_OP_ERR;
+    }
+
+    int err = AWS_OP_SUCCESS;
+    for (size_t i = 0; i < count && !err; ++i) {
+        struct aws_metric *metric = NULL;
+        struct aws_metric_sample sample;
+        aws_array_list_get_at(&registry->metrics, &metric, i);
+
+        err = sample_metric(allocator, metric, &sample);
+        if (!err && aws_array_list_push_back(&snapshot->samples, &sample)) {
+            clean_up_sample(allocator, &sample);
+            err = AWS_OP_ERR;
+        }
+    }
+    aws_mutex_unlock(&registry->lock);
+
+    if (err) {
+        aws_metrics_snapshot_clean_up(snapshot);
+    }
+
+    return err;
+}
+
+static void write_help(FILE *out, const char *help) {
+    for (; *help; ++help) {
+        if (*help == '\\') {
+            fputs("\\\\", out);
+        }
+        else if (*help == '\n') {
+            fputs("\\n", out);
+        }
+        else {
+            fputc(*help, out);
+        }
+    }
+}
+
+int aws_metrics_snapshot_write_prometheus(const struct aws_metrics_snapshot *snapshot, FILE *out) {
+    static const char *types[] = { "counter", "gauge", "summary" };
+    static const char *quantiles[] = { "0.5", "0.9", "0.99", "0.999" };
+    static const double percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+
+    for (size_t i = 0; i < aws_array_list_length(&snapshot->samples); ++i) {
+        struct aws_metric_sample *sample = NULL;
+        aws_array_list_get_at_ptr(&snapshot->samples, (void **)&sample, i);
+
+        fprintf(out, "# HELP %s ", sample->name);
+        write_help(out, sample->help);
+        fprintf(out, "\n# TYPE %s %s\n", sample->name, types[sample->type]);
+
+        if (sample->type == AWS_METRIC_COUNTER) {
+            fprintf(out, "%s %" PRIu64 "\n", sample->name, sample->counter);
+        }
+        else if (sample->type == AWS_METRIC_GAUGE) {
+            fprintf(out, "%s %" PRId64 "\n", sample->name, sample->gauge);
+        }
+        else {
+            const struct aws_histogram *histogram = &sample->histogram;
+            for (size_t q = 0; q < sizeof(percentiles) / sizeof(percentiles[0]); ++q) {
+                fprintf(out, "%s{quantile=\"%s\"} %" PRIu64 "\n", sample->name, quantiles[q],
+                        aws_histogram_value_at_percentile(histogram, percentiles[q]));
+            }
+            fprintf(out, "%s_sum %.0f\n", sample->name, aws_histogram_mean(histogram) * (double)histogram->total_count);
+            fprintf(out, "%s_count %" PRIu64 "\n", sample->name, histogram->total_count);
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+/*
+ * The encoding is a version byte and a varint (see private/varint.h) count of samples, then for each sample its type
+ * byte, its name and help as varint lengths followed by the bytes, and its value: a counter as a varint, a gauge as a
+ * zigzag varint, and a histogram as the varint length of its aws_histogram_encode() encoding followed by it.
+ */
+
+static uint64_t zigzag(int64_t value) {
+    return value < 0 ? ~((uint64_t)value << 1) : (uint64_t)value << 1;
+}
+
+static int64_t unzigzag(uint64_t value) {
+    return (int64_t)((value >> 1) ^ (~(value & 1) + 1));
+}
+
+static int value_encoded_len(const struct aws_metric_sample *sample, size_t *value_len) {
+    if (sample->type == AWS_METRIC_COUNTER) {
+        *value_len = aws_varint_len(sample->counter);
+    }
+    else if (sample->type == AWS_METRIC_GAUGE) {
+        *value_len = aws_varint_len(zigzag(sample->gauge));
+    }
+    else {
+        size_t histogram_len = 0;
+        if (aws_histogram_compute_encoded_len(&sample->histogram, &histogram_len)) {
+            return AWS_OP_ERR;
+        }
+        *value_len = aws_varint_len(histogram_len) + histogram_len;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_metrics_snapshot_compute_encoded_len(const struct aws_metrics_snapshot *snapshot, size_t *encoded_len) {
+    size_t count = aws_array_list_length(&snapshot->samples);
+    size_t len = 1 + aws_varint_len(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        struct aws_metric_sample *sample = NULL;
+        size_t value_len = 0;
+        aws_array_list_get_at_ptr(&snapshot->samples, (void **)&sample, i);
+
+        if (value_encoded_len(sample, &value_len)) {
+            return AWS_OP_ERR;
+        }
+
+        size_t name_len = strlen(sample->name);
+        size_t help_len = strlen(sample->help);
+        len += 1 + aws_varint_len(name_len) + name_len + aws_varint_len(help_len) + help_len + value_len;
+    }
+
+    *encoded_len = len;
+    return AWS_OP_SUCCESS;
+}
+
+static uint8_t *write_string(uint8_t *output, const char *str) {
+    size_t len = strlen(str);
+    output = aws_varint_write(output, len);
+    memcpy(output, str, len);
+    return output + len;
+}
+
+int aws_metrics_snapshot_encode(const struct aws_metrics_snapshot *snapshot, uint8_t *output, size_t output_size,
+        size_t *encoded_len) {
+    size_t len = 0;
+    if (aws_metrics_snapshot_compute_encoded_len(snapshot, &len)) {
+        return AWS_OP_ERR;
+    }
+
+    if (output_size < len) {
+        return aws_raise_error(AWS_ERROR_INVALID_BUFFER_SIZE);
+    }
+
+    size_t count = aws_array_list_length(&snapshot->samples);
+    uint8_t *cursor = output;
+    *cursor++ = ENCODING_VERSION;
+    cursor = aws_varint_write(cursor, count);
+
+    for (size_t i = 0; i < count; ++i) {
+        struct aws_metric_sample *sample = NULL;
+        aws_array_list_get_at_ptr(&snapshot->samples, (void **)&sample, i);
+
+        *cursor++ = (uint8_t)sample->type;
+        cursor = write_string(cursor, sample->name);
+        cursor = write_string(cursor, sample->help);
+
+        if (sample->type == AWS_METRIC_COUNTER) {
+            cursor = aws_varint_write(cursor, sample->counter);
+        }
+        else if (sample->type == AWS_METRIC_GAUGE) {
+            cursor = aws_varint_write(cursor, zigzag(sample->gauge));
+        }
+        else {
+            size_t histogram_len = 0;
+            aws_histogram_compute_encoded_len(&sample->histogram, &histogram_len);
+            cursor = aws_varint_write(cursor, histogram_len);
+            if (aws_histogram_encode(&sample->histogram, cursor, histogram_len, &histogram_len)) {
+                return AWS_OP_ERR;
+            }
+            cursor += histogram_len;
+        }
+    }
+
+    *encoded_len = len;
+    return AWS_OP_SUCCESS;
+}
+
+static int read_string(struct aws_allocator *allocator, const uint8_t **input, const uint8_t *end, char **str) {
+    uint64_t len = 0;
+    if (aws_varint_read(input, end, &len) || len > (uint64_t)(end - *input)) {
+        return aws_raise_error(AWS_ERROR_INVALID_METRICS_ENCODING);
+    }
+
+    *str = copy_string(allocator, (const char *)*input, (size_t)len);
+    if (!*str) {
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
+
+    *input += len;
+    return AWS_OP_SUCCESS;
+}
+
+static int read_sample(struct aws_allocator *allocator, const uint8_t **input, const uint8_t *end,
+        struct aws_metric_sample *sample) {
+    memset(sample, 0, sizeof(struct aws_metric_sample));
+    sample->type = AWS_METRIC_COUNTER;
+
+    if (*input == end || **input > AWS_METRIC_HISTOGRAM) {
+        return aws_raise_error(AWS_ERROR_INVALID_METRICS_ENCODING);
+    }
+    enum aws_metric_type type = (enum aws_metric_type)*(*input)++;
+
+    if (read_string(allocator, input, end, &sample->name) || read_string(allocator, input, end, &sample->help)) {
+        goto error;
+    }
+
+    if (!is_valid_name(sample->name, strlen(sample->name))) {
+        aws_raise_error(AWS_ERROR_INVALID_METRICS_ENCODING);
+        goto error;
+    }
+
+    uint64_t value = 0;
+    if (aws_varint_read(input, end, &value)) {
+        aws_raise_error(AWS_ERROR_INVALID_METRICS_ENCODING);
+        goto error;
+    }
+
+    if (type == AWS_METRIC_COUNTER) {
+        sample->counter = value;
+    }
+    else if (type == AWS_METRIC_GAUGE) {
+        sample->type = type;
+        sample->gauge = unzigzag(value);
+    }
+    else {
+        if (value > (uint64_t)(end - *input) ||
+                aws_histogram_decode(&sample->histogram, allocator, *input, (size_t)value)) {
+            aws_raise_error(AWS_ERROR_INVALID_METRICS_ENCODING);
+            goto error;
+        }
+        sample->type = type;
+        *input += value;
+    }
+
+    return AWS_OP_SUCCESS;
+
+error:
+    clean_up_sample(allocator, sample);
+    return AWS_OP_ERR;
+}
+
+int aws_metrics_snapshot_decode(struct aws_metrics_snapshot *snapshot, struct aws_allocator *allocator,
+        const uint8_t *input, size_t input_len) {
+    const uint8_t *end = input + input_len;
+    uint64_t count = 0;
+
+    if (!input_len || *input++ != ENCODING_VERSION || aws_varint_read(&input, end, &count) ||
+            count > (uint64_t)(end - input)) {
+        return aws_raise_error(AWS_ERROR_INVALID_METRICS_ENCODING);
+    }
+
+    snapshot->allocator = allocator;
+    if (aws_array_list_init_dynamic(&snapshot->samples, allocator, count ? (size_t)count : 1,
+            sizeof(struct aws_metric_sample))) {
+        return AWS_OP_ERR;
+    }
+
+    for (uint64_t i = 0; i < count; ++i) {
+        struct aws_metric_sample sample;
+        if (read_sample(allocator, &input, end, &sample)) {
+            aws_metrics_snapshot_clean_up(snapshot);
+            return AWS_OP_ERR;
+        }
+
+        if (aws_array_list_push_back(&snapshot->samples, &sample)) {
+            clean_up_sample(allocator, &sample);
+            aws_metrics_snapshot_clean_up(snapshot);
+            return AWS_OP_ERR;
+        }
+    }
+
+    if (input != end) {
+        aws_metrics_snapshot_clean_up(snapshot);
+        return aws_raise_error(AWS_ERROR_INVALID_METRICS_ENCODING);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+struct aws_atomic_var aws_library_metrics_flag = AWS_ATOMIC_INIT_INT(0);
+
+static struct aws_metrics_registry library_registry;
+static int library_registry_ready = 0;
+static struct aws_once library_registry_once = AWS_ONCE_INIT;
+
+/* indexed by enum aws_library_metric. */
+static struct aws_metric *library_metrics[AWS_LIBRARY_METRIC_COUNT];
+static const char *library_metric_names[AWS_LIBRARY_METRIC_COUNT][2] = {
+    { "aws_allocations_total", "Allocations made through aws_mem_acquire()." },
+    { "aws_thread_launches_total", "Threads started with aws_thread_launch()." },
+    { "aws_mutex_contentions_total", "aws_mutex_lock() calls that found the mutex already locked." },
+    { "aws_errors_raised_total", "Errors raised with aws_raise_error()." },
+};
+
+static void init_library_registry(void *user_data) {
+    (void)user_data;
+
+    if (aws_metrics_registry_init(&library_registry, aws_default_allocator())) {
+        return;
+    }
+
+    for (size_t i = 0; i < AWS_LIBRARY_METRIC_COUNT; ++i) {
+        if (aws_metrics_registry_counter(&library_registry, library_metric_names[i][0], library_metric_names[i][1],
+                &library_metrics[i])) {
+            aws_metrics_registry_clean_up(&library_registry);
+            return;
+        }
+    }
+
+    library_registry_ready = 1;
+}
+
+struct aws_metrics_registry *aws_metrics_library_registry(void) {
+    aws_call_once(&library_registry_once, init_library_registry, NULL);
+    return library_registry_ready ? &library_registry : NULL;
+}
+
+int aws_metrics_library_set_enabled(int enabled) {
+    if (enabled && !aws_metrics_library_registry()) {
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
+
+    aws_atomic_store_int(&aws_library_metrics_flag, enabled ? 1 : 0);
+    return AWS_OP_SUCCESS;
+}
+
+void aws_library_metrics_increment(enum aws_library_metric metric) {
+    aws_metric_counter_add(library_metrics[metric], 1);
+}
@@ -0,0 +1,297 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/private/mutex_profile.h>
+#include <aws/common/clock.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* per-thread hash table capacity; must be a power of two. */
+#define PROFILE_TABLE_SIZE 256
+/* give up probing after this many slots and count the sample as dropped. */
+#define PROFILE_MAX_PROBES 16
+
+struct profile_buffer {
+    struct profile_buffer *next;
+    /* non-zero while a thread owns the buffer. */
+    struct aws_atomic_var in_use;
+    uint64_t dropped;
+    struct aws_mutex_contention_stats entries[PROFILE_TABLE_SIZE];
+};
+
+struct aws_atomic_var aws_mutex_profiling_flag = AWS_ATOMIC_INIT_INT(0);
+
+/* every buffer ever allocated, pushed once and never removed, so the statistics outlive the threads that collected
+ * them. A thread started by aws_thread_launch() gives its buffer up as it exits, and the next thread to need one keeps
+ * adding to it: the report merges every thread's entries for a mutex and call site anyway. */
+static struct aws_atomic_var buffers = AWS_ATOMIC_INIT_PTR(NULL);
+static AWS_THREAD_LOCAL struct profile_buffer *thread_buffer = NULL;
+
+void aws_mutex_profiling_set_enabled(int enabled) {
+    aws_atomic_store_int(&aws_mutex_profiling_flag, enabled ? 1 : 0);
+}
+
+int aws_mutex_profiling_enabled(void) {
+    return aws_mutex_profiling_active();
+}
+
+static struct profile_buffer *get_thread_buffer(void) {
+    if (AWS_LIKELY(thread_buffer != NULL)) {
+        return thread_buffer;
+    }
+
+    struct profile_buffer *buffer = (struct profile_buffer *)aws_atomic_load_ptr_explicit(&buffers,
+            aws_memory_order_acquire);
+    for (; buffer; buffer = buffer->next) {
+        size_t unused = 0;
+        /* acquire pairs with the release in aws_mutex_profile_on_thread_exit(), so the previous owner's writes are
+         * done. */
+        if (aws_atomic_compare_exchange_int_explicit(&buffer->in_use, &unused, 1, aws_memory_order_acquire,
+                aws_memory_order_relaxed)) {
+            thread_buffer = buffer;
+            return buffer;
+        }
+    }
+
+    buffer = (struct profile_buffer *)aws_mem_acquire(aws_default_allocator(), sizeof(struct profile_buffer));
+    if (!buffer) {
+        return NULL;
+    }
+    memset(buffer, 0, sizeof(struct profile_buffer));
+    aws_atomic_init_int(&buffer->in_use, 1);
+
+    void *head = aws_atomic_load_ptr_explicit(&buffers, aws_memory_order_relaxed);
+    do {
+        buffer->next = (struct profile_buffer *)head;
+    } while (!aws_atomic_compare_exchange_ptr_explicit(&buffers, &head, buffer, aws_memory_order_release,
+            aws_memory_order_relaxed));
+
+    thread_buffer = buffer;
+    return buffer;
+}
+
+void aws_mutex_profile_on_thread_exit(void) {
+    if (thread_buffer) {
+        aws_atomic_store_int_explicit(&thread_buffer->in_use, 0, aws_memory_order_release);
+        thread_buffer = NULL;
+    }
+}
+
+static struct aws_mutex_contention_stats *find_entry(const struct aws_mutex *mutex, const void *call_site) {
+    struct profile_buffer *buffer = get_thread_buffer();
+    if (!buffer) {
+        return NULL;
+    }
+
+    uint64_t hash = ((uint64_t)(uintptr_t)mutex ^ ((uint64_t)(uintptr_t)call_site << 7)) * 0x9E3779B97F4A7C15ULL;
+    size_t index = (size_t)(hash >> 32);
+
+    for (size_t probe = 0; probe < PROFILE_MAX_PROBES; ++probe) {
+        struct aws_mutex_contention_stats *entry = &buffer->entries[(index + probe) & (PROFILE_TABLE_SIZE - 1)];
+
+        if (entry->mutex == mutex && entry->call_site == call_site) {
+            return entry;
+        }
+
+        if (!entry->mutex) {
+            entry->mutex = mutex;
+            entry->call_site = call_site;
+            return entry;
+        }
+    }
+
+    buffer->dropped++;
+    return NULL;
+}
+
+void aws_mutex_profile_record_lock(struct aws_mutex *mutex, const void *call_site, uint64_t wait_start) {
+    uint64_t now = 0;
+    if (aws_high_res_clock_get_ticks(&now)) {
+        return;
+    }
+
+    struct aws_mutex_contention_stats *entry = find_entry(mutex, call_site);
+    if (!entry) {
+        return;
+    }
+
+    entry->acquisitions++;
+    if (wait_start) {
+        uint64_t wait = now - wait_start;
+        entry->contentions++;
+        entry->wait_ns += wait;
+        if (wait > entry->max_wait_ns) {
+            entry->max_wait_ns = wait;
+        }
+    }
+
+    mutex->profile_call_site = call_site;
+    mutex->profile_acquired_at = now;
+}
+
+void aws_mutex_profile_record_unlock(struct aws_mutex *mutex) {
+    uint64_t acquired_at = mutex->profile_acquired_at;
+    mutex->profile_acquired_at = 0;
+
+    uint64_t now = 0;
+    if (aws_high_res_clock_get_ticks(&now)) {
+        return;
+    }
+
+    struct aws_mutex_contention_stats *entry = find_entry(mutex, mutex->profile_call_site);
+    if (!entry) {
+        return;
+    }
+
+    uint64_t hold = now - acquired_at;
+    entry->hold_ns += hold;
+    if (hold > entry->max_hold_ns) {
+        entry->max_hold_ns = hold;
+    }
+}
+
+static int compare_by_key(const void *a, const void *b) {
+    const struct aws_mutex_contention_stats *left = (const struct aws_mutex_contention_stats *)a;
+    const struct aws_mutex_contention_stats *right = (const struct aws_mutex_contention_stats *)b;
+
+    if (left->mutex != right->mutex) {
+        return (uintptr_t)left->mutex < (uintptr_t)right->mutex ? -1 : 1;
+    }
+    if (left->call_site != right->call_site) {
+        return (uintptr_t)left->call_site < (uintptr_t)right->call_site ? -1 : 1;
+    }
+    return 0;
+}
+
+static int compare_by_rank(const void *a, const void *b) {
+    const struct aws_mutex_contention_stats *left = (const struct aws_mutex_contention_stats *)a;
+    const struct aws_mutex_contention_stats *right = (const struct aws_mutex_contention_stats *)b;
+
+    if (left->wait_ns != right->wait_ns) {
+        return left->wait_ns > right->wait_ns ? -1 : 1;
+    }
+    if (left->contentions != right->contentions) {
+        return left->contentions > right->contentions ? -1 : 1;
+    }
+    if (left->acquisitions != right->acquisitions) {
+        return left->acquisitions > right->acquisitions ? -1 : 1;
+    }
+    return 0;
+}
+
+int aws_mutex_profiling_report(struct aws_allocator *allocator, struct aws_array_list *stats) {
+    if (aws_array_list_init_dynamic(stats, allocator, 16, sizeof(struct aws_mutex_contention_stats))) {
+        return AWS_OP_ERR;
+    }
+
+    struct profile_buffer *buffer = (struct profile_buffer *)aws_atomic_load_ptr_explicit(&buffers,
+            aws_memory_order_acquire);
+    for (; buffer; buffer = buffer->next) {
+        for (size_t i = 0; i < PROFILE_TABLE_SIZE; ++i) {
+            if (buffer->entries[i].mutex && aws_array_list_push_back(stats, &buffer->entries[i])) {
+                aws_array_list_clean_up(stats);
+                return AWS_OP_ERR;
+            }
+        }
+    }
+
+    size_t count = aws_array_list_length(stats);
+    if (!count) {
+        return AWS_OP_SUCCESS;
+    }
+
+    /* merge the entries different threads recorded for the same mutex and call site. */
+    struct aws_mutex_contention_stats *entries = (struct aws_mutex_contention_stats *)stats->data;
+    qsort(entries, count, sizeof(struct aws_mutex_contention_stats), compare_by_key);
+
+    size_t merged = 0;
+    for (size_t i = 1; i < count; ++i) {
+        struct aws_mutex_contention_stats *into = &entries[merged];
+
+        if (!compare_by_key(into, &entries[i])) {
+            into->acquisitions += entries[i].acquisitions;
+            into->contentions += entries[i].contentions;
+            into->wait_ns += entries[i].wait_ns;
+            into->hold_ns += entries[i].hold_ns;
+            if (entries[i].max_wait_ns > into->max_wait_ns) {
+                into->max_wait_ns = entries[i].max_wait_ns;
+            }
+            if (entries[i].max_hold_ns > into->max_hold_ns) {
+                into->max_hold_ns = entries[i].max_hold_ns;
+            }
+        }
+        else {
+            entries[++merged] = entries[i];
+        }
+    }
+
+    while (aws_array_list_length(stats) > merged + 1) {
+        aws_array_list_pop_back(stats);
+    }
+
+    qsort(entries, merged + 1, sizeof(struct aws_mutex_contention_stats), compare_by_rank);
+    return AWS_OP_SUCCESS;
+}
+
+int aws_mutex_profiling_dump(FILE *out, size_t max_entries) {
+    struct aws_array_list stats;
+    if (aws_mutex_profiling_report(aws_default_allocator(), &stats)) {
+        return AWS_OP_ERR;
+    }
+
+    size_t count = aws_array_list_length(&stats);
+    if (max_entries && max_entries < count) {
+        count = max_entries;
+    }
+
+    fprintf(out, "%4s %18s %18s %12s %12s %7s %12s %12s %12s %12s\n", "rank", "mutex", "call site", "acquisitions",
+            "contentions", "cont %", "wait ms", "max wait us", "hold ms", "max hold us");
+
+    for (size_t i = 0; i < count; ++i) {
+        struct aws_mutex_contention_stats *entry = NULL;
+        aws_array_list_get_at_ptr(&stats, (void **)&entry, i);
+
+        fprintf(out, "%4zu %18p %18p %12" PRIu64 " %12" PRIu64 " %7.2f %12.3f %12.3f %12.3f %12.3f\n", i + 1,
+                (const void *)entry->mutex, entry->call_site, entry->acquisitions, entry->contentions,
+                entry->acquisitions ? 100.0 * (double)entry->contentions / (double)entry->acquisitions : 0.0,
+                (double)entry->wait_ns / 1e6, (double)entry->max_wait_ns / 1e3, (double)entry->hold_ns / 1e6,
+                (double)entry->max_hold_ns / 1e3);
+    }
+
+    uint64_t dropped = 0;
+    struct profile_buffer *buffer = (struct profile_buffer *)aws_atomic_load_ptr_explicit(&buffers,
+            aws_memory_order_acquire);
+    for (; buffer; buffer = buffer->next) {
+        dropped += buffer->dropped;
+    }
+
+    if (dropped) {
+        fprintf(out, "%" PRIu64 " samples dropped: too many distinct mutexes and call sites.\n", dropped);
+    }
+
+    aws_array_list_clean_up(&stats);
+    return AWS_OP_SUCCESS;
+}
+
+void aws_mutex_profiling_reset(void) {
+    struct profile_buffer *buffer = (struct profile_buffer *)aws_atomic_load_ptr_explicit(&buffers,
+            aws_memory_order_acquire);
+
+    for (; buffer; buffer = buffer->next) {
+        memset(buffer->entries, 0, sizeof(buffer->entries));
+        buffer->dropped = 0;
+    }
+}
@@ -0,0 +1,46 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/once.h>
+#include <aws/common/private/futex.h>
+
+void aws_call_once_slow(struct aws_once *flag, aws_once_fn fn, void *user_data) {
+    size_t state = AWS_ONCE_NOT_RUN;
+
+    if (aws_atomic_compare_exchange_int_explicit(&flag->state, &state, AWS_ONCE_RUNNING, aws_memory_order_acquire,
+            aws_memory_order_acquire)) {
+        fn(user_data);
+
+        if (aws_atomic_exchange_int_explicit(&flag->state, AWS_ONCE_DONE, aws_memory_order_release) ==
+                AWS_ONCE_RUNNING_WITH_WAITERS) {
+            aws_futex_wake(&flag->state, SIZE_MAX);
+        }
+        return;
+    }
+
+    while (state != AWS_ONCE_DONE) {
+        state = aws_futex_spin(&flag->state, state);
+
+        if (state == AWS_ONCE_RUNNING && !aws_atomic_compare_exchange_int_explicit(&flag->state, &state,
+                AWS_ONCE_RUNNING_WITH_WAITERS, aws_memory_order_acquire, aws_memory_order_acquire)) {
+            continue;
+        }
+
+        if (state != AWS_ONCE_DONE) {
+            aws_futex_wait(&flag->state, AWS_ONCE_RUNNING_WITH_WAITERS, AWS_FUTEX_WAIT_FOREVER);
+            state = aws_atomic_load_int_explicit(&flag->state, aws_memory_order_acquire);
+        }
+    }
+}
@@ -0,0 +1,91 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/percpu.h>
+#include <aws/common/system_info.h>
+#include <aws/common/thread.h>
+#include <string.h>
+
+static AWS_THREAD_LOCAL size_t thread_index = 0;
+static AWS_THREAD_LOCAL int thread_index_set = 0;
+
+int aws_percpu_init(struct aws_percpu *percpu, struct aws_allocator *allocator, size_t element_size) {
+    size_t processors = aws_system_info_processor_count();
+    size_t slot_count = 1;
+    while (slot_count < processors) {
+        slot_count <<= 1;
+    }
+
+    size_t slot_size = (element_size + AWS_CACHE_LINE - 1) & ~(size_t)(AWS_CACHE_LINE - 1);
+    if (!slot_size) {
+        slot_size = AWS_CACHE_LINE;
+    }
+
+    size_t size = slot_count * slot_size + AWS_CACHE_LINE - 1;
+    void *allocation = aws_mem_acquire(allocator, size);
+    if (!allocation) {
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
+    memset(allocation, 0, size);
+
+    percpu->allocator = allocator;
+    percpu->slot_count = slot_count;
+    percpu->slot_size = slot_size;
+    percpu->allocation = allocation;
+    percpu->slots = (uint8_t *)(((uintptr_t)allocation + AWS_CACHE_LINE - 1) & ~(uintptr_t)(AWS_CACHE_LINE - 1));
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_percpu_clean_up(struct aws_percpu *percpu) {
+    aws_mem_release(percpu->allocator, percpu->allocation);
+    percpu->allocation = NULL;
+    percpu->slots = NULL;
+}
+
+size_t aws_percpu_current_index(void) {
+    int cpu = aws_system_info_current_cpu();
+    if (AWS_LIKELY(cpu >= 0)) {
+        return (size_t)cpu;
+    }
+
+    /* no processor number: spread threads by a hash of their id instead. */
+    if (!thread_index_set) {
+        uint64_t hash = aws_thread_current_thread_id() * 0x9E3779B97F4A7C15ULL;
+        thread_index = (size_t)(hash >> 32);
+        thread_index_set = 1;
+    }
+
+    return thread_index;
+}
+
+int aws_sharded_counter_init(struct aws_sharded_counter *counter, struct aws_allocator *allocator) {
+    return aws_percpu_init(&counter->shards, allocator, sizeof(struct aws_atomic_var));
+}
+
+void aws_sharded_counter_clean_up(struct aws_sharded_counter *counter) {
+    aws_percpu_clean_up(&counter->shards);
+}
+
+size_t aws_sharded_counter_sum(const struct aws_sharded_counter *counter) {
+    size_t sum = 0;
+
+    for (size_t i = 0; i < aws_percpu_slot_count(&counter->shards); ++i) {
+        const struct aws_atomic_var *shard = (const struct aws_atomic_var *)aws_percpu_get(&counter->shards, i);
+        sum += aws_atomic_load_int_explicit(shard, aws_memory_order_relaxed);
+    }
+
+    return sum;
+}
@@ -0,0 +1,195 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/perf_counters.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if !defined(PERF_FLAG_FD_CLOEXEC)
+#define PERF_FLAG_FD_CLOEXEC 0
+#endif
+
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} counter_events[AWS_PERF_COUNTER_COUNT] = {
+    [AWS_PERF_COUNTER_CYCLES] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    [AWS_PERF_COUNTER_INSTRUCTIONS] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    [AWS_PERF_COUNTER_CACHE_MISSES] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    [AWS_PERF_COUNTER_BRANCH_MISSES] = { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    [AWS_PERF_COUNTER_TASK_CLOCK] = { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK },
+};
+
+/* what reading a group leader opened with the read_format below fills in. */
+struct group_read {
+    uint64_t nr;
+    uint64_t time_enabled;
+    uint64_t time_running;
+    uint64_t values[AWS_PERF_COUNTER_COUNT];
+};
+
+static int open_counter(enum aws_perf_counter_type counter, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = counter_events[counter].type;
+    attr.config = counter_events[counter].config;
+    /* the members of a group follow their leader, which starts out disabled. */
+    attr.disabled = group_fd == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+}
+#endif
+
+int aws_perf_counters_init(struct aws_perf_counters *counters) {
+    counters->leader = -1;
+    for (int i = 0; i < AWS_PERF_COUNTER_COUNT; ++i) {
+        counters->fds[i] = -1;
+    }
+
+#if defined(__linux__)
+    for (int i = 0; i < AWS_PERF_COUNTER_COUNT; ++i) {
+        int group_fd = counters->leader == -1 ? -1 : counters->fds[counters->leader];
+        counters->fds[i] = open_counter((enum aws_perf_counter_type)i, group_fd);
+        if (counters->fds[i] != -1 && counters->leader == -1) {
+            counters->leader = i;
+        }
+    }
+#endif
+
+    if (counters->leader == -1) {
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_perf_counters_clean_up(struct aws_perf_counters *counters) {
+#if defined(__linux__)
+    /* members first: closing the leader of a group with live members would promote them to groups of their own. */
+    for (int i = AWS_PERF_COUNTER_COUNT - 1; i >= 0; --i) {
+        if (counters->fds[i] != -1) {
+            close(counters->fds[i]);
+        }
+    }
+#endif
+
+    for (int i = 0; i < AWS_PERF_COUNTER_COUNT; ++i) {
+        counters->fds[i] = -1;
+    }
+    counters->leader = -1;
+}
+
+void aws_perf_counters_start(struct aws_perf_counters *counters) {
+#if defined(__linux__)
+    if (counters->leader != -1) {
+        int fd = counters->fds[counters->leader];
+        ioctl(fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#else
+    (void)counters;
+#endif
+}
+
+void aws_perf_counters_stop(struct aws_perf_counters *counters, struct aws_perf_counter_values *values) {
+    for (int i = 0; i < AWS_PERF_COUNTER_COUNT; ++i) {
+        values->counts[i] = 0;
+    }
+    values->available = 0;
+
+#if defined(__linux__)
+    if (counters->leader == -1) {
+        return;
+    }
+
+    int fd = counters->fds[counters->leader];
+    struct group_read group;
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    if (read(fd, &group, sizeof(group)) < (ssize_t)(3 * sizeof(uint64_t)) || !group.time_running) {
+        /* never got onto the hardware, e.g. because something else held every counter. */
+        return;
+    }
+
+    /* the values come in the order the group was opened in: the leader, then the others in type order. */
+    uint64_t next = 0;
+    for (int i = 0; i < AWS_PERF_COUNTER_COUNT && next < group.nr; ++i) {
+        if (counters->fds[i] == -1) {
+            continue;
+        }
+
+        uint64_t count = group.values[next++];
+        if (group.time_running < group.time_enabled) {
+            count = (uint64_t)((double)count * (double)group.time_enabled / (double)group.time_running);
+        }
+        values->counts[i] = count;
+        values->available |= 1u << i;
+    }
+#else
+    (void)counters;
+#endif
+}
+
+void aws_perf_counter_values_add(struct aws_perf_counter_values *to, const struct aws_perf_counter_values *from) {
+    for (int i = 0; i < AWS_PERF_COUNTER_COUNT; ++i) {
+        to->counts[i] += from->counts[i];
+    }
+    to->available &= from->available;
+}
+
+int aws_perf_counter_values_write_summary(FILE *out, const struct aws_perf_counter_values *values) {
+    const char *separator = "";
+
+    if (aws_perf_counter_values_has(values, (1u << AWS_PERF_COUNTER_CYCLES) | (1u << AWS_PERF_COUNTER_INSTRUCTIONS))) {
+        fprintf(out, "%.2f IPC", aws_perf_counter_values_ipc(values));
+        separator = ", ";
+    }
+
+    if (aws_perf_counter_values_has(values,
+            (1u << AWS_PERF_COUNTER_CACHE_MISSES) | (1u << AWS_PERF_COUNTER_INSTRUCTIONS))) {
+        fprintf(out, "%s%.2f cache misses/kinstr", separator,
+                aws_perf_counter_values_per_kilo_instruction(values, AWS_PERF_COUNTER_CACHE_MISSES));
+        separator = ", ";
+    }
+
+    if (aws_perf_counter_values_has(values,
+            (1u << AWS_PERF_COUNTER_BRANCH_MISSES) | (1u << AWS_PERF_COUNTER_INSTRUCTIONS))) {
+        fprintf(out, "%s%.2f branch misses/kinstr", separator,
+                aws_perf_counter_values_per_kilo_instruction(values, AWS_PERF_COUNTER_BRANCH_MISSES));
+        separator = ", ";
+    }
+
+    if (aws_perf_counter_values_has(values, (1u << AWS_PERF_COUNTER_CYCLES) | (1u << AWS_PERF_COUNTER_TASK_CLOCK)) &&
+            values->counts[AWS_PERF_COUNTER_TASK_CLOCK]) {
+        fprintf(out, "%s%.2f GHz", separator,
+                (double)values->counts[AWS_PERF_COUNTER_CYCLES] / (double)values->counts[AWS_PERF_COUNTER_TASK_CLOCK]);
+        separator = ", ";
+    }
+
+    if (!*separator) {
+        fputs("hardware counters unavailable", out);
+    }
+    fputc('\n', out);
+
+    return AWS_OP_SUCCESS;
+}
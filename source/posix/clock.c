@@ -14,6 +14,7 @@
  */
 
 #include <aws/common/clock.h>
+#include <aws/common/private/coarse_clock.h>
 #include <time.h>
 #if defined(__MACH__) && MAC_OS_X_VERSION_MAX_ALLOWED < 101200
 #include <sys/time.h>
@@ -27,6 +28,11 @@ static const uint64_t NS_PER_SEC = 1000000000;
 #define HIGH_RES_CLOCK CLOCK_MONOTONIC
 #endif
 
+#if defined(CLOCK_MONOTONIC_COARSE) && defined(CLOCK_REALTIME_COARSE)
+#define COARSE_CLOCK CLOCK_MONOTONIC_COARSE
+#define COARSE_SYS_CLOCK CLOCK_REALTIME_COARSE
+#endif
+
 int aws_high_res_clock_get_ticks(uint64_t *timestamp) {
     int ret_val = 0;
 
@@ -73,3 +79,44 @@ int aws_sys_clock_get_ticks(uint64_t *timestamp) {
     return AWS_OP_SUCCESS;
 }
 
+#if defined(COARSE_CLOCK)
+static int coarse_get_ticks(clockid_t clock_id, uint64_t *timestamp) {
+    struct timespec ts;
+    if (clock_gettime(clock_id, &ts)) {
+        return aws_raise_error(AWS_ERROR_CLOCK_FAILURE);
+    }
+
+    *timestamp = (uint64_t)ts.tv_sec * NS_PER_SEC + (uint64_t)ts.tv_nsec;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_coarse_clock_os_get_ticks(uint64_t *timestamp) {
+    return coarse_get_ticks(COARSE_CLOCK, timestamp);
+}
+
+int aws_coarse_sys_clock_os_get_ticks(uint64_t *timestamp) {
+    return coarse_get_ticks(COARSE_SYS_CLOCK, timestamp);
+}
+
+uint64_t aws_coarse_clock_os_resolution(void) {
+    struct timespec ts;
+    if (clock_getres(COARSE_CLOCK, &ts)) {
+        return 0;
+    }
+
+    return (uint64_t)ts.tv_sec * NS_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+#else
+/* no coarse clocks: the precise ones have to do, and the ticker is what makes reads cheap. */
+int aws_coarse_clock_os_get_ticks(uint64_t *timestamp) {
+    return aws_high_res_clock_get_ticks(timestamp);
+}
+
+int aws_coarse_sys_clock_os_get_ticks(uint64_t *timestamp) {
+    return aws_sys_clock_get_ticks(timestamp);
+}
+
+uint64_t aws_coarse_clock_os_resolution(void) {
+    return 1;
+}
+#endif
@@ -0,0 +1,138 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/private/futex.h>
+
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+
+static const uint64_t NS_PER_SEC = 1000000000;
+
+#if defined(__linux__)
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* futex(2) works on 32 bit words: use the half of the atomic that holds its low bits. */
+static uint32_t *low_word(struct aws_atomic_var *var) {
+    uint32_t *word = (uint32_t *)&var->value;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word += sizeof(var->value) / sizeof(uint32_t) - 1;
+#endif
+    return word;
+}
+
+int aws_futex_wait(struct aws_atomic_var *var, size_t expected, uint64_t deadline) {
+    uint64_t remaining = 0;
+    if (aws_futex_remaining(deadline, &remaining)) {
+        return AWS_OP_ERR;
+    }
+
+    struct timespec timeout = {
+        .tv_sec = (time_t)(remaining / NS_PER_SEC),
+        .tv_nsec = (long)(remaining % NS_PER_SEC),
+    };
+
+    if (syscall(SYS_futex, low_word(var), FUTEX_WAIT_PRIVATE, (uint32_t)expected,
+            remaining == AWS_FUTEX_WAIT_FOREVER ? NULL : &timeout, NULL, 0) && errno == ETIMEDOUT) {
+        return aws_raise_error(AWS_ERROR_WAIT_TIMEOUT);
+    }
+
+    /* woken up, interrupted, or the value had already changed (EAGAIN): the caller re-checks either way. */
+    return AWS_OP_SUCCESS;
+}
+
+void aws_futex_wake(struct aws_atomic_var *var, size_t count) {
+    syscall(SYS_futex, low_word(var), FUTEX_WAKE_PRIVATE, count > INT_MAX ? INT_MAX : (int)count, NULL, NULL, 0);
+}
+
+#else
+
+#include <pthread.h>
+#include <sys/time.h>
+
+/* no futex: sleep on a condition variable shared by every address that hashes to the same bucket. */
+#define FUTEX_BUCKETS 64
+
+struct futex_bucket {
+    pthread_mutex_t lock;
+    pthread_cond_t signal;
+};
+
+static struct futex_bucket buckets[FUTEX_BUCKETS];
+static pthread_once_t buckets_once = PTHREAD_ONCE_INIT;
+
+static void init_buckets(void) {
+    for (size_t i = 0; i < FUTEX_BUCKETS; ++i) {
+        pthread_mutex_init(&buckets[i].lock, NULL);
+        pthread_cond_init(&buckets[i].signal, NULL);
+    }
+}
+
+static struct futex_bucket *get_bucket(struct aws_atomic_var *var) {
+    pthread_once(&buckets_once, init_buckets);
+    uintptr_t address = (uintptr_t)var;
+    return &buckets[(address >> 4) % FUTEX_BUCKETS];
+}
+
+int aws_futex_wait(struct aws_atomic_var *var, size_t expected, uint64_t deadline) {
+    uint64_t remaining = 0;
+    if (aws_futex_remaining(deadline, &remaining)) {
+        return AWS_OP_ERR;
+    }
+
+    struct futex_bucket *bucket = get_bucket(var);
+    int err_code = 0;
+
+    pthread_mutex_lock(&bucket->lock);
+    /* wakers take the bucket lock after changing the value, so checking it under the lock can't miss a wake up. */
+    if (aws_atomic_load_int_explicit(var, aws_memory_order_seq_cst) == expected) {
+        if (remaining == AWS_FUTEX_WAIT_FOREVER) {
+            pthread_cond_wait(&bucket->signal, &bucket->lock);
+        }
+        else {
+            struct timeval now;
+            gettimeofday(&now, NULL);
+            uint64_t wake_time = (uint64_t)now.tv_sec * NS_PER_SEC + (uint64_t)now.tv_usec * 1000 + remaining;
+
+            struct timespec abstime = {
+                .tv_sec = (time_t)(wake_time / NS_PER_SEC),
+                .tv_nsec = (long)(wake_time % NS_PER_SEC),
+            };
+            err_code = pthread_cond_timedwait(&bucket->signal, &bucket->lock, &abstime);
+        }
+    }
+    pthread_mutex_unlock(&bucket->lock);
+
+    if (err_code == ETIMEDOUT) {
+        return aws_raise_error(AWS_ERROR_WAIT_TIMEOUT);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_futex_wake(struct aws_atomic_var *var, size_t count) {
+    (void)count;
+    struct futex_bucket *bucket = get_bucket(var);
+
+    pthread_mutex_lock(&bucket->lock);
+    pthread_mutex_unlock(&bucket->lock);
+    /* the bucket is shared with other addresses, so waking a subset could wake the wrong threads. */
+    pthread_cond_broadcast(&bucket->signal);
+}
+
+#endif
@@ -14,6 +14,11 @@
 */
 
 #include <aws/common/mutex.h>
+#include <aws/common/private/library_metrics.h>
+#include <aws/common/private/mutex_profile.h>
+#include <aws/common/private/probes.h>
+#include <aws/common/clock.h>
+#include <aws/common/trace.h>
 #include <errno.h>
 
 void aws_mutex_clean_up(struct aws_mutex *mutex) {
@@ -42,6 +47,8 @@ static int convert_and_raise_error_code (int error_code) {
 int aws_mutex_init(struct aws_mutex *mutex, struct aws_allocator *allocator) {
 
     mutex->allocator = allocator;
+    mutex->profile_acquired_at = 0;
+    mutex->profile_call_site = NULL;
     pthread_mutexattr_t attr;
     int err_code = pthread_mutexattr_init(&attr);
     int return_code = AWS_OP_SUCCESS;
@@ -60,9 +67,57 @@ int aws_mutex_init(struct aws_mutex *mutex, struct aws_allocator *allocator) {
     return return_code;
 }
 
+static int profiled_lock(struct aws_mutex *mutex, const void *call_site) {
+    uint64_t wait_start = 0;
+
+    if (pthread_mutex_trylock(&mutex->mutex_handle)) {
+        if (aws_library_metrics_active()) {
+            aws_library_metrics_increment(AWS_LIBRARY_METRIC_MUTEX_CONTENTIONS);
+        }
+        aws_high_res_clock_get_ticks(&wait_start);
+
+        int err_code = pthread_mutex_lock(&mutex->mutex_handle);
+        if (err_code) {
+            return convert_and_raise_error_code(err_code);
+        }
+    }
+
+    aws_mutex_profile_record_lock(mutex, call_site, wait_start);
+    return AWS_OP_SUCCESS;
+}
+
+/* counts and traces locks that have to wait; uncontended ones take the trylock and are left out. */
+static int instrumented_lock(struct aws_mutex *mutex) {
+    if (!pthread_mutex_trylock(&mutex->mutex_handle)) {
+        return AWS_OP_SUCCESS;
+    }
+
+    if (aws_library_metrics_active()) {
+        aws_library_metrics_increment(AWS_LIBRARY_METRIC_MUTEX_CONTENTIONS);
+    }
+
+    AWS_TRACE_BEGIN("aws_mutex_wait");
+    int err_code = pthread_mutex_lock(&mutex->mutex_handle);
+    AWS_TRACE_END("aws_mutex_wait");
+
+    return convert_and_raise_error_code(err_code);
+}
+
 int aws_mutex_lock(struct aws_mutex *mutex) {
+    int err;
 
-    return convert_and_raise_error_code(pthread_mutex_lock(&mutex->mutex_handle));
+    if (AWS_UNLIKELY(aws_mutex_profiling_active())) {
+        err = profiled_lock(mutex, AWS_RETURN_ADDRESS());
+    }
+    else if (AWS_UNLIKELY(aws_library_metrics_active() || AWS_TRACE_ACTIVE())) {
+        err = instrumented_lock(mutex);
+    }
+    else {
+        err = convert_and_raise_error_code(pthread_mutex_lock(&mutex->mutex_handle));
+    }
+
+    AWS_PROBE2(mutex_lock, mutex, err);
+    return err;
 }
 
 int aws_mutex_try_lock(struct aws_mutex *mutex) {
@@ -71,6 +126,11 @@ int aws_mutex_try_lock(struct aws_mutex *mutex) {
 }
 
 int aws_mutex_unlock(struct aws_mutex *mutex) {
+    AWS_PROBE1(mutex_unlock, mutex);
+
+    if (AWS_UNLIKELY(mutex->profile_acquired_at != 0)) {
+        aws_mutex_profile_record_unlock(mutex);
+    }
 
     return convert_and_raise_error_code(pthread_mutex_unlock(&mutex->mutex_handle));
 }
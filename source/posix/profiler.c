@@ -0,0 +1,564 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+/* for dladdr(), pthread_getattr_np() and the register names in ucontext_t. */
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <aws/common/profiler.h>
+#include <aws/common/array_list.h>
+#include <aws/common/atomics.h>
+#include <aws/common/private/profiler.h>
+
+/* the handler walks frame pointers out of the interrupted context, which is laid out differently on every target. */
+#if defined(__linux__) && (defined(__x86_64__) || defined(__i386__) || defined(__aarch64__))
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+/* only the kernel headers name this union member. */
+#if !defined(sigev_notify_thread_id)
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+/* the buffers of the current or last profile. The signal handler only ever touches these and the atomics below. */
+static struct {
+    struct aws_allocator *allocator;
+    size_t max_samples;
+    /* frames per sample. */
+    size_t stride;
+    void **frames;
+    int *depths;
+} profile;
+
+/* set while samples should be taken; the handler ignores signals that arrive when it isn't. */
+static struct aws_atomic_var sampling = AWS_ATOMIC_INIT_INT(0);
+/* handlers currently running, so stopping can wait for the last sample to be written. */
+static struct aws_atomic_var in_handler = AWS_ATOMIC_INIT_INT(0);
+/* slots ever claimed by the current profile, including those past max_samples. */
+static struct aws_atomic_var cursor = AWS_ATOMIC_INIT_INT(0);
+
+/* guards everything below, and the start and stop of a profile. */
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static int running = 0;
+static int handler_installed = 0;
+static struct timespec interval;
+
+/* the bounds of the calling thread's stack, so the handler never follows a frame pointer off it. Set by the thread
+ * itself before it can be sampled, so the handler never is the first to touch them. */
+static AWS_THREAD_LOCAL uintptr_t stack_bottom = 0;
+static AWS_THREAD_LOCAL uintptr_t stack_top = 0;
+
+struct thread_timer {
+    long tid;
+    timer_t timer;
+};
+
+/* a timer on the CPU clock of each sampled thread, delivering SIGPROF to that thread. */
+static struct aws_array_list timers;
+static int timers_initialized = 0;
+/* set by aws_profiler_register_current_thread(), so its timer goes when the thread does and the thread id can't be
+ * reused by a thread that would then look like it already had one. */
+static pthread_key_t exit_key;
+static int exit_key_created = 0;
+
+static void record_stack_bounds(void) {
+    if (stack_top) {
+        return;
+    }
+
+    pthread_attr_t attr;
+    void *address = NULL;
+    size_t size = 0;
+    if (pthread_getattr_np(pthread_self(), &attr)) {
+        return;
+    }
+    if (!pthread_attr_getstack(&attr, &address, &size)) {
+        stack_bottom = (uintptr_t)address;
+        stack_top = (uintptr_t)address + size;
+    }
+    pthread_attr_destroy(&attr);
+}
+
+/*
+ * Follows the chain of saved frame pointers up from the interrupted context, writing the interrupted address and then
+ * one return address per frame into frames. It only reads memory between the interrupted stack pointer and the top of
+ * the thread's stack, and each frame has to be above the last, so a function built without frame pointers (which may
+ * use the register for anything) ends the walk early rather than sending it astray. Only plain loads, so it is safe in
+ * a signal handler.
+ */
+static int walk_stack(const ucontext_t *context, void **frames, size_t max_frames) {
+#if defined(__x86_64__)
+    uintptr_t pc = (uintptr_t)context->uc_mcontext.gregs[REG_RIP];
+    uintptr_t fp = (uintptr_t)context->uc_mcontext.gregs[REG_RBP];
+    uintptr_t sp = (uintptr_t)context->uc_mcontext.gregs[REG_RSP];
+#elif defined(__i386__)
+    uintptr_t pc = (uintptr_t)context->uc_mcontext.gregs[REG_EIP];
+    uintptr_t fp = (uintptr_t)context->uc_mcontext.gregs[REG_EBP];
+    uintptr_t sp = (uintptr_t)context->uc_mcontext.gregs[REG_ESP];
+#else
+    uintptr_t pc = (uintptr_t)context->uc_mcontext.pc;
+    uintptr_t fp = (uintptr_t)context->uc_mcontext.regs[29];
+    uintptr_t sp = (uintptr_t)context->uc_mcontext.sp;
+#endif
+
+    size_t depth = 0;
+    frames[depth++] = (void *)pc;
+
+    /* on a stack of its own (e.g. a coroutine's), the frames aren't between sp and stack_top. */
+    if (sp < stack_bottom || sp >= stack_top) {
+        return (int)depth;
+    }
+
+    /* every target here keeps the caller's frame pointer at fp and the return address just above it. */
+    uintptr_t low = sp;
+    while (depth < max_frames && fp >= low && fp <= stack_top - 2 * sizeof(uintptr_t) &&
+            !(fp & (sizeof(uintptr_t) - 1))) {
+        const uintptr_t *frame = (const uintptr_t *)fp;
+        if (!frame[1]) {
+            break;
+        }
+        frames[depth++] = (void *)frame[1];
+        low = fp + 1;
+        fp = frame[0];
+    }
+
+    return (int)depth;
+}
+
+static void on_sigprof(int signal, siginfo_t *info, void *context) {
+    (void)signal;
+    (void)info;
+
+    int saved_errno = errno;
+    aws_atomic_fetch_add(&in_handler, 1);
+
+    if (aws_atomic_load_int(&sampling)) {
+        size_t index = aws_atomic_fetch_add(&cursor, 1);
+        if (index < profile.max_samples) {
+            profile.depths[index] = walk_stack((const ucontext_t *)context, profile.frames + index * profile.stride,
+                    profile.stride);
+        }
+    }
+
+    aws_atomic_fetch_sub(&in_handler, 1);
+    errno = saved_errno;
+}
+
+static long current_tid(void) {
+    return (long)syscall(SYS_gettid);
+}
+
+static size_t find_timer(long tid) {
+    size_t count = aws_array_list_length(&timers);
+    for (size_t i = 0; i < count; ++i) {
+        struct thread_timer *entry = NULL;
+        aws_array_list_get_at_ptr(&timers, (void **)&entry, i);
+        if (entry->tid == tid) {
+            return i;
+        }
+    }
+
+    return count;
+}
+
+/* starts sampling a thread, unless it already is. Called with the lock held. */
+static int add_thread_timer(pthread_t thread, long tid) {
+    if (find_timer(tid) < aws_array_list_length(&timers)) {
+        return AWS_OP_SUCCESS;
+    }
+
+    struct thread_timer entry = { .tid = tid };
+    clockid_t clock_id;
+    if (pthread_getcpuclockid(thread, &clock_id)) {
+        return aws_raise_error(AWS_ERROR_CLOCK_FAILURE);
+    }
+
+    struct sigevent event;
+    memset(&event, 0, sizeof(event));
+    event.sigev_notify = SIGEV_THREAD_ID;
+    event.sigev_signo = SIGPROF;
+    event.sigev_notify_thread_id = (pid_t)tid;
+    if (timer_create(clock_id, &event, &entry.timer)) {
+        return aws_raise_error(AWS_ERROR_CLOCK_FAILURE);
+    }
+
+    struct itimerspec spec = { .it_interval = interval, .it_value = interval };
+    if (timer_settime(entry.timer, 0, &spec, NULL) || aws_array_list_push_back(&timers, &entry)) {
+        timer_delete(entry.timer);
+        return aws_raise_error(AWS_ERROR_CLOCK_FAILURE);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static void remove_thread_timer(size_t index) {
+    size_t last = aws_array_list_length(&timers) - 1;
+    struct thread_timer *entry = NULL;
+    aws_array_list_get_at_ptr(&timers, (void **)&entry, index);
+    timer_delete(entry->timer);
+
+    if (index != last) {
+        aws_array_list_swap(&timers, index, last);
+    }
+    aws_array_list_pop_back(&timers);
+}
+
+static void add_registered_thread(pthread_t thread, long tid, void *user_data) {
+    int *err = (int *)user_data;
+    if (!*err) {
+        *err = add_thread_timer(thread, tid);
+    }
+}
+
+static void on_registered_thread_exit(void *value) {
+    (void)value;
+    aws_profiler_on_thread_exit();
+}
+
+static int start_timers(void) {
+    if (!exit_key_created) {
+        if (pthread_key_create(&exit_key, on_registered_thread_exit)) {
+            return aws_raise_error(AWS_ERROR_THREAD_INSUFFICIENT_RESOURCE);
+        }
+        exit_key_created = 1;
+    }
+
+    if (!timers_initialized) {
+        if (aws_array_list_init_dynamic(&timers, aws_default_allocator(), 8, sizeof(struct thread_timer))) {
+            return AWS_OP_ERR;
+        }
+        timers_initialized = 1;
+    }
+
+    int err = AWS_OP_SUCCESS;
+    aws_thread_registry_for_each(add_registered_thread, &err);
+    return err;
+}
+
+static void stop_timers(void) {
+    while (aws_array_list_length(&timers)) {
+        remove_thread_timer(aws_array_list_length(&timers) - 1);
+    }
+}
+
+static void release_samples(void) {
+    if (profile.frames) {
+        aws_mem_release(profile.allocator, profile.frames);
+        aws_mem_release(profile.allocator, profile.depths);
+        profile.frames = NULL;
+        profile.depths = NULL;
+    }
+    profile.max_samples = 0;
+}
+
+static int install_handler(void) {
+    if (handler_installed) {
+        return AWS_OP_SUCCESS;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = on_sigprof;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, NULL)) {
+        return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+    }
+
+    /* left installed for good: a SIGPROF already pending when the profiler stops must not reach the default action,
+     * which ends the process. */
+    handler_installed = 1;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_profiler_start(struct aws_allocator *allocator, const struct aws_profiler_options *options) {
+    if (!options->frequency_hz || options->frequency_hz > 1000000 || !options->max_samples || !options->max_depth ||
+            options->max_depth > (size_t)INT_MAX) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    size_t stride = options->max_depth;
+    if (options->max_samples > SIZE_MAX / sizeof(void *) / stride) {
+        return aws_raise_error(AWS_ERROR_INVALID_BUFFER_SIZE);
+    }
+
+    pthread_mutex_lock(&lock);
+    if (running) {
+        pthread_mutex_unlock(&lock);
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    release_samples();
+    profile.allocator = allocator;
+    profile.frames = (void **)aws_mem_acquire(allocator, options->max_samples * stride * sizeof(void *));
+    profile.depths = (int *)aws_mem_acquire(allocator, options->max_samples * sizeof(int));
+    if (!profile.frames || !profile.depths) {
+        if (profile.frames) {
+            aws_mem_release(allocator, profile.frames);
+        }
+        if (profile.depths) {
+            aws_mem_release(allocator, profile.depths);
+        }
+        profile.frames = NULL;
+        profile.depths = NULL;
+        pthread_mutex_unlock(&lock);
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
+    memset(profile.depths, 0, options->max_samples * sizeof(int));
+    profile.max_samples = options->max_samples;
+    profile.stride = stride;
+
+    uint64_t interval_ns = 1000000000 / options->frequency_hz;
+    interval.tv_sec = (time_t)(interval_ns / 1000000000);
+    interval.tv_nsec = (long)(interval_ns % 1000000000);
+
+    aws_atomic_store_int(&cursor, 0);
+    if (install_handler()) {
+        pthread_mutex_unlock(&lock);
+        return AWS_OP_ERR;
+    }
+
+    aws_atomic_store_int(&sampling, 1);
+    running = 1;
+    if (start_timers()) {
+        stop_timers();
+        aws_atomic_store_int(&sampling, 0);
+        running = 0;
+        pthread_mutex_unlock(&lock);
+        return AWS_OP_ERR;
+    }
+    pthread_mutex_unlock(&lock);
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_profiler_stop(void) {
+    pthread_mutex_lock(&lock);
+    if (!running) {
+        pthread_mutex_unlock(&lock);
+        return aws_raise_error(AWS_ERROR_INVALID_STATE);
+    }
+
+    stop_timers();
+    aws_atomic_store_int(&sampling, 0);
+    running = 0;
+    pthread_mutex_unlock(&lock);
+
+    /* a handler that saw sampling set may still be writing its sample. */
+    while (aws_atomic_load_int(&in_handler)) {
+        aws_atomic_cpu_relax();
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_profiler_register_current_thread(void) {
+    record_stack_bounds();
+
+    int err = AWS_OP_SUCCESS;
+    pthread_mutex_lock(&lock);
+    if (running) {
+        err = add_thread_timer(pthread_self(), current_tid());
+        if (!err) {
+            pthread_setspecific(exit_key, &exit_key);
+        }
+    }
+    pthread_mutex_unlock(&lock);
+
+    return err;
+}
+
+void aws_profiler_on_thread_start(void) {
+    /* a profile starting later gives this thread a timer from another thread, so the bounds are needed either way. */
+    record_stack_bounds();
+
+    /* a thread started while a profile runs is worth sampling, but not worth failing to start over. */
+    if (aws_atomic_load_int_explicit(&sampling, aws_memory_order_relaxed)) {
+        aws_profiler_register_current_thread();
+    }
+}
+
+void aws_profiler_on_thread_exit(void) {
+    pthread_mutex_lock(&lock);
+    if (timers_initialized) {
+        size_t index = find_timer(current_tid());
+        if (index < aws_array_list_length(&timers)) {
+            remove_thread_timer(index);
+        }
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+static size_t samples_taken(void) {
+    size_t taken = aws_atomic_load_int(&cursor);
+    return taken < profile.max_samples ? taken : profile.max_samples;
+}
+
+size_t aws_profiler_sample_count(void) {
+    return samples_taken();
+}
+
+size_t aws_profiler_dropped_count(void) {
+    return aws_atomic_load_int(&cursor) - samples_taken();
+}
+
+/* orders samples by their frames from the root down, so identical stacks end up next to each other. */
+static int compare_samples(const void *a, const void *b) {
+    size_t left = *(const size_t *)a;
+    size_t right = *(const size_t *)b;
+    void **left_frames = profile.frames + left * profile.stride;
+    void **right_frames = profile.frames + right * profile.stride;
+    int left_depth = profile.depths[left];
+    int right_depth = profile.depths[right];
+
+    while (left_depth > 0 && right_depth > 0) {
+        uintptr_t l = (uintptr_t)left_frames[--left_depth];
+        uintptr_t r = (uintptr_t)right_frames[--right_depth];
+        if (l != r) {
+            return l < r ? -1 : 1;
+        }
+    }
+
+    return (left_depth > right_depth) - (left_depth < right_depth);
+}
+
+static int same_stack(size_t left, size_t right) {
+    return !compare_samples(&left, &right);
+}
+
+static void write_frame(FILE *out, void *address, int interrupted) {
+    /* every frame but the interrupted one holds a return address, which may already belong to the next function. */
+    uintptr_t lookup = (uintptr_t)address - (interrupted ? 0 : 1);
+    Dl_info info;
+
+    if (!dladdr((void *)lookup, &info)) {
+        fprintf(out, "0x%lx", (unsigned long)lookup);
+    } else if (info.dli_sname) {
+        fputs(info.dli_sname, out);
+    } else {
+        const char *module = info.dli_fname ? strrchr(info.dli_fname, '/') : NULL;
+        module = module ? module + 1 : (info.dli_fname ? info.dli_fname : "");
+        fprintf(out, "%s+0x%lx", module, (unsigned long)(lookup - (uintptr_t)info.dli_fbase));
+    }
+}
+
+static void write_stack(FILE *out, size_t sample, size_t count) {
+    void **frames = profile.frames + sample * profile.stride;
+    int depth = profile.depths[sample];
+
+    if (depth <= 0) {
+        fputs("[unknown]", out);
+    }
+    for (int i = depth - 1; i >= 0; --i) {
+        write_frame(out, frames[i], i == 0);
+        if (i > 0) {
+            fputc(';', out);
+        }
+    }
+    fprintf(out, " %llu\n", (unsigned long long)count);
+}
+
+int aws_profiler_write_folded(FILE *out) {
+    pthread_mutex_lock(&lock);
+    size_t taken = running ? 0 : samples_taken();
+    if (!taken) {
+        pthread_mutex_unlock(&lock);
+        return AWS_OP_SUCCESS;
+    }
+
+    size_t *order = (size_t *)aws_mem_acquire(profile.allocator, taken * sizeof(size_t));
+    if (!order) {
+        pthread_mutex_unlock(&lock);
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
+    for (size_t i = 0; i < taken; ++i) {
+        order[i] = i;
+    }
+    qsort(order, taken, sizeof(size_t), compare_samples);
+
+    size_t run_start = 0;
+    for (size_t i = 1; i <= taken; ++i) {
+        if (i == taken || !same_stack(order[run_start], order[i])) {
+            write_stack(out, order[run_start], i - run_start);
+            run_start = i;
+        }
+    }
+
+    aws_mem_release(profile.allocator, order);
+    pthread_mutex_unlock(&lock);
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_profiler_clean_up(void) {
+    pthread_mutex_lock(&lock);
+    if (!running) {
+        release_samples();
+        aws_atomic_store_int(&cursor, 0);
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+#else
+
+int aws_profiler_start(struct aws_allocator *allocator, const struct aws_profiler_options *options) {
+    (void)allocator;
+    (void)options;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+int aws_profiler_stop(void) {
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+int aws_profiler_register_current_thread(void) {
+    return AWS_OP_SUCCESS;
+}
+
+void aws_profiler_on_thread_start(void) {
+}
+
+void aws_profiler_on_thread_exit(void) {
+}
+
+size_t aws_profiler_sample_count(void) {
+    return 0;
+}
+
+size_t aws_profiler_dropped_count(void) {
+    return 0;
+}
+
+int aws_profiler_write_folded(FILE *out) {
+    (void)out;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+void aws_profiler_clean_up(void) {
+}
+
+#endif /* __linux__ on x86, x86_64 or aarch64 */
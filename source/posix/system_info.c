@@ -0,0 +1,41 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+/* for sched_getcpu(). */
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include <aws/common/system_info.h>
+
+#include <unistd.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+size_t aws_system_info_processor_count(void) {
+    long count = sysconf(_SC_NPROCESSORS_CONF);
+    return count > 0 ? (size_t)count : 1;
+}
+
+int aws_system_info_current_cpu(void) {
+#if defined(__linux__)
+    /* glibc 2.35 and later answer this from the thread's rseq area without entering the kernel; older versions go
+     * through the vDSO. */
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
@@ -13,12 +13,33 @@
 * permissions and limitations under the License.
 */
 
+/* for RUSAGE_THREAD. */
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include <aws/common/thread.h>
+#include <aws/common/linked_list.h>
+#include <aws/common/trace.h>
+#include <aws/common/private/library_metrics.h>
+#include <aws/common/private/mutex_profile.h>
+#include <aws/common/private/profiler.h>
+#include <aws/common/private/trace.h>
+#include <aws/common/private/probes.h>
 
 #include <limits.h>
 #include <errno.h>
+#include <stdio.h>
 #include <time.h>
 #include <assert.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+
+#if defined(__linux__)
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 static struct aws_thread_options default_options = {
         /* this will make sure platform default stack size is used. */
@@ -31,11 +52,59 @@ struct thread_wrapper {
     void *arg;
 };
 
+/* every thread started by aws_thread_launch() is on this list while it runs. */
+struct registered_thread {
+    struct aws_linked_list_node node;
+    pthread_t thread_id;
+#if defined(__linux__)
+    pid_t tid;
+#endif
+};
+
+static struct aws_linked_list_node registry = { &registry, &registry };
+static pthread_mutex_t registry_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void register_thread(struct registered_thread *registration) {
+    registration->thread_id = pthread_self();
+#if defined(__linux__)
+    registration->tid = (pid_t)syscall(SYS_gettid);
+#endif
+
+    struct aws_linked_list_node *head = &registry;
+    pthread_mutex_lock(&registry_lock);
+    aws_linked_list_push_back(head, &registration->node);
+    pthread_mutex_unlock(&registry_lock);
+}
+
+static void unregister_thread(void *arg) {
+    struct registered_thread *registration = (struct registered_thread *)arg;
+
+    /* out of the registry first, so a profile starting meanwhile can't give the thread a timer nothing would delete. */
+    pthread_mutex_lock(&registry_lock);
+    aws_linked_list_remove(&registration->node);
+    pthread_mutex_unlock(&registry_lock);
+    aws_profiler_on_thread_exit();
+
+    aws_trace_on_thread_exit();
+    aws_mutex_profile_on_thread_exit();
+}
+
 static void *thread_fn(void *arg) {
     struct thread_wrapper wrapper = *(struct thread_wrapper *)arg;
     aws_mem_release(wrapper.allocator, arg);
 
+    struct registered_thread registration;
+    register_thread(&registration);
+    aws_profiler_on_thread_start();
+
+    /* unregister even if func ends the thread with pthread_exit(). */
+    pthread_cleanup_push(unregister_thread, &registration);
+    AWS_TRACE_BEGIN("aws_thread");
     wrapper.func(wrapper.arg);
+    AWS_TRACE_END("aws_thread");
+    AWS_PROBE1(thread_exit, registration.thread_id);
+    pthread_cleanup_pop(1);
+
     return NULL;
 }
 
@@ -99,6 +168,11 @@ int aws_thread_launch (struct aws_thread *thread, void(*func)(void *arg), void *
     }
 
     thread->detach_state = AWS_THREAD_JOINABLE;
+    AWS_PROBE1(thread_launch, thread->thread_id);
+
+    if (AWS_UNLIKELY(aws_library_metrics_active())) {
+        aws_library_metrics_increment(AWS_LIBRARY_METRIC_THREAD_LAUNCHES);
+    }
 
     cleanup:
     if(attributes_ptr) {
@@ -164,9 +238,143 @@ void aws_thread_current_sleep(uint64_t nanos) {
         .tv_sec = seconds,
         .tv_nsec = nano,
     };
-    struct timespec output;
 
-    nanosleep(&tm, &output);
+    /* on EINTR nanosleep leaves the time still to go in its second argument: sleep that off too. */
+    while (nanosleep(&tm, &tm) && errno == EINTR) {
+    }
+}
+
+int aws_thread_current_set_timer_slack(uint64_t slack_ns) {
+#if defined(__linux__)
+    if (slack_ns > ULONG_MAX) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (prctl(PR_SET_TIMERSLACK, (unsigned long)slack_ns, 0, 0, 0)) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    return AWS_OP_SUCCESS;
+#else
+    (void)slack_ns;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+#endif
+}
+
+static uint64_t timespec_to_ns(const struct timespec *ts) {
+    return (uint64_t)ts->tv_sec * 1000000000 + (uint64_t)ts->tv_nsec;
+}
+
+static int thread_cpu_time(pthread_t thread_id, uint64_t *cpu_time_ns) {
+#if defined(_POSIX_THREAD_CPUTIME) && _POSIX_THREAD_CPUTIME >= 0
+    clockid_t clock_id;
+    struct timespec ts;
+
+    if (pthread_getcpuclockid(thread_id, &clock_id) || clock_gettime(clock_id, &ts)) {
+        return aws_raise_error(AWS_ERROR_CLOCK_FAILURE);
+    }
+
+    *cpu_time_ns = timespec_to_ns(&ts);
+    return AWS_OP_SUCCESS;
+#else
+    (void)thread_id;
+    (void)cpu_time_ns;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+#endif
 }
 
+#if defined(__linux__)
+/* context switch counts of another thread of this process, from procfs. */
+static void read_task_switches(pid_t tid, struct aws_thread_stats *stats) {
+    char path[64];
+    char line[128];
+    unsigned long long value = 0;
+
+    snprintf(path, sizeof(path), "/proc/self/task/%d/status", (int)tid);
+    FILE *status = fopen(path, "r");
+    if (!status) {
+        return;
+    }
+
+    while (fgets(line, sizeof(line), status)) {
+        if (sscanf(line, "voluntary_ctxt_switches: %llu", &value) == 1) {
+            stats->voluntary_context_switches = value;
+        }
+        else if (sscanf(line, "nonvoluntary_ctxt_switches: %llu", &value) == 1) {
+            stats->involuntary_context_switches = value;
+        }
+    }
 
+    fclose(status);
+}
+#endif
+
+int aws_thread_cpu_time(struct aws_thread *thread, uint64_t *cpu_time_ns) {
+    if (thread->detach_state != AWS_THREAD_JOINABLE) {
+        return aws_raise_error(AWS_ERROR_THREAD_NO_SUCH_THREAD_ID);
+    }
+
+    return thread_cpu_time(thread->thread_id, cpu_time_ns);
+}
+
+int aws_thread_current_stats(struct aws_thread_stats *stats) {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts)) {
+        return aws_raise_error(AWS_ERROR_CLOCK_FAILURE);
+    }
+
+    stats->thread_id = aws_thread_current_thread_id();
+    stats->cpu_time_ns = timespec_to_ns(&ts);
+    stats->voluntary_context_switches = 0;
+    stats->involuntary_context_switches = 0;
+
+#if defined(RUSAGE_THREAD)
+    struct rusage usage;
+    if (!getrusage(RUSAGE_THREAD, &usage)) {
+        stats->voluntary_context_switches = (uint64_t)usage.ru_nvcsw;
+        stats->involuntary_context_switches = (uint64_t)usage.ru_nivcsw;
+    }
+#endif
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_thread_registry_get_stats(struct aws_array_list *stats) {
+    int err = AWS_OP_SUCCESS;
+    struct aws_linked_list_node *head = &registry;
+
+    /* threads unregister under the lock before exiting, so every pthread_t on the list is still valid. */
+    pthread_mutex_lock(&registry_lock);
+    for (struct aws_linked_list_node *node = head->next; node != head && !err; node = node->next) {
+        struct registered_thread *registration = aws_container_of(node, struct registered_thread, node);
+        struct aws_thread_stats entry = {
+            .thread_id = (uint64_t)registration->thread_id,
+        };
+
+        err = thread_cpu_time(registration->thread_id, &entry.cpu_time_ns);
+#if defined(__linux__)
+        read_task_switches(registration->tid, &entry);
+#endif
+        if (!err) {
+            err = aws_array_list_push_back(stats, &entry);
+        }
+    }
+    pthread_mutex_unlock(&registry_lock);
+
+    return err;
+}
+
+void aws_thread_registry_for_each(void (*fn)(pthread_t thread, long tid, void *user_data), void *user_data) {
+    struct aws_linked_list_node *head = &registry;
+
+    pthread_mutex_lock(&registry_lock);
+    for (struct aws_linked_list_node *node = head->next; node != head; node = node->next) {
+        struct registered_thread *registration = aws_container_of(node, struct registered_thread, node);
+#if defined(__linux__)
+        fn(registration->thread_id, (long)registration->tid, user_data);
+#else
+        fn(registration->thread_id, 0, user_data);
+#endif
+    }
+    pthread_mutex_unlock(&registry_lock);
+}
@@ -14,6 +14,7 @@
 */
 
 #include <aws/common/priority_queue.h>
+#include <aws/common/private/probes.h>
 #include <string.h>
 
 #define parent_of(index) (index & 1 ? index >> 1 : index > 1 ? (index - 2) >> 1 : 0)
@@ -96,6 +97,7 @@ int aws_priority_queue_push(struct aws_priority_queue *queue, void *item) {
     }
 
     sift_up(queue, aws_array_list_length(&queue->container) - 1);
+    AWS_PROBE2(priority_queue_push, queue, aws_array_list_length(&queue->container));
 
     return AWS_OP_SUCCESS;
 }
@@ -116,6 +118,7 @@ int aws_priority_queue_pop(struct aws_priority_queue *queue, void *item) {
     }
 
     sift_down(queue);
+    AWS_PROBE2(priority_queue_pop, queue, aws_array_list_length(&queue->container));
     return AWS_OP_SUCCESS;
 }
 
@@ -0,0 +1,267 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/rate_limiter.h>
+
+static const uint64_t NS_PER_SEC = 1000000000;
+
+static int limiter_setup(struct aws_rate_limiter *limiter, struct aws_clock *clock, uint64_t token_interval_ns,
+        size_t burst) {
+#if SIZE_MAX < UINT64_MAX
+    /* full_at would wrap a few seconds after the clock's epoch. */
+    (void)limiter;
+    (void)clock;
+    (void)token_interval_ns;
+    (void)burst;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+#else
+    if (!token_interval_ns || !burst || burst > UINT64_MAX / token_interval_ns) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    limiter->clock = clock ? clock : aws_high_res_clock();
+    limiter->token_interval_ns = token_interval_ns;
+    limiter->burst_ns = token_interval_ns * burst;
+    /* any time in the past means a full bucket. */
+    aws_atomic_init_int(&limiter->full_at, 0);
+
+    return AWS_OP_SUCCESS;
+#endif
+}
+
+/* the time it takes to earn n tokens, or UINT64_MAX if n is more than the bucket holds. */
+static uint64_t cost_of(const struct aws_rate_limiter *limiter, size_t n) {
+    if (n > limiter->burst_ns / limiter->token_interval_ns) {
+        return UINT64_MAX;
+    }
+
+    return n * limiter->token_interval_ns;
+}
+
+static int acquire_at(struct aws_rate_limiter *limiter, size_t n, uint64_t now) {
+    uint64_t cost = cost_of(limiter, n);
+    if (cost == UINT64_MAX) {
+        return aws_raise_error(AWS_ERROR_RATE_LIMIT_EXCEEDED);
+    }
+
+    /* the word only orders itself, there is no other data to publish, so relaxed is enough. */
+    size_t full_at = aws_atomic_load_int_explicit(&limiter->full_at, aws_memory_order_relaxed);
+    size_t next = 0;
+
+    do {
+        uint64_t start = full_at > now ? full_at : now;
+        if (start + cost - now > limiter->burst_ns) {
+            return aws_raise_error(AWS_ERROR_RATE_LIMIT_EXCEEDED);
+        }
+        next = (size_t)(start + cost);
+    } while (!aws_atomic_compare_exchange_int_explicit(&limiter->full_at, &full_at, next, aws_memory_order_relaxed,
+            aws_memory_order_relaxed));
+
+    return AWS_OP_SUCCESS;
+}
+
+/* takes up to n of the tokens available now, returning how many it took. */
+static size_t take_available(struct aws_rate_limiter *limiter, size_t n, uint64_t now) {
+    size_t full_at = aws_atomic_load_int_explicit(&limiter->full_at, aws_memory_order_relaxed);
+    size_t next = 0;
+    size_t taken = 0;
+
+    do {
+        uint64_t start = full_at > now ? full_at : now;
+        uint64_t available = start - now < limiter->burst_ns ?
+                (limiter->burst_ns - (start - now)) / limiter->token_interval_ns : 0;
+        taken = available < n ? (size_t)available : n;
+        if (!taken) {
+            return 0;
+        }
+        next = (size_t)(start + taken * limiter->token_interval_ns);
+    } while (!aws_atomic_compare_exchange_int_explicit(&limiter->full_at, &full_at, next, aws_memory_order_relaxed,
+            aws_memory_order_relaxed));
+
+    return taken;
+}
+
+/* puts back up to n tokens, as many as the bucket is short of full, returning how many it put back. */
+static size_t give_back(struct aws_rate_limiter *limiter, size_t n, uint64_t now) {
+    size_t full_at = aws_atomic_load_int_explicit(&limiter->full_at, aws_memory_order_relaxed);
+    size_t next = 0;
+    size_t given = 0;
+
+    do {
+        uint64_t missing = full_at > now ? (full_at - now) / limiter->token_interval_ns : 0;
+        given = missing < n ? (size_t)missing : n;
+        if (!given) {
+            return 0;
+        }
+        next = (size_t)(full_at - given * limiter->token_interval_ns);
+    } while (!aws_atomic_compare_exchange_int_explicit(&limiter->full_at, &full_at, next, aws_memory_order_relaxed,
+            aws_memory_order_relaxed));
+
+    return given;
+}
+
+static int wait_at(struct aws_rate_limiter *limiter, size_t n, uint64_t now, uint64_t *wait_ns) {
+    uint64_t cost = cost_of(limiter, n);
+    if (cost == UINT64_MAX) {
+        return aws_raise_error(AWS_ERROR_RATE_LIMIT_EXCEEDED);
+    }
+
+    uint64_t full_at = aws_atomic_load_int_explicit(&limiter->full_at, aws_memory_order_relaxed);
+    uint64_t ahead = (full_at > now ? full_at - now : 0) + cost;
+
+    *wait_ns = ahead > limiter->burst_ns ? ahead - limiter->burst_ns : 0;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_rate_limiter_init(struct aws_rate_limiter *limiter, const struct aws_rate_limiter_options *options) {
+    if (!options->tokens_per_second || options->tokens_per_second > NS_PER_SEC) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    uint64_t rate = options->tokens_per_second;
+    return limiter_setup(limiter, options->clock, (NS_PER_SEC + rate / 2) / rate, options->burst);
+}
+
+int aws_rate_limiter_try_acquire(struct aws_rate_limiter *limiter, size_t n) {
+    uint64_t now = 0;
+    if (aws_clock_get_ticks(limiter->clock, &now)) {
+        return AWS_OP_ERR;
+    }
+
+    return acquire_at(limiter, n, now);
+}
+
+int aws_rate_limiter_time_until_available(struct aws_rate_limiter *limiter, size_t n, uint64_t *wait_ns) {
+    uint64_t now = 0;
+    if (aws_clock_get_ticks(limiter->clock, &now)) {
+        return AWS_OP_ERR;
+    }
+
+    return wait_at(limiter, n, now, wait_ns);
+}
+
+int aws_sharded_rate_limiter_init(struct aws_sharded_rate_limiter *limiter, struct aws_allocator *allocator,
+        const struct aws_rate_limiter_options *options) {
+    if (!options->tokens_per_second || options->tokens_per_second > NS_PER_SEC || !options->burst) {
+        return aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+    }
+
+    if (aws_percpu_init(&limiter->shards, allocator, sizeof(struct aws_rate_limiter))) {
+        return AWS_OP_ERR;
+    }
+
+    /* no more shards than tokens in the burst, so that every shard holds at least one. Both are powers of two, so
+     * shard indexes can still be masked. */
+    size_t shards = aws_percpu_slot_count(&limiter->shards);
+    while (shards > options->burst) {
+        shards >>= 1;
+    }
+
+    limiter->clock = options->clock ? options->clock : aws_high_res_clock();
+    limiter->shard_count = shards;
+    limiter->burst = options->burst;
+    /* every shard earns tokens at 1/shards of the rate, so together they earn them at the full rate. */
+    uint64_t rate = options->tokens_per_second;
+    uint64_t token_interval_ns = (NS_PER_SEC * shards + rate / 2) / rate;
+
+    for (size_t i = 0; i < shards; ++i) {
+        /* the first burst % shards shards take the remainder, so the shares add up to the burst. */
+        size_t burst = options->burst / shards + (i < options->burst % shards);
+        if (limiter_setup((struct aws_rate_limiter *)aws_percpu_get(&limiter->shards, i), options->clock,
+                token_interval_ns, burst)) {
+            aws_percpu_clean_up(&limiter->shards);
+            return AWS_OP_ERR;
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_sharded_rate_limiter_clean_up(struct aws_sharded_rate_limiter *limiter) {
+    aws_percpu_clean_up(&limiter->shards);
+}
+
+int aws_sharded_rate_limiter_try_acquire(struct aws_sharded_rate_limiter *limiter, size_t n) {
+    uint64_t now = 0;
+    if (aws_clock_get_ticks(limiter->clock, &now)) {
+        return AWS_OP_ERR;
+    }
+
+    if (n > limiter->burst) {
+        return aws_raise_error(AWS_ERROR_RATE_LIMIT_EXCEEDED);
+    }
+
+    size_t shards = limiter->shard_count;
+    size_t first = aws_percpu_current_index();
+
+    /* our own shard first: it is the one nobody else is likely to be touching. */
+    for (size_t i = 0; i < shards; ++i) {
+        struct aws_rate_limiter *shard = (struct aws_rate_limiter *)aws_percpu_get(&limiter->shards,
+                (first + i) & (shards - 1));
+        if (!acquire_at(shard, n, now)) {
+            return AWS_OP_SUCCESS;
+        }
+    }
+
+    /* no single shard has n tokens, but together they might: gather them, and put them back if there aren't enough. */
+    size_t taken = 0;
+    for (size_t i = 0; i < shards && taken < n; ++i) {
+        taken += take_available((struct aws_rate_limiter *)aws_percpu_get(&limiter->shards,
+                (first + i) & (shards - 1)), n - taken, now);
+    }
+
+    if (taken == n) {
+        return AWS_OP_SUCCESS;
+    }
+
+    /* the tokens go back to whichever shards are short of them, and any that no longer fit (the shards earned some
+     * meanwhile) are dropped, so no more go back than were taken. */
+    for (size_t i = 0; i < shards && taken; ++i) {
+        taken -= give_back((struct aws_rate_limiter *)aws_percpu_get(&limiter->shards, (first + i) & (shards - 1)),
+                taken, now);
+    }
+
+    return aws_raise_error(AWS_ERROR_RATE_LIMIT_EXCEEDED);
+}
+
+int aws_sharded_rate_limiter_time_until_available(struct aws_sharded_rate_limiter *limiter, size_t n,
+        uint64_t *wait_ns) {
+    uint64_t now = 0;
+    if (aws_clock_get_ticks(limiter->clock, &now)) {
+        return AWS_OP_ERR;
+    }
+
+    if (n > limiter->burst) {
+        return aws_raise_error(AWS_ERROR_RATE_LIMIT_EXCEEDED);
+    }
+
+    /* the shortest wait for one shard to hold n tokens, or if none ever can, the longest wait for a shard to fill up,
+     * by which time all of them together hold the whole burst. */
+    uint64_t shortest = UINT64_MAX;
+    uint64_t until_full = 0;
+    for (size_t i = 0; i < limiter->shard_count; ++i) {
+        struct aws_rate_limiter *shard = (struct aws_rate_limiter *)aws_percpu_get(&limiter->shards, i);
+        uint64_t wait = 0;
+        if (!wait_at(shard, n, now, &wait) && wait < shortest) {
+            shortest = wait;
+        }
+        if (!wait_at(shard, (size_t)(shard->burst_ns / shard->token_interval_ns), now, &wait) && wait > until_full) {
+            until_full = wait;
+        }
+    }
+
+    *wait_ns = shortest != UINT64_MAX ? shortest : until_full;
+    return AWS_OP_SUCCESS;
+}
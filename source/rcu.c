@@ -0,0 +1,181 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/rcu.h>
+#include <aws/common/thread.h>
+#include <assert.h>
+#include <string.h>
+
+struct rcu_callback {
+    aws_rcu_callback fn;
+    void *object;
+    void *user_data;
+    size_t grace_period;
+};
+
+/* longest a writer sleeps between checks on its readers, in nanoseconds. */
+static const uint64_t MAX_SYNCHRONIZE_BACKOFF_NS = 1000000;
+
+int aws_rcu_domain_init(struct aws_rcu_domain *domain, struct aws_allocator *allocator) {
+    domain->allocator = allocator;
+    aws_atomic_init_int(&domain->grace_period, 1);
+    aws_linked_list_init(&domain->readers);
+
+    if (aws_mutex_init(&domain->lock, allocator)) {
+        return AWS_OP_ERR;
+    }
+
+    if (aws_array_list_init_dynamic(&domain->callbacks, allocator, 16, sizeof(struct rcu_callback))) {
+        aws_mutex_clean_up(&domain->lock);
+        return AWS_OP_ERR;
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_rcu_domain_clean_up(struct aws_rcu_domain *domain) {
+    assert(aws_linked_list_empty(&domain->readers));
+
+    /* with no readers left every grace period has elapsed. Callbacks may schedule more callbacks. */
+    while (aws_rcu_domain_poll(domain)) {
+    }
+
+    aws_array_list_clean_up(&domain->callbacks);
+    aws_mutex_clean_up(&domain->lock);
+}
+
+void aws_rcu_reader_register(struct aws_rcu_domain *domain, struct aws_rcu_reader *reader) {
+    reader->domain = domain;
+    aws_atomic_init_int(&reader->observed, 0);
+
+    aws_mutex_lock(&domain->lock);
+    struct aws_linked_list_node *head = &domain->readers;
+    aws_linked_list_push_back(head, &reader->node);
+    aws_mutex_unlock(&domain->lock);
+
+    aws_rcu_reader_online(reader);
+}
+
+void aws_rcu_reader_unregister(struct aws_rcu_reader *reader) {
+    struct aws_rcu_domain *domain = reader->domain;
+    aws_rcu_reader_offline(reader);
+
+    aws_mutex_lock(&domain->lock);
+    aws_linked_list_remove(&reader->node);
+    aws_mutex_unlock(&domain->lock);
+}
+
+void *aws_rcu_ptr_publish(struct aws_rcu_ptr *ptr, void *new_object) {
+    return aws_atomic_exchange_ptr_explicit(&ptr->ptr, new_object, aws_memory_order_acq_rel);
+}
+
+/* returns the newest grace period that every online reader has observed. Must be called with the lock held. */
+static size_t completed_grace_period(struct aws_rcu_domain *domain) {
+    size_t completed = aws_atomic_load_int_explicit(&domain->grace_period, aws_memory_order_acquire);
+
+    struct aws_linked_list_node *iter = domain->readers.next;
+    while (iter != &domain->readers) {
+        struct aws_rcu_reader *reader = aws_container_of(iter, struct aws_rcu_reader, node);
+        size_t observed = aws_atomic_load_int_explicit(&reader->observed, aws_memory_order_acquire);
+
+        if (observed && observed < completed) {
+            completed = observed;
+        }
+        iter = iter->next;
+    }
+
+    return completed;
+}
+
+/* starts a new grace period; anything unpublished before this call is unreachable once it completes. */
+static size_t start_grace_period(struct aws_rcu_domain *domain) {
+    return aws_atomic_fetch_add_explicit(&domain->grace_period, 1, aws_memory_order_seq_cst) + 1;
+}
+
+void aws_rcu_synchronize(struct aws_rcu_domain *domain) {
+    size_t target = start_grace_period(domain);
+    uint64_t backoff = 1000;
+
+    for (;;) {
+        aws_mutex_lock(&domain->lock);
+        size_t completed = completed_grace_period(domain);
+        aws_mutex_unlock(&domain->lock);
+
+        if (completed >= target) {
+            break;
+        }
+
+        aws_thread_current_sleep(backoff);
+        if (backoff < MAX_SYNCHRONIZE_BACKOFF_NS) {
+            backoff <<= 1;
+        }
+    }
+}
+
+int aws_rcu_call(struct aws_rcu_domain *domain, aws_rcu_callback fn, void *object, void *user_data) {
+    struct rcu_callback callback = {
+        .fn = fn,
+        .object = object,
+        .user_data = user_data,
+    };
+
+    aws_mutex_lock(&domain->lock);
+    /* started under the lock so the list stays sorted by grace period. */
+    callback.grace_period = start_grace_period(domain);
+    int err = aws_array_list_push_back(&domain->callbacks, &callback);
+    aws_mutex_unlock(&domain->lock);
+
+    return err;
+}
+
+size_t aws_rcu_domain_poll(struct aws_rcu_domain *domain) {
+    struct rcu_callback *ready = NULL;
+    size_t count = 0;
+
+    aws_mutex_lock(&domain->lock);
+    size_t completed = completed_grace_period(domain);
+    size_t length = aws_array_list_length(&domain->callbacks);
+
+    /* the list is sorted by grace period, so the callbacks that are due are a prefix of it. */
+    struct rcu_callback *callbacks = NULL;
+    if (length) {
+        aws_array_list_get_at_ptr(&domain->callbacks, (void **)&callbacks, 0);
+    }
+    while (count < length && callbacks[count].grace_period <= completed) {
+        count++;
+    }
+
+    /* copied out so the callbacks run without the lock, and may call aws_rcu_call() themselves. If the copy can't be
+     * allocated they stay queued for the next poll. */
+    if (count) {
+        ready = (struct rcu_callback *)aws_mem_acquire(domain->allocator, count * sizeof(struct rcu_callback));
+        if (ready) {
+            memcpy(ready, callbacks, count * sizeof(struct rcu_callback));
+            aws_array_list_pop_front_n(&domain->callbacks, count);
+        } else {
+            count = 0;
+        }
+    }
+    aws_mutex_unlock(&domain->lock);
+
+    for (size_t i = 0; i < count; ++i) {
+        ready[i].fn(ready[i].object, ready[i].user_data);
+    }
+
+    if (ready) {
+        aws_mem_release(domain->allocator, ready);
+    }
+    return count;
+}
@@ -0,0 +1,126 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/ref_count.h>
+#include <aws/common/thread.h>
+#include <assert.h>
+
+/* low bit of ref_count->shared: the owner count has been merged, so the shared count is the whole count. */
+static const size_t MERGED = 1;
+static const size_t ONE_REF = 2;
+
+void aws_ref_count_init(struct aws_ref_count *ref_count, struct aws_allocator *allocator, void *object,
+        aws_ref_count_destroy_fn destroy) {
+    ref_count->allocator = allocator;
+    ref_count->object = object;
+    ref_count->destroy = destroy;
+    aws_atomic_init_int(&ref_count->shared, ONE_REF | MERGED);
+    aws_atomic_init_int(&ref_count->weak, 1);
+    ref_count->biased = 0;
+    ref_count->owner_thread_id = 0;
+    ref_count->is_biased = 0;
+}
+
+void aws_ref_count_init_biased(struct aws_ref_count *ref_count, struct aws_allocator *allocator, void *object,
+        aws_ref_count_destroy_fn destroy) {
+    aws_ref_count_init(ref_count, allocator, object, destroy);
+    aws_atomic_init_int(&ref_count->shared, 0);
+    ref_count->biased = 1;
+    ref_count->owner_thread_id = aws_thread_current_thread_id();
+    ref_count->is_biased = 1;
+}
+
+/* only the owner ever reads biased, so the id check must come first. */
+static int is_owner_with_count(const struct aws_ref_count *ref_count) {
+    return ref_count->is_biased && ref_count->owner_thread_id == aws_thread_current_thread_id() && ref_count->biased;
+}
+
+static void destroy_object(struct aws_ref_count *ref_count) {
+    if (ref_count->destroy) {
+        ref_count->destroy(ref_count->object);
+    }
+
+    /* drop the weak reference the strong references held collectively. */
+    aws_ref_count_release_weak(ref_count);
+}
+
+void aws_ref_count_acquire(struct aws_ref_count *ref_count) {
+    if (is_owner_with_count(ref_count)) {
+        ref_count->biased++;
+        return;
+    }
+
+    aws_atomic_fetch_add_explicit(&ref_count->shared, ONE_REF, aws_memory_order_relaxed);
+}
+
+/* folds the owner count into the shared count; the object is destroyed here if that leaves no references. */
+static void merge(struct aws_ref_count *ref_count) {
+    size_t add = (ref_count->biased * ONE_REF) | MERGED;
+    ref_count->biased = 0;
+
+    size_t shared = aws_atomic_fetch_add_explicit(&ref_count->shared, add, aws_memory_order_acq_rel) + add;
+    if (shared == MERGED) {
+        destroy_object(ref_count);
+    }
+}
+
+void aws_ref_count_release(struct aws_ref_count *ref_count) {
+    if (is_owner_with_count(ref_count)) {
+        if (--ref_count->biased == 0) {
+            merge(ref_count);
+        }
+        return;
+    }
+
+    size_t shared = aws_atomic_fetch_sub_explicit(&ref_count->shared, ONE_REF, aws_memory_order_acq_rel) - ONE_REF;
+    /* before the merge the shared count can reach zero, or go below it, while the owner still holds references. */
+    if (shared == MERGED) {
+        destroy_object(ref_count);
+    }
+}
+
+void aws_ref_count_unbias(struct aws_ref_count *ref_count) {
+    if (!ref_count->is_biased || ref_count->owner_thread_id != aws_thread_current_thread_id() || !ref_count->biased) {
+        return;
+    }
+
+    merge(ref_count);
+}
+
+void aws_ref_count_acquire_weak(struct aws_ref_count *ref_count) {
+    aws_atomic_fetch_add_explicit(&ref_count->weak, 1, aws_memory_order_relaxed);
+}
+
+void aws_ref_count_release_weak(struct aws_ref_count *ref_count) {
+    if (aws_atomic_fetch_sub_explicit(&ref_count->weak, 1, aws_memory_order_acq_rel) == 1 && ref_count->allocator) {
+        aws_mem_release(ref_count->allocator, ref_count->object);
+    }
+}
+
+int aws_ref_count_try_upgrade(struct aws_ref_count *ref_count) {
+    size_t shared = aws_atomic_load_int_explicit(&ref_count->shared, aws_memory_order_relaxed);
+
+    for (;;) {
+        /* unmerged means the owner still holds a reference; merged with a zero count means it's gone for good. */
+        if (shared == MERGED) {
+            return 0;
+        }
+
+        if (aws_atomic_compare_exchange_int_explicit(&ref_count->shared, &shared, shared + ONE_REF,
+                aws_memory_order_acquire, aws_memory_order_relaxed)) {
+            return 1;
+        }
+    }
+}
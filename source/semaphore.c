@@ -0,0 +1,83 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/semaphore.h>
+#include <aws/common/private/futex.h>
+
+void aws_semaphore_init(struct aws_semaphore *semaphore, size_t initial_count) {
+    aws_atomic_init_int(&semaphore->count, initial_count);
+    aws_atomic_init_int(&semaphore->sleepers, 0);
+}
+
+static int take_permit(struct aws_semaphore *semaphore) {
+    size_t count = aws_atomic_load_int_explicit(&semaphore->count, aws_memory_order_relaxed);
+
+    while (count) {
+        if (aws_atomic_compare_exchange_int_explicit(&semaphore->count, &count, count - 1, aws_memory_order_acquire,
+                aws_memory_order_relaxed)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int acquire_until(struct aws_semaphore *semaphore, uint64_t deadline) {
+    for (;;) {
+        if (take_permit(semaphore)) {
+            return AWS_OP_SUCCESS;
+        }
+
+        if (aws_futex_spin(&semaphore->count, 0)) {
+            continue;
+        }
+
+        /* announce ourselves before the final check; aws_semaphore_release() does the mirror image. */
+        aws_atomic_fetch_add_explicit(&semaphore->sleepers, 1, aws_memory_order_seq_cst);
+        int err = AWS_OP_SUCCESS;
+        if (!aws_atomic_load_int_explicit(&semaphore->count, aws_memory_order_seq_cst)) {
+            err = aws_futex_wait(&semaphore->count, 0, deadline);
+        }
+        aws_atomic_fetch_sub_explicit(&semaphore->sleepers, 1, aws_memory_order_relaxed);
+
+        if (err) {
+            return AWS_OP_ERR;
+        }
+    }
+}
+
+int aws_semaphore_acquire(struct aws_semaphore *semaphore) {
+    return acquire_until(semaphore, AWS_FUTEX_WAIT_FOREVER);
+}
+
+int aws_semaphore_try_acquire(struct aws_semaphore *semaphore) {
+    if (take_permit(semaphore)) {
+        return AWS_OP_SUCCESS;
+    }
+
+    return aws_raise_error(AWS_ERROR_WAIT_TIMEOUT);
+}
+
+int aws_semaphore_acquire_timeout(struct aws_semaphore *semaphore, uint64_t timeout_ns) {
+    return acquire_until(semaphore, aws_futex_deadline(timeout_ns));
+}
+
+void aws_semaphore_release(struct aws_semaphore *semaphore, size_t count) {
+    aws_atomic_fetch_add_explicit(&semaphore->count, count, aws_memory_order_seq_cst);
+
+    if (aws_atomic_load_int_explicit(&semaphore->sleepers, aws_memory_order_seq_cst)) {
+        aws_futex_wake(&semaphore->count, count);
+    }
+}
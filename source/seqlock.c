@@ -0,0 +1,60 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/seqlock.h>
+#include <string.h>
+
+void aws_seqlock_init(struct aws_seqlock *lock) {
+    aws_atomic_init_int(&lock->sequence, 0);
+}
+
+void aws_seqlock_write_begin(struct aws_seqlock *lock) {
+    size_t seq = aws_atomic_load_int_explicit(&lock->sequence, aws_memory_order_relaxed);
+
+    for (;;) {
+        /* acquire pairs with the previous writer's release in aws_seqlock_write_end(), so its record updates happen
+         * before ours. */
+        if (!(seq & 1) && aws_atomic_compare_exchange_int_explicit(&lock->sequence, &seq, seq + 1,
+                aws_memory_order_acquire, aws_memory_order_relaxed)) {
+            break;
+        }
+
+        aws_atomic_cpu_relax();
+        seq = aws_atomic_load_int_explicit(&lock->sequence, aws_memory_order_relaxed);
+    }
+
+    /* the odd sequence must be visible before any of the writes to the record. */
+    aws_atomic_thread_fence(aws_memory_order_release);
+}
+
+void aws_seqlock_write_end(struct aws_seqlock *lock) {
+    size_t seq = aws_atomic_load_int_explicit(&lock->sequence, aws_memory_order_relaxed);
+    aws_atomic_store_int_explicit(&lock->sequence, seq + 1, aws_memory_order_release);
+}
+
+void aws_seqlock_write(struct aws_seqlock *lock, void *payload, const void *src, size_t size) {
+    aws_seqlock_write_begin(lock);
+    memcpy(payload, src, size);
+    aws_seqlock_write_end(lock);
+}
+
+void aws_seqlock_read(const struct aws_seqlock *lock, void *dest, const void *payload, size_t size) {
+    size_t seq;
+
+    do {
+        seq = aws_seqlock_read_begin(lock);
+        memcpy(dest, payload, size);
+    } while (aws_seqlock_read_retry(lock, seq));
+}
@@ -0,0 +1,45 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/thread.h>
+#include <aws/common/atomics.h>
+#include <aws/common/clock.h>
+
+int aws_thread_sleep_until(uint64_t deadline) {
+    uint64_t now = 0;
+
+    /* sleep in a loop: the OS may wake us early (a coarse timer, a signal), in which case we go back to sleep. */
+    for (;;) {
+        if (aws_high_res_clock_get_ticks(&now)) {
+            return AWS_OP_ERR;
+        }
+        if (now >= deadline) {
+            return AWS_OP_SUCCESS;
+        }
+        if (deadline - now <= AWS_THREAD_SLEEP_SPIN_NS) {
+            break;
+        }
+        aws_thread_current_sleep(deadline - now - AWS_THREAD_SLEEP_SPIN_NS);
+    }
+
+    while (now < deadline) {
+        aws_atomic_cpu_relax();
+        if (aws_high_res_clock_get_ticks(&now)) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
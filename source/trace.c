@@ -0,0 +1,220 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/private/trace.h>
+#include <aws/common/atomics.h>
+#include <aws/common/clock.h>
+#include <aws/common/thread.h>
+#include <inttypes.h>
+#include <string.h>
+
+struct trace_buffer {
+    struct trace_buffer *next;
+    /* non-zero while a thread owns the buffer. */
+    struct aws_atomic_var in_use;
+    uint64_t thread_id;
+    /* events ever recorded, and events ever started (one ahead of head while one is being written). Only the owning
+     * thread writes either. */
+    struct aws_atomic_var head;
+    struct aws_atomic_var claimed;
+    struct aws_trace_event events[AWS_TRACE_BUFFER_EVENTS];
+};
+
+static struct aws_atomic_var trace_flag = AWS_ATOMIC_INIT_INT(0);
+
+/* every buffer ever allocated, pushed once and never removed, so the events outlive the threads that recorded them.
+ * A thread started by aws_thread_launch() gives its buffer up as it exits, and the next thread to record an event
+ * takes it over, so the events stay collectable until the new owner overwrites them. */
+static struct aws_atomic_var buffers = AWS_ATOMIC_INIT_PTR(NULL);
+static AWS_THREAD_LOCAL struct trace_buffer *thread_buffer = NULL;
+
+void aws_trace_set_enabled(int enabled) {
+    aws_atomic_store_int(&trace_flag, enabled ? 1 : 0);
+}
+
+int aws_trace_enabled(void) {
+    return aws_atomic_load_int_explicit(&trace_flag, aws_memory_order_relaxed) != 0;
+}
+
+static struct trace_buffer *get_thread_buffer(void) {
+    if (AWS_LIKELY(thread_buffer != NULL)) {
+        return thread_buffer;
+    }
+
+    struct trace_buffer *buffer = (struct trace_buffer *)aws_atomic_load_ptr_explicit(&buffers,
+            aws_memory_order_acquire);
+    for (; buffer; buffer = buffer->next) {
+        size_t unused = 0;
+        /* acquire pairs with the release in aws_trace_on_thread_exit(), so the previous owner's writes are done. */
+        if (aws_atomic_compare_exchange_int_explicit(&buffer->in_use, &unused, 1, aws_memory_order_acquire,
+                aws_memory_order_relaxed)) {
+            buffer->thread_id = aws_thread_current_thread_id();
+            thread_buffer = buffer;
+            return buffer;
+        }
+    }
+
+    buffer = (struct trace_buffer *)aws_mem_acquire(aws_default_allocator(), sizeof(struct trace_buffer));
+    if (!buffer) {
+        return NULL;
+    }
+    memset(buffer, 0, sizeof(struct trace_buffer));
+    buffer->thread_id = aws_thread_current_thread_id();
+    aws_atomic_init_int(&buffer->in_use, 1);
+    aws_atomic_init_int(&buffer->head, 0);
+    aws_atomic_init_int(&buffer->claimed, 0);
+
+    void *head = aws_atomic_load_ptr_explicit(&buffers, aws_memory_order_relaxed);
+    do {
+        buffer->next = (struct trace_buffer *)head;
+    } while (!aws_atomic_compare_exchange_ptr_explicit(&buffers, &head, buffer, aws_memory_order_release,
+            aws_memory_order_relaxed));
+
+    thread_buffer = buffer;
+    return buffer;
+}
+
+void aws_trace_record(enum aws_trace_event_type type, const char *name, uint64_t arg) {
+    if (AWS_LIKELY(!aws_trace_enabled())) {
+        return;
+    }
+
+    uint64_t now = 0;
+    struct trace_buffer *buffer = get_thread_buffer();
+    if (!buffer || aws_high_res_clock_get_ticks(&now)) {
+        return;
+    }
+
+    size_t head = aws_atomic_load_int_explicit(&buffer->head, aws_memory_order_relaxed);
+    aws_atomic_store_int_explicit(&buffer->claimed, head + 1, aws_memory_order_relaxed);
+    aws_atomic_thread_fence(aws_memory_order_release);
+
+    struct aws_trace_event *event = &buffer->events[head & (AWS_TRACE_BUFFER_EVENTS - 1)];
+    event->timestamp = now;
+    event->thread_id = buffer->thread_id;
+    event->name = name;
+    event->arg = arg;
+    event->type = type;
+    aws_atomic_store_int_explicit(&buffer->head, head + 1, aws_memory_order_release);
+}
+
+void aws_trace_on_thread_exit(void) {
+    if (thread_buffer) {
+        aws_atomic_store_int_explicit(&thread_buffer->in_use, 0, aws_memory_order_release);
+        thread_buffer = NULL;
+    }
+}
+
+/* appends the events buffer still holds to events. */
+static int collect_buffer(struct trace_buffer *buffer, struct aws_trace_event *scratch,
+        struct aws_array_list *events) {
+    size_t end = aws_atomic_load_int_explicit(&buffer->head, aws_memory_order_acquire);
+    size_t start = end > AWS_TRACE_BUFFER_EVENTS ? end - AWS_TRACE_BUFFER_EVENTS : 0;
+
+    for (size_t i = start; i < end; ++i) {
+        scratch[i - start] = buffer->events[i & (AWS_TRACE_BUFFER_EVENTS - 1)];
+    }
+
+    /* the owner may have lapped us while we copied: anything in a slot it has since started reusing may be torn. */
+    aws_atomic_thread_fence(aws_memory_order_acquire);
+    size_t claimed = aws_atomic_load_int_explicit(&buffer->claimed, aws_memory_order_relaxed);
+    size_t first_intact = claimed > AWS_TRACE_BUFFER_EVENTS ? claimed - AWS_TRACE_BUFFER_EVENTS : 0;
+
+    for (size_t i = start > first_intact ? start : first_intact; i < end; ++i) {
+        if (aws_array_list_push_back(events, &scratch[i - start])) {
+            return AWS_OP_ERR;
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_trace_collect(struct aws_allocator *allocator, struct aws_array_list *events) {
+    if (aws_array_list_init_dynamic(events, allocator, 64, sizeof(struct aws_trace_event))) {
+        return AWS_OP_ERR;
+    }
+
+    struct aws_trace_event *scratch = (struct aws_trace_event *)aws_mem_acquire(allocator,
+            sizeof(struct aws_trace_event) * AWS_TRACE_BUFFER_EVENTS);
+    if (!scratch) {
+        aws_array_list_clean_up(events);
+        return aws_raise_error(AWS_ERROR_OOM);
+    }
+
+    int err = AWS_OP_SUCCESS;
+    struct trace_buffer *buffer = (struct trace_buffer *)aws_atomic_load_ptr_explicit(&buffers,
+            aws_memory_order_acquire);
+    for (; buffer && !err; buffer = buffer->next) {
+        err = collect_buffer(buffer, scratch, events);
+    }
+
+    aws_mem_release(allocator, scratch);
+    if (err) {
+        aws_array_list_clean_up(events);
+    }
+
+    return err;
+}
+
+static void write_json_string(FILE *out, const char *str) {
+    fputc('"', out);
+    for (; *str; ++str) {
+        unsigned char c = (unsigned char)*str;
+        if (c == '"' || c == '\\') {
+            fputc('\\', out);
+            fputc(c, out);
+        }
+        else if (c < 0x20) {
+            fprintf(out, "\\u%04x", c);
+        }
+        else {
+            fputc(c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+int aws_trace_write_chrome_json(FILE *out, const struct aws_array_list *events) {
+    static const char *phases[] = { "B", "E", "i" };
+    size_t count = aws_array_list_length(events);
+
+    fprintf(out, "{\"traceEvents\":[");
+    for (size_t i = 0; i < count; ++i) {
+        struct aws_trace_event *event = NULL;
+        aws_array_list_get_at_ptr(events, (void **)&event, i);
+
+        fprintf(out, "%s\n{\"name\":", i ? "," : "");
+        write_json_string(out, event->name);
+        /* timestamps are in microseconds. */
+        fprintf(out, ",\"ph\":\"%s\",\"ts\":%" PRIu64 ".%03u,\"pid\":1,\"tid\":%" PRIu64, phases[event->type],
+                event->timestamp / 1000, (unsigned)(event->timestamp % 1000), event->thread_id);
+        if (event->type == AWS_TRACE_EVENT_INSTANT) {
+            fprintf(out, ",\"s\":\"t\",\"args\":{\"value\":%" PRIu64 "}", event->arg);
+        }
+        fputc('}', out);
+    }
+    fprintf(out, "\n]}\n");
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_trace_reset(void) {
+    struct trace_buffer *buffer = (struct trace_buffer *)aws_atomic_load_ptr_explicit(&buffers,
+            aws_memory_order_acquire);
+    for (; buffer; buffer = buffer->next) {
+        aws_atomic_store_int_explicit(&buffer->head, 0, aws_memory_order_relaxed);
+        aws_atomic_store_int_explicit(&buffer->claimed, 0, aws_memory_order_relaxed);
+    }
+}
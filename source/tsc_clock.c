@@ -0,0 +1,267 @@
+/*
+* Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file. This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied. See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/tsc_clock.h>
+#include <aws/common/atomics.h>
+#include <aws/common/once.h>
+#include <aws/common/seqlock.h>
+#include <aws/common/thread.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#endif
+
+/* ns = base_ns + (((tsc - base_tsc) * mult) >> shift), with mult < 2^32. */
+struct tsc_calibration {
+    uint64_t base_tsc;
+    uint64_t base_ns;
+    uint64_t mult;
+    uint64_t shift;
+    /* a TSC and high res clock pair read together: the start of the window the next recalibration measures over. */
+    uint64_t sample_tsc;
+    uint64_t sample_ns;
+    uint64_t recalibrate_at_tsc;
+};
+
+static struct aws_seqlock calibration_lock = AWS_SEQLOCK_INIT;
+static struct tsc_calibration calibration;
+static struct aws_atomic_var calibrated = AWS_ATOMIC_INIT_INT(0);
+static struct aws_atomic_var recalibrating = AWS_ATOMIC_INIT_INT(0);
+static struct aws_once init_once = AWS_ONCE_INIT;
+static int init_error;
+
+int aws_tsc_clock_is_supported(void) {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+        return 0;
+    }
+    /* EDX bit 8: invariant TSC. */
+    return (edx >> 8) & 1;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int registers[4];
+    __cpuid(registers, 0x80000000);
+    if ((unsigned int)registers[0] < 0x80000007) {
+        return 0;
+    }
+    __cpuid(registers, 0x80000007);
+    return (registers[3] >> 8) & 1;
+#else
+    return 0;
+#endif
+}
+
+/* reads the TSC and the high res clock together, keeping the attempt where the clock read took the fewest ticks. */
+static int sample(uint64_t *tsc, uint64_t *ns) {
+    uint64_t best_window = UINT64_MAX;
+
+    for (int i = 0; i < 5; ++i) {
+        uint64_t now = 0;
+        uint64_t before = aws_tsc_read();
+        if (aws_high_res_clock_get_ticks(&now)) {
+            return AWS_OP_ERR;
+        }
+        uint64_t after = aws_tsc_read();
+
+        if (after - before < best_window) {
+            best_window = after - before;
+            *tsc = before + best_window / 2;
+            *ns = now;
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+/* shrinks a ratio until both terms fit in 32 bits, so they can be multiplied by another 32 bit value. */
+static void reduce(uint64_t *numerator, uint64_t *denominator) {
+    while (*numerator > UINT32_MAX || *denominator > UINT32_MAX) {
+        *numerator >>= 1;
+        *denominator >>= 1;
+    }
+}
+
+/* picks mult and shift so that (tsc_window * mult) >> shift is ns_window, as precisely as fits in 32 bits. */
+static void compute_scale(struct tsc_calibration *scale, uint64_t tsc_window, uint64_t ns_window) {
+    reduce(&ns_window, &tsc_window);
+    if (!tsc_window) {
+        tsc_window = 1;
+    }
+
+    scale->shift = 32;
+    scale->mult = (ns_window << scale->shift) / tsc_window;
+    while (scale->mult > UINT32_MAX) {
+        scale->shift--;
+        scale->mult = (ns_window << scale->shift) / tsc_window;
+    }
+}
+
+static uint64_t convert(const struct tsc_calibration *scale, uint64_t tsc_delta) {
+    /* split the multiply so it can't overflow. */
+    uint64_t high = tsc_delta >> 32;
+    uint64_t low = tsc_delta & UINT32_MAX;
+    return ((high * scale->mult) << (32 - scale->shift)) + ((low * scale->mult) >> scale->shift);
+}
+
+static uint64_t ticks_per_interval(uint64_t tsc_window, uint64_t ns_window, uint64_t interval_ns) {
+    reduce(&tsc_window, &ns_window);
+    return ns_window ? tsc_window * interval_ns / ns_window : UINT32_MAX;
+}
+
+static void calibrate(void *user_data) {
+    int *error = (int *)user_data;
+
+    if (!aws_tsc_clock_is_supported()) {
+        *error = AWS_ERROR_UNSUPPORTED_OPERATION;
+        return;
+    }
+
+    uint64_t start_tsc = 0, start_ns = 0, end_tsc = 0, end_ns = 0;
+    if (sample(&start_tsc, &start_ns)) {
+        *error = aws_last_error();
+        return;
+    }
+    aws_thread_current_sleep(10000000);
+    if (sample(&end_tsc, &end_ns)) {
+        *error = aws_last_error();
+        return;
+    }
+    if (end_tsc <= start_tsc || end_ns <= start_ns) {
+        *error = AWS_ERROR_CLOCK_FAILURE;
+        return;
+    }
+
+    struct tsc_calibration initial;
+    compute_scale(&initial, end_tsc - start_tsc, end_ns - start_ns);
+    initial.base_tsc = end_tsc;
+    initial.base_ns = end_ns;
+    initial.sample_tsc = start_tsc;
+    initial.sample_ns = start_ns;
+    initial.recalibrate_at_tsc =
+            end_tsc + ticks_per_interval(end_tsc - start_tsc, end_ns - start_ns, AWS_TSC_RECALIBRATE_NS);
+
+    aws_seqlock_write(&calibration_lock, &calibration, &initial, sizeof(initial));
+    aws_atomic_store_int_explicit(&calibrated, 1, aws_memory_order_release);
+}
+
+/*
+ * Measures the TSC rate over the (much longer) window since the last sample. Rather than stepping the clock to the
+ * high res clock's reading, which could step it backwards, the new rate is skewed so that the two converge by the
+ * next recalibration.
+ */
+static void recalibrate(void) {
+    uint64_t tsc = 0, ns = 0;
+    if (sample(&tsc, &ns)) {
+        return;
+    }
+
+    /* only the thread holding recalibrating writes the record, so it can read it without the lock. */
+    struct tsc_calibration current = calibration;
+    struct tsc_calibration next = current;
+    if (tsc <= current.sample_tsc || ns <= current.sample_ns) {
+        return;
+    }
+
+    uint64_t continuous_ns = current.base_ns + convert(&current, tsc - current.base_tsc);
+    uint64_t interval_tsc = ticks_per_interval(tsc - current.sample_tsc, ns - current.sample_ns,
+            AWS_TSC_RECALIBRATE_NS);
+    const uint64_t interval_ns = AWS_TSC_RECALIBRATE_NS;
+
+    if (continuous_ns >= ns && continuous_ns - ns < interval_ns / 2) {
+        /* ahead: run slow. */
+        compute_scale(&next, interval_tsc, interval_ns - (continuous_ns - ns));
+    }
+    else if (continuous_ns < ns && ns - continuous_ns < interval_ns / 2) {
+        /* behind: run fast. */
+        compute_scale(&next, interval_tsc, interval_ns + (ns - continuous_ns));
+    }
+    else {
+        /* too far off to slew: jump forward if behind, otherwise hold at the measured rate. */
+        compute_scale(&next, tsc - current.sample_tsc, ns - current.sample_ns);
+        continuous_ns = continuous_ns > ns ? continuous_ns : ns;
+    }
+
+    next.base_tsc = tsc;
+    next.base_ns = continuous_ns;
+    next.sample_tsc = tsc;
+    next.sample_ns = ns;
+    next.recalibrate_at_tsc = tsc + interval_tsc;
+
+    aws_seqlock_write(&calibration_lock, &calibration, &next, sizeof(next));
+}
+
+int aws_tsc_clock_init(void) {
+    aws_call_once(&init_once, calibrate, &init_error);
+
+    if (init_error) {
+        return aws_raise_error(init_error);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+int aws_tsc_clock_get_ticks(uint64_t *timestamp) {
+    if (!aws_atomic_load_int_explicit(&calibrated, aws_memory_order_acquire)) {
+        return aws_high_res_clock_get_ticks(timestamp);
+    }
+
+    struct tsc_calibration current;
+    uint64_t tsc = 0;
+    size_t seq = 0;
+    do {
+        seq = aws_seqlock_read_begin(&calibration_lock);
+        current = calibration;
+        tsc = aws_tsc_read();
+    } while (aws_seqlock_read_retry(&calibration_lock, seq));
+
+    /* rdtsc isn't ordered, so it can land just before a concurrent recalibration's base. */
+    uint64_t delta = tsc > current.base_tsc ? tsc - current.base_tsc : 0;
+    *timestamp = current.base_ns + convert(&current, delta);
+
+    if (AWS_UNLIKELY(tsc >= current.recalibrate_at_tsc)) {
+        size_t expected = 0;
+        if (aws_atomic_compare_exchange_int_explicit(&recalibrating, &expected, 1, aws_memory_order_acquire,
+                aws_memory_order_relaxed)) {
+            recalibrate();
+            aws_atomic_store_int_explicit(&recalibrating, 0, aws_memory_order_release);
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+uint64_t aws_tsc_to_ns(uint64_t tsc_delta) {
+    if (!aws_atomic_load_int_explicit(&calibrated, aws_memory_order_acquire)) {
+        return tsc_delta;
+    }
+
+    struct tsc_calibration current;
+    aws_seqlock_read(&calibration_lock, &current, &calibration, sizeof(current));
+    return convert(&current, tsc_delta);
+}
+
+static int clock_get_ticks(struct aws_clock *clock, uint64_t *timestamp) {
+    (void)clock;
+    return aws_tsc_clock_get_ticks(timestamp);
+}
+
+static struct aws_clock clock_instance = {
+    .get_ticks = clock_get_ticks,
+    .impl = NULL,
+};
+
+struct aws_clock *aws_tsc_clock(void) {
+    return &clock_instance;
+}
@@ -14,6 +14,7 @@
 */
 
 #include <aws/common/clock.h>
+#include <aws/common/private/coarse_clock.h>
 #include <Windows.h>
 
 static const uint64_t MUS_PER_SEC = 1000000;
@@ -47,3 +48,33 @@ int aws_sys_clock_get_ticks(uint64_t *timestamp) {
     *timestamp = (int_conv.QuadPart - (WINDOWS_TICK * EC_TO_UNIX_EPOCH)) * FILE_TIME_TO_NS;
     return AWS_OP_SUCCESS;
 }
+
+int aws_coarse_clock_os_get_ticks(uint64_t *timestamp) {
+    /* milliseconds, updated every scheduler tick. */
+    *timestamp = (uint64_t)GetTickCount64() * NS_PER_MUS * 1000;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_coarse_sys_clock_os_get_ticks(uint64_t *timestamp) {
+    FILETIME ticks;
+    /* unlike GetSystemTimePreciseAsFileTime(), this only reads the time as of the last tick. */
+    GetSystemTimeAsFileTime(&ticks);
+
+    ULARGE_INTEGER int_conv;
+    int_conv.LowPart = ticks.dwLowDateTime;
+    int_conv.HighPart = ticks.dwHighDateTime;
+
+    *timestamp = (int_conv.QuadPart - (WINDOWS_TICK * EC_TO_UNIX_EPOCH)) * FILE_TIME_TO_NS;
+    return AWS_OP_SUCCESS;
+}
+
+uint64_t aws_coarse_clock_os_resolution(void) {
+    DWORD adjustment = 0, increment = 0;
+    BOOL disabled = FALSE;
+    /* the increment is the clock interrupt period, in 100ns units. */
+    if (!GetSystemTimeAdjustment(&adjustment, &increment, &disabled)) {
+        return 15625000;
+    }
+
+    return (uint64_t)increment * FILE_TIME_TO_NS;
+}
@@ -0,0 +1,48 @@
+/*
+* Copyright 2010 - 2018 Amazon.com, Inc. or its affiliates.All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file.This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied.See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/private/futex.h>
+#include <Windows.h>
+
+static const uint64_t NS_PER_MS = 1000000;
+
+int aws_futex_wait(struct aws_atomic_var *var, size_t expected, uint64_t deadline) {
+    uint64_t remaining = 0;
+    if (aws_futex_remaining(deadline, &remaining)) {
+        return AWS_OP_ERR;
+    }
+
+    DWORD timeout_ms = INFINITE;
+    if (remaining != AWS_FUTEX_WAIT_FOREVER) {
+        /* round up, so we never wake before the deadline and spin on a zero timeout. */
+        uint64_t ms = (remaining + NS_PER_MS - 1) / NS_PER_MS;
+        timeout_ms = ms >= INFINITE ? INFINITE - 1 : (DWORD)ms;
+    }
+
+    if (!WaitOnAddress(&var->value, &expected, sizeof(expected), timeout_ms) && GetLastError() == ERROR_TIMEOUT) {
+        return aws_raise_error(AWS_ERROR_WAIT_TIMEOUT);
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+void aws_futex_wake(struct aws_atomic_var *var, size_t count) {
+    if (count == 1) {
+        WakeByAddressSingle(&var->value);
+    }
+    else {
+        WakeByAddressAll(&var->value);
+    }
+}
@@ -0,0 +1,48 @@
+/*
+* Copyright 2010 - 2018 Amazon.com, Inc. or its affiliates.All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file.This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied.See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/profiler.h>
+
+/* SIGPROF and backtrace() have no direct equivalents here; ETW based profilers cover this use on Windows. */
+
+int aws_profiler_start(struct aws_allocator *allocator, const struct aws_profiler_options *options) {
+    (void)allocator;
+    (void)options;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+int aws_profiler_stop(void) {
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+int aws_profiler_register_current_thread(void) {
+    return AWS_OP_SUCCESS;
+}
+
+size_t aws_profiler_sample_count(void) {
+    return 0;
+}
+
+size_t aws_profiler_dropped_count(void) {
+    return 0;
+}
+
+int aws_profiler_write_folded(FILE *out) {
+    (void)out;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+void aws_profiler_clean_up(void) {
+}
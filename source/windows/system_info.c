@@ -0,0 +1,26 @@
+/*
+* Copyright 2010 - 2018 Amazon.com, Inc. or its affiliates.All Rights Reserved.
+*
+* Licensed under the Apache License, Version 2.0 (the "License").
+* You may not use this file except in compliance with the License.
+* A copy of the License is located at
+*
+*  http://aws.amazon.com/apache2.0
+*
+* or in the "license" file accompanying this file.This file is distributed
+* on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+* express or implied.See the License for the specific language governing
+* permissions and limitations under the License.
+*/
+
+#include <aws/common/system_info.h>
+#include <Windows.h>
+
+size_t aws_system_info_processor_count(void) {
+    DWORD count = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+    return count ? (size_t)count : 1;
+}
+
+int aws_system_info_current_cpu(void) {
+    return (int)GetCurrentProcessorNumber();
+}
@@ -14,6 +14,12 @@
 */
 
 #include <aws/common/thread.h>
+#include <aws/common/linked_list.h>
+#include <aws/common/trace.h>
+#include <aws/common/private/library_metrics.h>
+#include <aws/common/private/mutex_profile.h>
+#include <aws/common/private/probes.h>
+#include <aws/common/private/trace.h>
 #include <assert.h>
 
 static struct aws_thread_options default_options = {
@@ -27,10 +33,37 @@ struct thread_wrapper {
     void *arg;
 };
 
+/* every thread started by aws_thread_launch() is on this list while it runs. */
+struct registered_thread {
+    struct aws_linked_list_node node;
+    DWORD thread_id;
+};
+
+static struct aws_linked_list_node registry = { &registry, &registry };
+static SRWLOCK registry_lock = SRWLOCK_INIT;
+
 static DWORD WINAPI thread_wrapper_fn(LPVOID arg) {
     struct thread_wrapper thread_wrapper = *(struct thread_wrapper *)arg;
     aws_mem_release(thread_wrapper.allocator, (void *)arg);
+
+    struct registered_thread registration;
+    registration.thread_id = GetCurrentThreadId();
+    struct aws_linked_list_node *head = &registry;
+    AcquireSRWLockExclusive(&registry_lock);
+    aws_linked_list_push_back(head, &registration.node);
+    ReleaseSRWLockExclusive(&registry_lock);
+
+    AWS_TRACE_BEGIN("aws_thread");
     thread_wrapper.func(thread_wrapper.arg);
+    AWS_TRACE_END("aws_thread");
+    AWS_PROBE1(thread_exit, registration.thread_id);
+
+    AcquireSRWLockExclusive(&registry_lock);
+    aws_linked_list_remove(&registration.node);
+    ReleaseSRWLockExclusive(&registry_lock);
+
+    aws_trace_on_thread_exit();
+    aws_mutex_profile_on_thread_exit();
     return 0;
 }
 
@@ -66,6 +99,12 @@ int aws_thread_launch(struct aws_thread *thread, void(*func)(void *arg), void *a
     }
 
     thread->detach_state = AWS_THREAD_JOINABLE;
+    AWS_PROBE1(thread_launch, thread->thread_id);
+
+    if (AWS_UNLIKELY(aws_library_metrics_active())) {
+        aws_library_metrics_increment(AWS_LIBRARY_METRIC_THREAD_LAUNCHES);
+    }
+
     return AWS_OP_SUCCESS;
 }
 
@@ -101,3 +140,66 @@ void aws_thread_current_sleep(uint64_t nanos) {
      * put the effort in here. */
     Sleep((DWORD)(nanos / 1000000));
 }
+
+int aws_thread_current_set_timer_slack(uint64_t slack_ns) {
+    (void)slack_ns;
+    return aws_raise_error(AWS_ERROR_UNSUPPORTED_OPERATION);
+}
+
+/* windows doesn't count context switches per thread in any documented API, so those stay zero. */
+static int thread_cpu_time(HANDLE thread_handle, uint64_t *cpu_time_ns) {
+    FILETIME creation_time, exit_time, kernel_time, user_time;
+    if (!GetThreadTimes(thread_handle, &creation_time, &exit_time, &kernel_time, &user_time)) {
+        return aws_raise_error(AWS_ERROR_CLOCK_FAILURE);
+    }
+
+    uint64_t kernel = ((uint64_t)kernel_time.dwHighDateTime << 32) | kernel_time.dwLowDateTime;
+    uint64_t user = ((uint64_t)user_time.dwHighDateTime << 32) | user_time.dwLowDateTime;
+    /* FILETIME counts 100ns intervals. */
+    *cpu_time_ns = (kernel + user) * 100;
+    return AWS_OP_SUCCESS;
+}
+
+int aws_thread_cpu_time(struct aws_thread *thread, uint64_t *cpu_time_ns) {
+    if (thread->detach_state != AWS_THREAD_JOINABLE) {
+        return aws_raise_error(AWS_ERROR_THREAD_NO_SUCH_THREAD_ID);
+    }
+
+    return thread_cpu_time(thread->thread_handle, cpu_time_ns);
+}
+
+int aws_thread_current_stats(struct aws_thread_stats *stats) {
+    stats->thread_id = aws_thread_current_thread_id();
+    stats->voluntary_context_switches = 0;
+    stats->involuntary_context_switches = 0;
+    return thread_cpu_time(GetCurrentThread(), &stats->cpu_time_ns);
+}
+
+int aws_thread_registry_get_stats(struct aws_array_list *stats) {
+    int err = AWS_OP_SUCCESS;
+    struct aws_linked_list_node *head = &registry;
+
+    /* threads unregister under the lock before exiting, so every thread on the list is still running. */
+    AcquireSRWLockShared(&registry_lock);
+    for (struct aws_linked_list_node *node = head->next; node != head && !err; node = node->next) {
+        struct registered_thread *registration = aws_container_of(node, struct registered_thread, node);
+        struct aws_thread_stats entry = {
+            .thread_id = registration->thread_id,
+        };
+
+        HANDLE thread_handle = OpenThread(THREAD_QUERY_LIMITED_INFORMATION, FALSE, registration->thread_id);
+        if (!thread_handle) {
+            err = aws_raise_error(AWS_ERROR_THREAD_NO_SUCH_THREAD_ID);
+            break;
+        }
+        err = thread_cpu_time(thread_handle, &entry.cpu_time_ns);
+        CloseHandle(thread_handle);
+
+        if (!err) {
+            err = aws_array_list_push_back(stats, &entry);
+        }
+    }
+    ReleaseSRWLockShared(&registry_lock);
+
+    return err;
+}
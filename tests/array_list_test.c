@@ -66,6 +66,33 @@ static int array_list_order_push_back_pop_front_fn(struct aws_allocator *alloc,
 
 AWS_TEST_CASE(array_list_order_push_back_pop_front_test, array_list_order_push_back_pop_front_fn)
 
+static int array_list_pop_front_n_fn(struct aws_allocator *alloc, void *ctx) {
+    struct aws_array_list list;
+    ASSERT_SUCCESS(aws_array_list_init_dynamic(&list, alloc, 4, sizeof(int)), "List setup failed with error code %d", aws_last_error());
+
+    for (int i = 1; i <= 5; ++i) {
+        ASSERT_SUCCESS(aws_array_list_push_back(&list, (void *)&i), "List push failed with error code %d", aws_last_error());
+    }
+
+    ASSERT_ERROR(AWS_ERROR_INVALID_INDEX, aws_array_list_pop_front_n(&list, 6), "Popping more than the list holds should fail.");
+    ASSERT_INT_EQUALS(5, list.length, "A failed pop should leave the list alone.");
+
+    int item;
+    ASSERT_SUCCESS(aws_array_list_pop_front_n(&list, 3), "List pop front n failed with error code %d", aws_last_error());
+    ASSERT_INT_EQUALS(2, list.length, "List size should be 2.");
+    ASSERT_SUCCESS(aws_array_list_front(&list, (void *)&item), "List front failed with error code %d", aws_last_error());
+    ASSERT_INT_EQUALS(4, item, "Item should have been the fourth item.");
+
+    ASSERT_SUCCESS(aws_array_list_pop_front_n(&list, 2), "List pop front n failed with error code %d", aws_last_error());
+    ASSERT_INT_EQUALS(0, list.length, "List should be empty.");
+
+    aws_array_list_clean_up(&list);
+
+    return 0;
+}
+
+AWS_TEST_CASE(array_list_pop_front_n_test, array_list_pop_front_n_fn)
+
 static int array_list_order_push_back_pop_back_fn(struct aws_allocator *alloc, void *ctx) {
     struct aws_array_list list;
 
@@ -0,0 +1,109 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/atomics.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+
+static int test_atomics_semantics(struct aws_allocator *allocator, void *ctx) {
+    struct aws_atomic_var var;
+    aws_atomic_init_int(&var, 10);
+
+    ASSERT_INT_EQUALS(10, aws_atomic_load_int(&var), "init_int should set the value");
+    aws_atomic_store_int_explicit(&var, 20, aws_memory_order_release);
+    ASSERT_INT_EQUALS(20, aws_atomic_load_int_explicit(&var, aws_memory_order_acquire), "store should set the value");
+    ASSERT_INT_EQUALS(20, aws_atomic_exchange_int(&var, 30), "exchange should return the old value");
+    ASSERT_INT_EQUALS(30, aws_atomic_load_int(&var), "exchange should set the new value");
+
+    size_t expected = 31;
+    ASSERT_FALSE(aws_atomic_compare_exchange_int(&var, &expected, 40), "compare_exchange should fail on a mismatch");
+    ASSERT_INT_EQUALS(30, expected, "a failed compare_exchange should load the current value");
+    ASSERT_TRUE(aws_atomic_compare_exchange_int(&var, &expected, 40), "compare_exchange should succeed on a match");
+    ASSERT_INT_EQUALS(40, aws_atomic_load_int(&var), "compare_exchange should set the new value");
+
+    ASSERT_INT_EQUALS(40, aws_atomic_fetch_add(&var, 2), "fetch_add should return the old value");
+    ASSERT_INT_EQUALS(42, aws_atomic_fetch_sub(&var, 10), "fetch_sub should return the old value");
+    ASSERT_INT_EQUALS(32, aws_atomic_fetch_or(&var, 0x0F), "fetch_or should return the old value");
+    ASSERT_INT_EQUALS(0x2F, aws_atomic_fetch_and(&var, 0x0C), "fetch_and should return the old value");
+    ASSERT_INT_EQUALS(0x0C, aws_atomic_fetch_xor(&var, 0x05), "fetch_xor should return the old value");
+    ASSERT_INT_EQUALS(0x09, aws_atomic_load_int_explicit(&var, aws_memory_order_relaxed), "bitwise ops produced the wrong value");
+
+    int first = 0, second = 0;
+    struct aws_atomic_var ptr_var = AWS_ATOMIC_INIT_PTR(&first);
+    ASSERT_PTR_EQUALS(&first, aws_atomic_load_ptr(&ptr_var), "static init should set the pointer");
+    ASSERT_PTR_EQUALS(&first, aws_atomic_exchange_ptr(&ptr_var, &second), "exchange should return the old pointer");
+
+    void *expected_ptr = &first;
+    ASSERT_FALSE(aws_atomic_compare_exchange_ptr(&ptr_var, &expected_ptr, NULL), "compare_exchange should fail on a mismatch");
+    ASSERT_PTR_EQUALS(&second, expected_ptr, "a failed compare_exchange should load the current pointer");
+    ASSERT_TRUE(aws_atomic_compare_exchange_ptr_explicit(&ptr_var, &expected_ptr, &first, aws_memory_order_acq_rel,
+        aws_memory_order_acquire), "compare_exchange should succeed on a match");
+    aws_atomic_store_ptr(&ptr_var, NULL);
+    ASSERT_NULL(aws_atomic_load_ptr(&ptr_var), "store should set the pointer");
+
+    aws_atomic_thread_fence(aws_memory_order_seq_cst);
+    aws_atomic_cpu_relax();
+
+    return 0;
+}
+
+#define ATOMICS_TEST_THREADS 4
+#define ATOMICS_TEST_ITERATIONS 100000
+
+struct atomics_thread_data {
+    struct aws_atomic_var counter;
+    struct aws_atomic_var cas_counter;
+};
+
+static void atomics_thread_fn(void *arg) {
+    struct atomics_thread_data *data = (struct atomics_thread_data *)arg;
+
+    for (int i = 0; i < ATOMICS_TEST_ITERATIONS; ++i) {
+        aws_atomic_fetch_add_explicit(&data->counter, 1, aws_memory_order_relaxed);
+
+        size_t expected = aws_atomic_load_int_explicit(&data->cas_counter, aws_memory_order_relaxed);
+        while (!aws_atomic_compare_exchange_int_explicit(&data->cas_counter, &expected, expected + 1,
+                aws_memory_order_relaxed, aws_memory_order_relaxed)) {
+            aws_atomic_cpu_relax();
+        }
+    }
+}
+
+static int test_atomics_concurrent_increments(struct aws_allocator *allocator, void *ctx) {
+    struct atomics_thread_data data;
+    aws_atomic_init_int(&data.counter, 0);
+    aws_atomic_init_int(&data.cas_counter, 0);
+
+    struct aws_thread threads[ATOMICS_TEST_THREADS];
+    for (int i = 0; i < ATOMICS_TEST_THREADS; ++i) {
+        aws_thread_init(&threads[i], allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], atomics_thread_fn, &data, 0), "thread creation failed");
+    }
+
+    for (int i = 0; i < ATOMICS_TEST_THREADS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]), "thread join failed");
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    ASSERT_INT_EQUALS(ATOMICS_TEST_THREADS * ATOMICS_TEST_ITERATIONS, aws_atomic_load_int(&data.counter),
+                      "fetch_add lost increments");
+    ASSERT_INT_EQUALS(ATOMICS_TEST_THREADS * ATOMICS_TEST_ITERATIONS, aws_atomic_load_int(&data.cas_counter),
+                      "compare_exchange lost increments");
+
+    return 0;
+}
+
+AWS_TEST_CASE(atomics_semantics_test, test_atomics_semantics)
+AWS_TEST_CASE(atomics_concurrent_increments_test, test_atomics_concurrent_increments)
@@ -0,0 +1,78 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/barrier.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+
+#define BARRIER_TEST_THREADS 4
+#define BARRIER_TEST_PHASES 2000
+
+struct barrier_test_data {
+    struct aws_barrier barrier;
+    struct aws_atomic_var arrivals;
+    struct aws_atomic_var serial;
+    struct aws_atomic_var failed;
+};
+
+static void barrier_thread_fn(void *arg) {
+    struct barrier_test_data *data = (struct barrier_test_data *)arg;
+
+    for (size_t phase = 1; phase <= BARRIER_TEST_PHASES; ++phase) {
+        aws_atomic_fetch_add(&data->arrivals, 1);
+
+        if (aws_barrier_wait(&data->barrier)) {
+            aws_atomic_fetch_add(&data->serial, 1);
+        }
+
+        /* every thread has arrived for this phase, and nobody can be more than one phase ahead. */
+        size_t arrivals = aws_atomic_load_int(&data->arrivals);
+        if (arrivals < phase * BARRIER_TEST_THREADS || arrivals >= (phase + 1) * BARRIER_TEST_THREADS) {
+            aws_atomic_store_int(&data->failed, 1);
+        }
+
+        if (phase % 500 == 0) {
+            /* give the others time to fall asleep, so the wake up path gets exercised too. */
+            aws_thread_current_sleep(1000000);
+        }
+    }
+}
+
+static int test_barrier_phases(struct aws_allocator *allocator, void *ctx) {
+    struct barrier_test_data data;
+    aws_barrier_init(&data.barrier, BARRIER_TEST_THREADS);
+    aws_atomic_init_int(&data.arrivals, 0);
+    aws_atomic_init_int(&data.serial, 0);
+    aws_atomic_init_int(&data.failed, 0);
+
+    struct aws_thread threads[BARRIER_TEST_THREADS];
+    for (int i = 0; i < BARRIER_TEST_THREADS; ++i) {
+        aws_thread_init(&threads[i], allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], barrier_thread_fn, &data, 0), "thread creation failed");
+    }
+
+    for (int i = 0; i < BARRIER_TEST_THREADS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]), "thread join failed");
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    ASSERT_INT_EQUALS(0, aws_atomic_load_int(&data.failed), "a thread got through the barrier too early");
+    ASSERT_INT_EQUALS(BARRIER_TEST_PHASES, aws_atomic_load_int(&data.serial),
+                      "exactly one thread per phase should be told it was last");
+
+    return 0;
+}
+
+AWS_TEST_CASE(barrier_phases_test, test_barrier_phases)
@@ -0,0 +1,146 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+/*
+ * Measures aws_channel throughput with several batching producers and consumers, and reports the hardware counters of
+ * every thread involved. Run by hand; ctest doesn't.
+ */
+
+#include <aws/common/channel.h>
+#include <aws/common/clock.h>
+#include <aws/common/mutex.h>
+#include <aws/common/perf_counters.h>
+#include <aws/common/thread.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CHANNEL_BENCH_PRODUCERS 2
+#define CHANNEL_BENCH_CONSUMERS 2
+#define CHANNEL_BENCH_ITEMS (1 << 19)
+#define CHANNEL_BENCH_BATCH 64
+
+struct channel_bench_data {
+    struct aws_channel channel;
+    struct aws_atomic_var received;
+    struct aws_atomic_var sum;
+    /* every producer's and consumer's counters, added up. */
+    struct aws_mutex counters_lock;
+    struct aws_perf_counter_values counters;
+};
+
+static void channel_bench_add_counters(struct channel_bench_data *data, struct aws_perf_counters *counters) {
+    struct aws_perf_counter_values values;
+    aws_perf_counters_stop(counters, &values);
+    aws_perf_counters_clean_up(counters);
+
+    aws_mutex_lock(&data->counters_lock);
+    aws_perf_counter_values_add(&data->counters, &values);
+    aws_mutex_unlock(&data->counters_lock);
+}
+
+static void channel_bench_producer_fn(void *arg) {
+    struct channel_bench_data *data = (struct channel_bench_data *)arg;
+    uint64_t batch[CHANNEL_BENCH_BATCH];
+    struct aws_perf_counters counters;
+    aws_perf_counters_init(&counters);
+    aws_perf_counters_start(&counters);
+
+    for (size_t i = 0; i < CHANNEL_BENCH_ITEMS; i += CHANNEL_BENCH_BATCH) {
+        for (size_t j = 0; j < CHANNEL_BENCH_BATCH; ++j) {
+            batch[j] = i + j + 1;
+        }
+        aws_channel_send_n(&data->channel, batch, CHANNEL_BENCH_BATCH, NULL);
+    }
+
+    channel_bench_add_counters(data, &counters);
+}
+
+static void channel_bench_consumer_fn(void *arg) {
+    struct channel_bench_data *data = (struct channel_bench_data *)arg;
+    uint64_t batch[CHANNEL_BENCH_BATCH];
+    size_t received = 0;
+    struct aws_perf_counters counters;
+    aws_perf_counters_init(&counters);
+    aws_perf_counters_start(&counters);
+
+    while (!aws_channel_recv_n(&data->channel, batch, CHANNEL_BENCH_BATCH, &received)) {
+        size_t sum = 0;
+        for (size_t i = 0; i < received; ++i) {
+            sum += (size_t)batch[i];
+        }
+        aws_atomic_fetch_add(&data->sum, sum);
+        aws_atomic_fetch_add(&data->received, received);
+    }
+
+    channel_bench_add_counters(data, &counters);
+}
+
+int main(void) {
+    struct aws_allocator *allocator = aws_default_allocator();
+    struct channel_bench_data data;
+    if (aws_channel_init(&data.channel, allocator, sizeof(uint64_t), 1024) ||
+            aws_mutex_init(&data.counters_lock, allocator)) {
+        fprintf(stderr, "channel benchmark: setup failed: %s\n", aws_error_debug_str(aws_last_error()));
+        return 1;
+    }
+    aws_atomic_init_int(&data.received, 0);
+    aws_atomic_init_int(&data.sum, 0);
+    memset(&data.counters, 0, sizeof(data.counters));
+    data.counters.available = AWS_PERF_COUNTER_ALL;
+
+    uint64_t start = 0, end = 0;
+    aws_high_res_clock_get_ticks(&start);
+
+    struct aws_thread producers[CHANNEL_BENCH_PRODUCERS];
+    struct aws_thread consumers[CHANNEL_BENCH_CONSUMERS];
+    for (int i = 0; i < CHANNEL_BENCH_CONSUMERS; ++i) {
+        aws_thread_init(&consumers[i], allocator);
+        aws_thread_launch(&consumers[i], channel_bench_consumer_fn, &data, 0);
+    }
+    for (int i = 0; i < CHANNEL_BENCH_PRODUCERS; ++i) {
+        aws_thread_init(&producers[i], allocator);
+        aws_thread_launch(&producers[i], channel_bench_producer_fn, &data, 0);
+    }
+
+    for (int i = 0; i < CHANNEL_BENCH_PRODUCERS; ++i) {
+        aws_thread_join(&producers[i]);
+        aws_thread_clean_up(&producers[i]);
+    }
+    aws_channel_close(&data.channel);
+    for (int i = 0; i < CHANNEL_BENCH_CONSUMERS; ++i) {
+        aws_thread_join(&consumers[i]);
+        aws_thread_clean_up(&consumers[i]);
+    }
+
+    aws_high_res_clock_get_ticks(&end);
+
+    int result = 0;
+    size_t total = (size_t)CHANNEL_BENCH_PRODUCERS * CHANNEL_BENCH_ITEMS;
+    size_t sum = CHANNEL_BENCH_PRODUCERS * ((size_t)CHANNEL_BENCH_ITEMS * (CHANNEL_BENCH_ITEMS + 1) / 2);
+    if (aws_atomic_load_int(&data.received) != total || aws_atomic_load_int(&data.sum) != sum) {
+        fprintf(stderr, "channel benchmark: items were lost or duplicated\n");
+        result = 1;
+    }
+
+    double seconds = (double)(end - start) / 1e9;
+    fprintf(stdout, "channel throughput: %.0f items/s (%d producers, %d consumers, batches of %d)\n",
+            (double)total / seconds, CHANNEL_BENCH_PRODUCERS, CHANNEL_BENCH_CONSUMERS, CHANNEL_BENCH_BATCH);
+    fprintf(stdout, "channel counters: ");
+    aws_perf_counter_values_write_summary(stdout, &data.counters);
+
+    aws_mutex_clean_up(&data.counters_lock);
+    aws_channel_clean_up(&data.channel);
+    return result;
+}
@@ -0,0 +1,174 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/channel.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+
+static int test_channel_send_recv(struct aws_allocator *allocator, void *ctx) {
+    struct aws_channel channel;
+    ASSERT_SUCCESS(aws_channel_init(&channel, allocator, sizeof(int), 4), "init failed");
+
+    int value = 0;
+    ASSERT_ERROR(AWS_ERROR_CHANNEL_EMPTY, aws_channel_try_recv(&channel, &value), "a new channel should be empty");
+    ASSERT_ERROR(AWS_ERROR_WAIT_TIMEOUT, aws_channel_recv_timeout(&channel, &value, 1000000),
+                 "receiving from an empty channel should time out");
+
+    /* go around the ring a few times. */
+    int next_sent = 0, next_received = 0;
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_SUCCESS(aws_channel_try_send(&channel, &next_sent), "send failed");
+            next_sent++;
+        }
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_SUCCESS(aws_channel_recv(&channel, &value), "recv failed");
+            ASSERT_INT_EQUALS(next_received++, value, "elements should come out in order");
+        }
+    }
+
+    int batch[6] = { 10, 11, 12, 13, 14, 15 };
+    size_t moved = 0;
+    ASSERT_SUCCESS(aws_channel_send_n(&channel, batch, 4, &moved), "send_n failed");
+    ASSERT_INT_EQUALS(4, moved, "every element should be sent");
+    ASSERT_ERROR(AWS_ERROR_CHANNEL_FULL, aws_channel_try_send(&channel, &value), "the channel should be full");
+    ASSERT_ERROR(AWS_ERROR_WAIT_TIMEOUT, aws_channel_send_timeout(&channel, &value, 1000000),
+                 "sending to a full channel should time out");
+
+    int out[6] = { 0 };
+    ASSERT_SUCCESS(aws_channel_recv_n(&channel, out, 6, &moved), "recv_n failed");
+    ASSERT_INT_EQUALS(4, moved, "recv_n should take what is there");
+    ASSERT_INT_EQUALS(10, out[0], "elements should come out in order");
+    ASSERT_INT_EQUALS(13, out[3], "elements should come out in order");
+
+    /* closing lets receivers drain what is left. */
+    ASSERT_SUCCESS(aws_channel_send(&channel, &batch[4]), "send failed");
+    aws_channel_close(&channel);
+    ASSERT_ERROR(AWS_ERROR_CHANNEL_CLOSED, aws_channel_send(&channel, &value), "sending on a closed channel should fail");
+    ASSERT_SUCCESS(aws_channel_recv(&channel, &value), "queued elements should survive the close");
+    ASSERT_INT_EQUALS(14, value, "elements should come out in order");
+    ASSERT_ERROR(AWS_ERROR_CHANNEL_CLOSED, aws_channel_recv(&channel, &value),
+                 "receiving from a drained, closed channel should fail");
+
+    aws_channel_clean_up(&channel);
+    return 0;
+}
+
+static void channel_blocked_recv_fn(void *arg) {
+    struct aws_channel *channel = (struct aws_channel *)arg;
+    int value = 0;
+
+    while (!aws_channel_recv(channel, &value)) {
+    }
+}
+
+static int test_channel_close_wakes_blocked(struct aws_allocator *allocator, void *ctx) {
+    struct aws_channel channel;
+    ASSERT_SUCCESS(aws_channel_init(&channel, allocator, sizeof(int), 1), "init failed");
+
+    struct aws_thread thread;
+    aws_thread_init(&thread, allocator);
+    ASSERT_SUCCESS(aws_thread_launch(&thread, channel_blocked_recv_fn, &channel, 0), "thread creation failed");
+
+    int value = 1;
+    ASSERT_SUCCESS(aws_channel_send(&channel, &value), "send failed");
+    aws_thread_current_sleep(10000000);
+    aws_channel_close(&channel);
+
+    ASSERT_SUCCESS(aws_thread_join(&thread), "a receiver blocked on an empty channel should wake up on close");
+    aws_thread_clean_up(&thread);
+    aws_channel_clean_up(&channel);
+
+    return 0;
+}
+
+#define CHANNEL_MPMC_PRODUCERS 2
+#define CHANNEL_MPMC_CONSUMERS 2
+#define CHANNEL_MPMC_ITEMS (1 << 16)
+#define CHANNEL_MPMC_BATCH 64
+
+struct channel_mpmc_data {
+    struct aws_channel channel;
+    struct aws_atomic_var received;
+    struct aws_atomic_var sum;
+};
+
+static void channel_mpmc_producer_fn(void *arg) {
+    struct channel_mpmc_data *data = (struct channel_mpmc_data *)arg;
+    uint64_t batch[CHANNEL_MPMC_BATCH];
+
+    for (size_t i = 0; i < CHANNEL_MPMC_ITEMS; i += CHANNEL_MPMC_BATCH) {
+        for (size_t j = 0; j < CHANNEL_MPMC_BATCH; ++j) {
+            batch[j] = i + j + 1;
+        }
+        aws_channel_send_n(&data->channel, batch, CHANNEL_MPMC_BATCH, NULL);
+    }
+}
+
+static void channel_mpmc_consumer_fn(void *arg) {
+    struct channel_mpmc_data *data = (struct channel_mpmc_data *)arg;
+    uint64_t batch[CHANNEL_MPMC_BATCH];
+    size_t received = 0;
+
+    while (!aws_channel_recv_n(&data->channel, batch, CHANNEL_MPMC_BATCH, &received)) {
+        size_t sum = 0;
+        for (size_t i = 0; i < received; ++i) {
+            sum += (size_t)batch[i];
+        }
+        aws_atomic_fetch_add(&data->sum, sum);
+        aws_atomic_fetch_add(&data->received, received);
+    }
+}
+
+/* batching producers and consumers sharing a small channel; tests/benchmarks/channel_benchmark.c times the same. */
+static int test_channel_batch_mpmc(struct aws_allocator *allocator, void *ctx) {
+    struct channel_mpmc_data data;
+    ASSERT_SUCCESS(aws_channel_init(&data.channel, allocator, sizeof(uint64_t), 1024), "init failed");
+    aws_atomic_init_int(&data.received, 0);
+    aws_atomic_init_int(&data.sum, 0);
+
+    struct aws_thread producers[CHANNEL_MPMC_PRODUCERS];
+    struct aws_thread consumers[CHANNEL_MPMC_CONSUMERS];
+    for (int i = 0; i < CHANNEL_MPMC_CONSUMERS; ++i) {
+        aws_thread_init(&consumers[i], allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&consumers[i], channel_mpmc_consumer_fn, &data, 0), "thread creation failed");
+    }
+    for (int i = 0; i < CHANNEL_MPMC_PRODUCERS; ++i) {
+        aws_thread_init(&producers[i], allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&producers[i], channel_mpmc_producer_fn, &data, 0), "thread creation failed");
+    }
+
+    for (int i = 0; i < CHANNEL_MPMC_PRODUCERS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&producers[i]), "thread join failed");
+        aws_thread_clean_up(&producers[i]);
+    }
+    aws_channel_close(&data.channel);
+    for (int i = 0; i < CHANNEL_MPMC_CONSUMERS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&consumers[i]), "thread join failed");
+        aws_thread_clean_up(&consumers[i]);
+    }
+
+    ASSERT_INT_EQUALS((size_t)CHANNEL_MPMC_PRODUCERS * CHANNEL_MPMC_ITEMS, aws_atomic_load_int(&data.received),
+                      "every item should be received");
+    ASSERT_INT_EQUALS(CHANNEL_MPMC_PRODUCERS * ((size_t)CHANNEL_MPMC_ITEMS * (CHANNEL_MPMC_ITEMS + 1) / 2),
+                      aws_atomic_load_int(&data.sum), "every item should be received exactly once");
+
+    aws_channel_clean_up(&data.channel);
+    return 0;
+}
+
+AWS_TEST_CASE(channel_send_recv_test, test_channel_send_recv)
+AWS_TEST_CASE(channel_close_wakes_blocked_test, test_channel_close_wakes_blocked)
+AWS_TEST_CASE(channel_batch_mpmc_test, test_channel_batch_mpmc)
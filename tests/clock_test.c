@@ -45,5 +45,43 @@ static int test_sys_clock_increments(struct aws_allocator *allocator, void *ctx)
     return 0;
 }
 
+static int test_clock_instances(struct aws_allocator *allocator, void *ctx) {
+    uint64_t before = 0, ticks = 0, after = 0;
+
+    ASSERT_SUCCESS(aws_high_res_clock_get_ticks(&before), "High res get ticks failed with error %d", aws_last_error());
+    ASSERT_SUCCESS(aws_clock_get_ticks(aws_high_res_clock(), &ticks), "clock get ticks failed");
+    ASSERT_SUCCESS(aws_high_res_clock_get_ticks(&after), "High res get ticks failed with error %d", aws_last_error());
+    ASSERT_TRUE(before <= ticks && ticks <= after, "the high res clock instance should read the high res clock");
+
+    ASSERT_SUCCESS(aws_clock_get_ticks(aws_sys_clock(), &ticks), "clock get ticks failed");
+    ASSERT_SUCCESS(aws_sys_clock_get_ticks(&after), "Sys clock get ticks failed with error %d", aws_last_error());
+    ASSERT_TRUE(ticks <= after, "the sys clock instance should read the sys clock");
+
+    struct aws_manual_clock manual;
+    aws_manual_clock_init(&manual, 1000);
+    ASSERT_SUCCESS(aws_clock_get_ticks(&manual.clock, &ticks), "clock get ticks failed");
+    ASSERT_INT_EQUALS(1000, ticks, "a manual clock should start where it was told to");
+
+    aws_thread_current_sleep(1000000);
+    ASSERT_SUCCESS(aws_clock_get_ticks(&manual.clock, &ticks), "clock get ticks failed");
+    ASSERT_INT_EQUALS(1000, ticks, "a manual clock should not move by itself");
+
+    aws_manual_clock_advance(&manual, 500);
+    ASSERT_SUCCESS(aws_clock_get_ticks(&manual.clock, &ticks), "clock get ticks failed");
+    ASSERT_INT_EQUALS(1500, ticks, "advancing should move the clock forward");
+
+    aws_manual_clock_set(&manual, 42);
+    ASSERT_SUCCESS(aws_clock_get_ticks(&manual.clock, &ticks), "clock get ticks failed");
+    ASSERT_INT_EQUALS(42, ticks, "setting should move the clock to the given time");
+
+    /* an hour of simulated time, well past what 32 bits of nanoseconds hold. */
+    aws_manual_clock_advance(&manual, 3600000000000ULL);
+    ASSERT_SUCCESS(aws_clock_get_ticks(&manual.clock, &ticks), "clock get ticks failed");
+    ASSERT_INT_EQUALS(3600000000042LL, ticks, "the clock should not wrap");
+
+    return 0;
+}
+
 AWS_TEST_CASE(high_res_clock_increments_test, test_high_res_clock_increments)
 AWS_TEST_CASE(sys_clock_increments_test, test_sys_clock_increments)
+AWS_TEST_CASE(clock_instances_test, test_clock_instances)
@@ -0,0 +1,69 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/coarse_clock.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+
+static int check_coarse_clocks(void) {
+    uint64_t resolution = aws_coarse_clock_resolution();
+    ASSERT_TRUE(resolution > 0, "the resolution should be known");
+
+    uint64_t sys_ticks = 0, coarse_sys_ticks = 0;
+    ASSERT_SUCCESS(aws_coarse_sys_clock_get_ticks(&coarse_sys_ticks), "coarse sys clock failed");
+    ASSERT_SUCCESS(aws_sys_clock_get_ticks(&sys_ticks), "sys clock failed");
+    /* allow some slack for the test itself being descheduled. */
+    ASSERT_TRUE(coarse_sys_ticks <= sys_ticks + 1000000, "the coarse sys clock should not run ahead");
+    ASSERT_TRUE(sys_ticks - coarse_sys_ticks <= resolution + 50000000,
+                "the coarse sys clock should lag by at most its resolution");
+
+    uint64_t before = 0, after = 0;
+    ASSERT_SUCCESS(aws_coarse_clock_get_ticks(&before), "coarse clock failed");
+    aws_thread_current_sleep(2 * resolution + 1000000);
+    ASSERT_SUCCESS(aws_coarse_clock_get_ticks(&after), "coarse clock failed");
+    ASSERT_TRUE(after > before, "the coarse clock should advance");
+
+    return 0;
+}
+
+static int test_coarse_clock(struct aws_allocator *allocator, void *ctx) {
+    return check_coarse_clocks();
+}
+
+static int test_coarse_clock_ticker(struct aws_allocator *allocator, void *ctx) {
+    uint64_t os_resolution = aws_coarse_clock_resolution();
+
+    ASSERT_SUCCESS(aws_coarse_clock_ticker_start(allocator, 1000000), "ticker start failed");
+    /* nested starts share the ticker. */
+    ASSERT_SUCCESS(aws_coarse_clock_ticker_start(allocator, 5000000), "ticker start failed");
+    ASSERT_INT_EQUALS(os_resolution + 1000000, aws_coarse_clock_resolution(),
+                      "the ticker interval adds to the resolution");
+    ASSERT_SUCCESS(check_coarse_clocks(), "coarse clocks misbehaved with the ticker running");
+
+    uint64_t cached = 0, live = 0;
+    aws_coarse_clock_ticker_stop();
+    ASSERT_SUCCESS(check_coarse_clocks(), "the ticker should still run until the last stop");
+    ASSERT_SUCCESS(aws_coarse_clock_get_ticks(&cached), "coarse clock failed");
+
+    aws_coarse_clock_ticker_stop();
+    ASSERT_INT_EQUALS(os_resolution, aws_coarse_clock_resolution(), "stopping the ticker restores the resolution");
+    ASSERT_SUCCESS(aws_coarse_clock_get_ticks(&live), "coarse clock failed");
+    ASSERT_TRUE(live >= cached, "the coarse clock should not go backwards when the ticker stops");
+
+    return 0;
+}
+
+AWS_TEST_CASE(coarse_clock_test, test_coarse_clock)
+AWS_TEST_CASE(coarse_clock_ticker_test, test_coarse_clock_ticker)
@@ -0,0 +1,126 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/date_time.h>
+#include <aws_test_harness.h>
+#include <string.h>
+
+static const uint64_t NS_PER_SEC = 1000000000;
+
+static int test_date_time_format(struct aws_allocator *allocator, void *ctx) {
+    char output[AWS_DATE_TIME_RFC3339_MAX_LEN];
+
+    ASSERT_SUCCESS(aws_date_time_format_rfc3339(0, 0, output, sizeof(output)), "format failed");
+    ASSERT_INT_EQUALS(0, strcmp("1970-01-01T00:00:00Z", output), "the epoch is 1970-01-01");
+
+    /* the HTTP specification's example date. */
+    uint64_t example = 784111777 * NS_PER_SEC + 123456789;
+    ASSERT_SUCCESS(aws_date_time_format_rfc3339(example, 3, output, sizeof(output)), "format failed");
+    ASSERT_INT_EQUALS(0, strcmp("1994-11-06T08:49:37.123Z", output), "wrong RFC 3339 date %s", output);
+    /* same second again, served from the cache. */
+    ASSERT_SUCCESS(aws_date_time_format_rfc3339(example + 1000, 9, output, sizeof(output)), "format failed");
+    ASSERT_INT_EQUALS(0, strcmp("1994-11-06T08:49:37.123457789Z", output), "wrong RFC 3339 date %s", output);
+    ASSERT_SUCCESS(aws_date_time_format_rfc1123(example, output, sizeof(output)), "format failed");
+    ASSERT_INT_EQUALS(0, strcmp("Sun, 06 Nov 1994 08:49:37 GMT", output), "wrong RFC 1123 date %s", output);
+
+    /* leap days, and the day after one. */
+    ASSERT_SUCCESS(aws_date_time_format_rfc3339(951782400 * NS_PER_SEC, 0, output, sizeof(output)), "format failed");
+    ASSERT_INT_EQUALS(0, strcmp("2000-02-29T00:00:00Z", output), "wrong RFC 3339 date %s", output);
+    ASSERT_SUCCESS(aws_date_time_format_rfc1123(4107542400 * NS_PER_SEC, output, sizeof(output)), "format failed");
+    ASSERT_INT_EQUALS(0, strcmp("Mon, 01 Mar 2100 00:00:00 GMT", output), "wrong RFC 1123 date %s", output);
+
+    ASSERT_ERROR(AWS_ERROR_INVALID_BUFFER_SIZE, aws_date_time_format_rfc3339(0, 3, output, 24),
+                 "the output buffer is too small");
+    ASSERT_ERROR(AWS_ERROR_INVALID_BUFFER_SIZE, aws_date_time_format_rfc1123(0, output, AWS_DATE_TIME_RFC1123_LEN - 1),
+                 "the output buffer is too small");
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_date_time_format_rfc3339(0, 10, output, sizeof(output)),
+                 "there are only nine fraction digits");
+
+    return 0;
+}
+
+static int check_parse(int (*parse)(const char *, size_t, uint64_t *), const char *date_str, uint64_t expected) {
+    uint64_t epoch_ns = 0;
+    ASSERT_SUCCESS(parse(date_str, strlen(date_str), &epoch_ns), "failed to parse %s", date_str);
+    ASSERT_INT_EQUALS(expected, epoch_ns, "wrong time parsed from %s", date_str);
+    return 0;
+}
+
+static int check_parse_fails(int (*parse)(const char *, size_t, uint64_t *), const char *date_str) {
+    uint64_t epoch_ns = 0;
+    ASSERT_ERROR(AWS_ERROR_INVALID_DATE_STR, parse(date_str, strlen(date_str), &epoch_ns), "parsed %s", date_str);
+    return 0;
+}
+
+static int test_date_time_parse(struct aws_allocator *allocator, void *ctx) {
+    uint64_t example = 784111777 * NS_PER_SEC;
+
+    ASSERT_SUCCESS(check_parse(aws_date_time_parse_rfc3339, "1994-11-06T08:49:37Z", example), "date check failed");
+    ASSERT_SUCCESS(check_parse(aws_date_time_parse_rfc3339, "1994-11-06t08:49:37.5z", example + 500000000), "date check failed");
+    ASSERT_SUCCESS(check_parse(aws_date_time_parse_rfc3339, "1994-11-06 08:49:37.1234567891234Z",
+                               example + 123456789), "date check failed");
+    ASSERT_SUCCESS(check_parse(aws_date_time_parse_rfc3339, "1994-11-06T10:49:37+02:00", example), "date check failed");
+    ASSERT_SUCCESS(check_parse(aws_date_time_parse_rfc3339, "1994-11-06T03:19:37-05:30", example), "date check failed");
+    ASSERT_SUCCESS(check_parse(aws_date_time_parse_rfc3339, "2016-12-31T23:59:60Z", 1483228800 * NS_PER_SEC), "date check failed");
+
+    ASSERT_SUCCESS(check_parse_fails(aws_date_time_parse_rfc3339, "1994-11-06T08:49:37"), "date check failed");
+    ASSERT_SUCCESS(check_parse_fails(aws_date_time_parse_rfc3339, "1994-11-06T08:49:37Zjunk"), "date check failed");
+    ASSERT_SUCCESS(check_parse_fails(aws_date_time_parse_rfc3339, "1994-13-06T08:49:37Z"), "date check failed");
+    ASSERT_SUCCESS(check_parse_fails(aws_date_time_parse_rfc3339, "1995-02-29T08:49:37Z"), "date check failed");
+    ASSERT_SUCCESS(check_parse_fails(aws_date_time_parse_rfc3339, "1994-11-06T08:49:37.Z"), "date check failed");
+    ASSERT_SUCCESS(check_parse_fails(aws_date_time_parse_rfc3339, "1969-12-31T23:59:59Z"), "date check failed");
+    ASSERT_SUCCESS(check_parse_fails(aws_date_time_parse_rfc3339, "1970-01-01T00:00:00+00:01"), "date check failed");
+
+    ASSERT_SUCCESS(check_parse(aws_date_time_parse_rfc1123, "Sun, 06 Nov 1994 08:49:37 GMT", example), "date check failed");
+    ASSERT_SUCCESS(check_parse(aws_date_time_parse_rfc1123, "6 Nov 1994 08:49:37 UTC", example), "date check failed");
+    ASSERT_SUCCESS(check_parse(aws_date_time_parse_rfc1123, "Sun, 06 Nov 1994 09:49:37 +0100", example), "date check failed");
+    ASSERT_SUCCESS(check_parse(aws_date_time_parse_rfc1123, "Sun, 06 Nov 1994 08:49 GMT", example - 37 * NS_PER_SEC),
+                   "date check failed");
+
+    ASSERT_SUCCESS(check_parse_fails(aws_date_time_parse_rfc1123, "Sun, 06 Nov 1994 08:49:37"), "date check failed");
+    ASSERT_SUCCESS(check_parse_fails(aws_date_time_parse_rfc1123, "Sun, 06 Nox 1994 08:49:37 GMT"), "date check failed");
+    ASSERT_SUCCESS(check_parse_fails(aws_date_time_parse_rfc1123, "Sunday, 06 Nov 1994 08:49:37 GMT"), "date check failed");
+    ASSERT_SUCCESS(check_parse_fails(aws_date_time_parse_rfc1123, "Sun, 31 Nov 1994 08:49:37 GMT"), "date check failed");
+    ASSERT_SUCCESS(check_parse_fails(aws_date_time_parse_rfc1123, "Sun, 06 Nov 1994 08:49:37 +-0100"), "date check failed");
+
+    return 0;
+}
+
+static int test_date_time_round_trip(struct aws_allocator *allocator, void *ctx) {
+    char output[AWS_DATE_TIME_RFC3339_MAX_LEN];
+    uint64_t parsed = 0;
+
+    /* walk from the epoch to the end of the representable range in uneven steps. */
+    for (uint64_t epoch_ns = 0; epoch_ns < UINT64_MAX - 987654321987654321; epoch_ns += 987654321987654321 / 1000) {
+        struct aws_date_time date_time;
+        aws_date_time_from_epoch_ns(epoch_ns, &date_time);
+        ASSERT_SUCCESS(aws_date_time_to_epoch_ns(&date_time, &parsed), "to_epoch_ns failed");
+        ASSERT_INT_EQUALS(epoch_ns, parsed, "broken down dates should convert back");
+
+        ASSERT_SUCCESS(aws_date_time_format_rfc3339(epoch_ns, 9, output, sizeof(output)), "format failed");
+        ASSERT_SUCCESS(aws_date_time_parse_rfc3339(output, strlen(output), &parsed), "parse failed for %s", output);
+        ASSERT_INT_EQUALS(epoch_ns, parsed, "RFC 3339 should round trip %s", output);
+
+        ASSERT_SUCCESS(aws_date_time_format_rfc1123(epoch_ns, output, sizeof(output)), "format failed");
+        ASSERT_SUCCESS(aws_date_time_parse_rfc1123(output, strlen(output), &parsed), "parse failed for %s", output);
+        ASSERT_INT_EQUALS(epoch_ns / NS_PER_SEC * NS_PER_SEC, parsed, "RFC 1123 should round trip %s", output);
+    }
+
+    return 0;
+}
+
+AWS_TEST_CASE(date_time_format_test, test_date_time_format)
+AWS_TEST_CASE(date_time_parse_test, test_date_time_parse)
+AWS_TEST_CASE(date_time_round_trip_test, test_date_time_round_trip)
@@ -0,0 +1,182 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/epoch.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+
+static int test_epoch_reader_blocks_reclamation(struct aws_allocator *allocator, void *ctx) {
+    struct aws_epoch_domain domain;
+    ASSERT_SUCCESS(aws_epoch_domain_init(&domain, allocator), "domain init failed");
+
+    struct aws_epoch_thread writer, reader;
+    ASSERT_SUCCESS(aws_epoch_thread_register(&domain, &writer), "register failed");
+    ASSERT_SUCCESS(aws_epoch_thread_register(&domain, &reader), "register failed");
+
+    /* the reader announces an epoch and then stalls. */
+    aws_epoch_enter(&reader);
+
+    for (int i = 0; i < AWS_EPOCH_RETIRE_BATCH * 4; ++i) {
+        aws_epoch_enter(&writer);
+        void *node = aws_mem_acquire(allocator, 32);
+        ASSERT_NOT_NULL(node, "allocation failed");
+        ASSERT_SUCCESS(aws_epoch_retire(&writer, node, allocator), "retire failed");
+        aws_epoch_exit(&writer);
+    }
+
+    aws_epoch_thread_reclaim(&writer);
+    ASSERT_INT_EQUALS(AWS_EPOCH_RETIRE_BATCH * 4, aws_epoch_thread_pending(&writer),
+                      "nothing may be released while a reader is inside a critical section");
+
+    aws_epoch_exit(&reader);
+    aws_epoch_thread_flush(&writer);
+    ASSERT_INT_EQUALS(0, aws_epoch_thread_pending(&writer), "flush should release everything once readers leave");
+
+    /* nodes still pending at unregister time are handed to the domain and released at clean up. */
+    void *node = aws_mem_acquire(allocator, 32);
+    ASSERT_SUCCESS(aws_epoch_retire(&writer, node, allocator), "retire failed");
+
+    aws_epoch_thread_unregister(&reader);
+    aws_epoch_thread_unregister(&writer);
+    aws_epoch_domain_clean_up(&domain);
+
+    return 0;
+}
+
+/* a thread safe counting allocator, since the harness allocator is not safe to share between threads. */
+struct epoch_counting_allocator {
+    struct aws_allocator base;
+    struct aws_atomic_var acquired;
+    struct aws_atomic_var released;
+};
+
+static void *epoch_counting_acquire(struct aws_allocator *allocator, size_t size) {
+    struct epoch_counting_allocator *counting = (struct epoch_counting_allocator *)allocator;
+    aws_atomic_fetch_add(&counting->acquired, 1);
+    return malloc(size);
+}
+
+static void epoch_counting_release(struct aws_allocator *allocator, void *ptr) {
+    struct epoch_counting_allocator *counting = (struct epoch_counting_allocator *)allocator;
+    aws_atomic_fetch_add(&counting->released, 1);
+    /* scribble over the node so a use after free shows up as a corrupted stack. */
+    memset(ptr, 0xDD, sizeof(void *) * 2);
+    free(ptr);
+}
+
+struct epoch_stack_node {
+    struct epoch_stack_node *next;
+    size_t value;
+};
+
+#define EPOCH_TEST_THREADS 4
+#define EPOCH_TEST_OPERATIONS 20000
+
+struct epoch_stack_test_data {
+    struct aws_epoch_domain domain;
+    struct epoch_counting_allocator node_allocator;
+    struct aws_atomic_var head;
+    struct aws_atomic_var popped;
+    struct aws_allocator *allocator;
+    struct aws_atomic_var failed;
+};
+
+static void epoch_stack_push(struct epoch_stack_test_data *data, struct epoch_stack_node *node) {
+    void *head = aws_atomic_load_ptr_explicit(&data->head, aws_memory_order_relaxed);
+    do {
+        node->next = (struct epoch_stack_node *)head;
+    } while (!aws_atomic_compare_exchange_ptr_explicit(&data->head, &head, node, aws_memory_order_release,
+            aws_memory_order_relaxed));
+}
+
+static struct epoch_stack_node *epoch_stack_pop(struct epoch_stack_test_data *data) {
+    void *head = aws_atomic_load_ptr_explicit(&data->head, aws_memory_order_acquire);
+    while (head) {
+        struct epoch_stack_node *next = ((struct epoch_stack_node *)head)->next;
+        if (aws_atomic_compare_exchange_ptr_explicit(&data->head, &head, next, aws_memory_order_acquire,
+                aws_memory_order_acquire)) {
+            break;
+        }
+    }
+
+    return (struct epoch_stack_node *)head;
+}
+
+static void epoch_stack_thread_fn(void *arg) {
+    struct epoch_stack_test_data *data = (struct epoch_stack_test_data *)arg;
+    struct aws_allocator *node_allocator = &data->node_allocator.base;
+
+    struct aws_epoch_thread thread;
+    if (aws_epoch_thread_register(&data->domain, &thread)) {
+        aws_atomic_store_int(&data->failed, 1);
+        return;
+    }
+
+    for (size_t i = 0; i < EPOCH_TEST_OPERATIONS; ++i) {
+        struct epoch_stack_node *node = (struct epoch_stack_node *)aws_mem_acquire(node_allocator, sizeof(*node));
+        node->value = i;
+
+        aws_epoch_enter(&thread);
+        epoch_stack_push(data, node);
+        struct epoch_stack_node *popped = epoch_stack_pop(data);
+        if (popped) {
+            if (popped->value >= EPOCH_TEST_OPERATIONS) {
+                aws_atomic_store_int(&data->failed, 1);
+            }
+            aws_atomic_fetch_add(&data->popped, 1);
+            aws_epoch_retire(&thread, popped, node_allocator);
+        }
+        aws_epoch_exit(&thread);
+    }
+
+    aws_epoch_thread_unregister(&thread);
+}
+
+static int test_epoch_lock_free_stack(struct aws_allocator *allocator, void *ctx) {
+    struct epoch_stack_test_data data;
+    data.allocator = allocator;
+    data.node_allocator.base.mem_acquire = epoch_counting_acquire;
+    data.node_allocator.base.mem_release = epoch_counting_release;
+    aws_atomic_init_int(&data.node_allocator.acquired, 0);
+    aws_atomic_init_int(&data.node_allocator.released, 0);
+    aws_atomic_init_ptr(&data.head, NULL);
+    aws_atomic_init_int(&data.popped, 0);
+    aws_atomic_init_int(&data.failed, 0);
+    ASSERT_SUCCESS(aws_epoch_domain_init(&data.domain, aws_default_allocator()), "domain init failed");
+
+    struct aws_thread threads[EPOCH_TEST_THREADS];
+    for (int i = 0; i < EPOCH_TEST_THREADS; ++i) {
+        aws_thread_init(&threads[i], allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], epoch_stack_thread_fn, &data, 0), "thread creation failed");
+    }
+
+    for (int i = 0; i < EPOCH_TEST_THREADS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]), "thread join failed");
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    ASSERT_INT_EQUALS(0, aws_atomic_load_int(&data.failed), "a thread read a released node");
+    ASSERT_INT_EQUALS(EPOCH_TEST_THREADS * EPOCH_TEST_OPERATIONS, aws_atomic_load_int(&data.popped),
+                      "every push is followed by a pop, so every node should have been popped");
+
+    aws_epoch_domain_clean_up(&data.domain);
+    ASSERT_INT_EQUALS(aws_atomic_load_int(&data.node_allocator.acquired), aws_atomic_load_int(&data.node_allocator.released),
+                      "every retired node should have been released");
+
+    return 0;
+}
+
+AWS_TEST_CASE(epoch_reader_blocks_reclamation_test, test_epoch_reader_blocks_reclamation)
+AWS_TEST_CASE(epoch_lock_free_stack_test, test_epoch_lock_free_stack)
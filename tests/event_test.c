@@ -0,0 +1,82 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/event.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+
+static int test_event_set_reset(struct aws_allocator *allocator, void *ctx) {
+    struct aws_event event;
+    aws_event_init(&event);
+    ASSERT_FALSE(aws_event_is_set(&event), "a new event should be unset");
+    ASSERT_ERROR(AWS_ERROR_WAIT_TIMEOUT, aws_event_wait_timeout(&event, 1000000), "waiting should time out");
+
+    aws_event_set(&event);
+    ASSERT_TRUE(aws_event_is_set(&event), "the event should be set");
+    ASSERT_SUCCESS(aws_event_wait(&event), "waiting on a set event should return immediately");
+    ASSERT_SUCCESS(aws_event_wait_timeout(&event, 0), "waiting on a set event should return immediately");
+
+    aws_event_reset(&event);
+    ASSERT_FALSE(aws_event_is_set(&event), "the event should be unset");
+    ASSERT_ERROR(AWS_ERROR_WAIT_TIMEOUT, aws_event_wait_timeout(&event, 0), "waiting should time out");
+
+    return 0;
+}
+
+#define EVENT_TEST_ROUND_TRIPS 10000
+
+struct event_ping_pong_data {
+    struct aws_event ping;
+    struct aws_event pong;
+    size_t counter;
+};
+
+static void event_pong_fn(void *arg) {
+    struct event_ping_pong_data *data = (struct event_ping_pong_data *)arg;
+
+    for (int i = 0; i < EVENT_TEST_ROUND_TRIPS; ++i) {
+        aws_event_wait(&data->ping);
+        aws_event_reset(&data->ping);
+        data->counter++;
+        aws_event_set(&data->pong);
+    }
+}
+
+static int test_event_ping_pong(struct aws_allocator *allocator, void *ctx) {
+    struct event_ping_pong_data data;
+    aws_event_init(&data.ping);
+    aws_event_init(&data.pong);
+    data.counter = 0;
+
+    struct aws_thread thread;
+    aws_thread_init(&thread, allocator);
+    ASSERT_SUCCESS(aws_thread_launch(&thread, event_pong_fn, &data, 0), "thread creation failed");
+
+    for (size_t i = 1; i <= EVENT_TEST_ROUND_TRIPS; ++i) {
+        aws_event_set(&data.ping);
+        ASSERT_SUCCESS(aws_event_wait(&data.pong), "wait failed");
+        aws_event_reset(&data.pong);
+        /* the event orders the other thread's plain writes before our reads. */
+        ASSERT_INT_EQUALS(i, data.counter, "every round trip should see the other thread's update");
+    }
+
+    ASSERT_SUCCESS(aws_thread_join(&thread), "thread join failed");
+    aws_thread_clean_up(&thread);
+
+    return 0;
+}
+
+AWS_TEST_CASE(event_set_reset_test, test_event_set_reset)
+AWS_TEST_CASE(event_ping_pong_test, test_event_ping_pong)
@@ -0,0 +1,176 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/hazard_ptr.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+
+static int test_hazard_ptr_bounded_garbage(struct aws_allocator *allocator, void *ctx) {
+    struct aws_hazard_domain domain;
+    ASSERT_SUCCESS(aws_hazard_domain_init(&domain, allocator), "domain init failed");
+
+    struct aws_hazard_thread writer, reader;
+    ASSERT_SUCCESS(aws_hazard_thread_register(&domain, &writer), "register failed");
+    ASSERT_SUCCESS(aws_hazard_thread_register(&domain, &reader), "register failed");
+
+    /* the reader protects one node and then stalls. */
+    struct aws_atomic_var shared;
+    aws_atomic_init_ptr(&shared, aws_mem_acquire(allocator, 32));
+    void *pinned = aws_hazard_protect(&reader, 0, &shared);
+    ASSERT_PTR_EQUALS(aws_atomic_load_ptr(&shared), pinned, "protect should return the current pointer");
+    aws_atomic_store_ptr(&shared, NULL);
+    ASSERT_SUCCESS(aws_hazard_retire(&writer, pinned, allocator), "retire failed");
+
+    for (int i = 0; i < AWS_HAZARD_PTR_SCAN_THRESHOLD * 10; ++i) {
+        ASSERT_SUCCESS(aws_hazard_retire(&writer, aws_mem_acquire(allocator, 32), allocator), "retire failed");
+        ASSERT_TRUE(aws_hazard_thread_pending(&writer) <= AWS_HAZARD_PTR_SCAN_THRESHOLD,
+                    "garbage should stay bounded while a reader is stalled");
+    }
+
+    aws_hazard_scan(&writer);
+    ASSERT_INT_EQUALS(1, aws_hazard_thread_pending(&writer), "only the protected node should remain");
+
+    aws_hazard_clear(&reader, 0);
+    ASSERT_INT_EQUALS(1, aws_hazard_scan(&writer), "the node should be released once unprotected");
+    ASSERT_INT_EQUALS(0, aws_hazard_thread_pending(&writer), "nothing should remain");
+
+    /* a protected node still pending at unregister time is handed to the domain. */
+    aws_atomic_store_ptr(&shared, aws_mem_acquire(allocator, 32));
+    pinned = aws_hazard_protect(&reader, 1, &shared);
+    ASSERT_SUCCESS(aws_hazard_retire(&writer, pinned, allocator), "retire failed");
+    aws_hazard_thread_unregister(&writer);
+    aws_hazard_thread_unregister(&reader);
+    aws_hazard_domain_clean_up(&domain);
+
+    return 0;
+}
+
+struct hazard_counting_allocator {
+    struct aws_allocator base;
+    struct aws_atomic_var acquired;
+    struct aws_atomic_var released;
+};
+
+static void *hazard_counting_acquire(struct aws_allocator *allocator, size_t size) {
+    struct hazard_counting_allocator *counting = (struct hazard_counting_allocator *)allocator;
+    aws_atomic_fetch_add(&counting->acquired, 1);
+    return malloc(size);
+}
+
+static void hazard_counting_release(struct aws_allocator *allocator, void *ptr) {
+    struct hazard_counting_allocator *counting = (struct hazard_counting_allocator *)allocator;
+    aws_atomic_fetch_add(&counting->released, 1);
+    memset(ptr, 0xDD, sizeof(void *) * 2);
+    free(ptr);
+}
+
+struct hazard_stack_node {
+    struct hazard_stack_node *next;
+    size_t value;
+};
+
+#define HAZARD_TEST_THREADS 4
+#define HAZARD_TEST_OPERATIONS 20000
+
+struct hazard_stack_test_data {
+    struct aws_hazard_domain domain;
+    struct hazard_counting_allocator node_allocator;
+    struct aws_atomic_var head;
+    struct aws_atomic_var popped;
+    struct aws_atomic_var failed;
+};
+
+static void hazard_stack_thread_fn(void *arg) {
+    struct hazard_stack_test_data *data = (struct hazard_stack_test_data *)arg;
+    struct aws_allocator *node_allocator = &data->node_allocator.base;
+
+    struct aws_hazard_thread thread;
+    if (aws_hazard_thread_register(&data->domain, &thread)) {
+        aws_atomic_store_int(&data->failed, 1);
+        return;
+    }
+
+    for (size_t i = 0; i < HAZARD_TEST_OPERATIONS; ++i) {
+        struct hazard_stack_node *node = (struct hazard_stack_node *)aws_mem_acquire(node_allocator, sizeof(*node));
+        node->value = i;
+
+        void *head = aws_atomic_load_ptr_explicit(&data->head, aws_memory_order_relaxed);
+        do {
+            node->next = (struct hazard_stack_node *)head;
+        } while (!aws_atomic_compare_exchange_ptr_explicit(&data->head, &head, node, aws_memory_order_release,
+                aws_memory_order_relaxed));
+
+        struct hazard_stack_node *popped = NULL;
+        for (;;) {
+            popped = (struct hazard_stack_node *)aws_hazard_protect(&thread, 0, &data->head);
+            if (!popped) {
+                break;
+            }
+
+            void *expected = popped;
+            if (aws_atomic_compare_exchange_ptr_explicit(&data->head, &expected, popped->next, aws_memory_order_acquire,
+                    aws_memory_order_relaxed)) {
+                break;
+            }
+        }
+        aws_hazard_clear(&thread, 0);
+
+        if (popped) {
+            if (popped->value >= HAZARD_TEST_OPERATIONS) {
+                aws_atomic_store_int(&data->failed, 1);
+            }
+            aws_atomic_fetch_add(&data->popped, 1);
+            aws_hazard_retire(&thread, popped, node_allocator);
+        }
+    }
+
+    aws_hazard_thread_unregister(&thread);
+}
+
+static int test_hazard_ptr_lock_free_stack(struct aws_allocator *allocator, void *ctx) {
+    struct hazard_stack_test_data data;
+    data.node_allocator.base.mem_acquire = hazard_counting_acquire;
+    data.node_allocator.base.mem_release = hazard_counting_release;
+    aws_atomic_init_int(&data.node_allocator.acquired, 0);
+    aws_atomic_init_int(&data.node_allocator.released, 0);
+    aws_atomic_init_ptr(&data.head, NULL);
+    aws_atomic_init_int(&data.popped, 0);
+    aws_atomic_init_int(&data.failed, 0);
+    ASSERT_SUCCESS(aws_hazard_domain_init(&data.domain, aws_default_allocator()), "domain init failed");
+
+    struct aws_thread threads[HAZARD_TEST_THREADS];
+    for (int i = 0; i < HAZARD_TEST_THREADS; ++i) {
+        aws_thread_init(&threads[i], allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], hazard_stack_thread_fn, &data, 0), "thread creation failed");
+    }
+
+    for (int i = 0; i < HAZARD_TEST_THREADS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]), "thread join failed");
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    ASSERT_INT_EQUALS(0, aws_atomic_load_int(&data.failed), "a thread read a released node");
+    ASSERT_INT_EQUALS(HAZARD_TEST_THREADS * HAZARD_TEST_OPERATIONS, aws_atomic_load_int(&data.popped),
+                      "every push is followed by a pop, so every node should have been popped");
+
+    aws_hazard_domain_clean_up(&data.domain);
+    ASSERT_INT_EQUALS(aws_atomic_load_int(&data.node_allocator.acquired),
+                      aws_atomic_load_int(&data.node_allocator.released), "every retired node should have been released");
+
+    return 0;
+}
+
+AWS_TEST_CASE(hazard_ptr_bounded_garbage_test, test_hazard_ptr_bounded_garbage)
+AWS_TEST_CASE(hazard_ptr_lock_free_stack_test, test_hazard_ptr_lock_free_stack)
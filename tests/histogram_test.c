@@ -0,0 +1,164 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/histogram.h>
+#include <aws_test_harness.h>
+#include <string.h>
+
+/* whether value is within the relative error of 3 significant figures of expected. */
+static int within_precision(uint64_t value, uint64_t expected) {
+    uint64_t diff = value > expected ? value - expected : expected - value;
+    return diff * 1000 <= expected;
+}
+
+static int test_histogram_percentiles(struct aws_allocator *allocator, void *ctx) {
+    struct aws_histogram histogram;
+
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_histogram_init(&histogram, allocator, 1000000, 6),
+                 "6 significant figures is too many");
+    ASSERT_SUCCESS(aws_histogram_init(&histogram, allocator, 3600000000000ULL, 3), "init failed");
+    ASSERT_INT_EQUALS(0, aws_histogram_value_at_percentile(&histogram, 50.0), "an empty histogram reports 0");
+
+    for (uint64_t value = 1; value <= 1000000; ++value) {
+        aws_histogram_record(&histogram, value);
+    }
+
+    ASSERT_INT_EQUALS(1000000, histogram.total_count, "every value should be counted");
+    ASSERT_INT_EQUALS(1, histogram.min, "min should be exact");
+    ASSERT_INT_EQUALS(1000000, histogram.max, "max should be exact");
+    ASSERT_INT_EQUALS(1, aws_histogram_value_at_percentile(&histogram, 0.0), "p0 is the min");
+    ASSERT_INT_EQUALS(1000000, aws_histogram_value_at_percentile(&histogram, 100.0), "p100 is the max");
+    ASSERT_TRUE(within_precision(aws_histogram_value_at_percentile(&histogram, 50.0), 500000), "p50 is off");
+    ASSERT_TRUE(within_precision(aws_histogram_value_at_percentile(&histogram, 99.0), 990000), "p99 is off");
+    ASSERT_TRUE(within_precision(aws_histogram_value_at_percentile(&histogram, 99.9), 999000), "p999 is off");
+    ASSERT_TRUE(within_precision((uint64_t)aws_histogram_mean(&histogram), 500000), "mean is off");
+
+    /* small values are exact. */
+    aws_histogram_reset(&histogram);
+    ASSERT_INT_EQUALS(0, histogram.total_count, "reset should forget everything");
+    aws_histogram_record_n(&histogram, 3, 99);
+    aws_histogram_record(&histogram, 7);
+    ASSERT_INT_EQUALS(3, aws_histogram_value_at_percentile(&histogram, 99.0), "p99 should be exact");
+    ASSERT_INT_EQUALS(7, aws_histogram_value_at_percentile(&histogram, 99.5), "p995 should be exact");
+
+    /* values past the trackable range land in the last bucket but still show up as the max. */
+    aws_histogram_record(&histogram, UINT64_MAX);
+    ASSERT_TRUE(UINT64_MAX == histogram.max, "max should not be clamped");
+    ASSERT_TRUE(aws_histogram_value_at_percentile(&histogram, 99.9) >= 3600000000000ULL,
+                "an out of range value should count as the highest trackable value");
+
+    aws_histogram_clean_up(&histogram);
+    return 0;
+}
+
+AWS_TEST_CASE(histogram_percentiles_test, test_histogram_percentiles)
+
+static int test_histogram_merge(struct aws_allocator *allocator, void *ctx) {
+    struct aws_histogram all;
+    struct aws_histogram parts[4];
+    struct aws_histogram coarse;
+
+    ASSERT_SUCCESS(aws_histogram_init(&all, allocator, 1000000000, 3), "init failed");
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_SUCCESS(aws_histogram_init(&parts[i], allocator, 1000000000, 3), "init failed");
+    }
+
+    /* as if 4 threads had each timed a quarter of the operations. */
+    for (uint64_t value = 1; value <= 400000; ++value) {
+        aws_histogram_record(&parts[value % 4], value * 10);
+        aws_histogram_record(&all, value * 10);
+    }
+
+    struct aws_histogram merged;
+    ASSERT_SUCCESS(aws_histogram_init(&merged, allocator, 1000000000, 3), "init failed");
+    for (int i = 0; i < 4; ++i) {
+        aws_histogram_merge(&merged, &parts[i]);
+    }
+
+    ASSERT_INT_EQUALS(all.total_count, merged.total_count, "merging should keep every value");
+    ASSERT_INT_EQUALS(all.min, merged.min, "merging should keep the min");
+    ASSERT_INT_EQUALS(all.max, merged.max, "merging should keep the max");
+    ASSERT_INT_EQUALS(0, memcmp(all.counts, merged.counts, all.counts_len * sizeof(uint64_t)),
+                      "merging should be the same as recording everything in one histogram");
+
+    /* a histogram of a different precision gets re-bucketed. */
+    ASSERT_SUCCESS(aws_histogram_init(&coarse, allocator, 100000000000ULL, 2), "init failed");
+    aws_histogram_merge(&coarse, &merged);
+    ASSERT_INT_EQUALS(all.total_count, coarse.total_count, "re-bucketing should keep every value");
+    uint64_t p99 = aws_histogram_value_at_percentile(&coarse, 99.0);
+    ASSERT_TRUE(p99 >= 3900000 && p99 <= 4000000, "re-bucketed p99 should be within 1%");
+
+    aws_histogram_clean_up(&coarse);
+    aws_histogram_clean_up(&merged);
+    for (int i = 0; i < 4; ++i) {
+        aws_histogram_clean_up(&parts[i]);
+    }
+    aws_histogram_clean_up(&all);
+    return 0;
+}
+
+AWS_TEST_CASE(histogram_merge_test, test_histogram_merge)
+
+static int test_histogram_encoding(struct aws_allocator *allocator, void *ctx) {
+    struct aws_histogram histogram;
+    struct aws_histogram decoded;
+    uint8_t buffer[4096];
+    size_t encoded_len = 0;
+
+    ASSERT_SUCCESS(aws_histogram_init(&histogram, allocator, 3600000000000ULL, 3), "init failed");
+
+    /* latencies clustered around 50us with a long tail, which is what most buckets being empty looks like. */
+    for (uint64_t i = 0; i < 100000; ++i) {
+        aws_histogram_record(&histogram, 50000 + (i % 1000) * 7);
+    }
+    aws_histogram_record_n(&histogram, 20000000, 10);
+    aws_histogram_record(&histogram, 1000000000000ULL);
+
+    size_t expected_len = 0;
+    ASSERT_SUCCESS(aws_histogram_compute_encoded_len(&histogram, &expected_len), "compute_encoded_len failed");
+    ASSERT_TRUE(expected_len < 1024, "the encoding should skip empty buckets");
+    ASSERT_ERROR(AWS_ERROR_INVALID_BUFFER_SIZE, aws_histogram_encode(&histogram, buffer, expected_len - 1,
+                 &encoded_len), "encoding into too small a buffer should fail");
+    ASSERT_SUCCESS(aws_histogram_encode(&histogram, buffer, sizeof(buffer), &encoded_len), "encode failed");
+    ASSERT_INT_EQUALS(expected_len, encoded_len, "encoded length should match the computed one");
+
+    ASSERT_SUCCESS(aws_histogram_decode(&decoded, allocator, buffer, encoded_len), "decode failed");
+    ASSERT_INT_EQUALS(histogram.counts_len, decoded.counts_len, "decoding should restore the layout");
+    ASSERT_INT_EQUALS(histogram.total_count, decoded.total_count, "decoding should restore the count");
+    ASSERT_INT_EQUALS(histogram.min, decoded.min, "decoding should restore the min");
+    ASSERT_INT_EQUALS(histogram.max, decoded.max, "decoding should restore the max");
+    ASSERT_INT_EQUALS(0, memcmp(histogram.counts, decoded.counts, histogram.counts_len * sizeof(uint64_t)),
+                      "decoding should restore every bucket");
+    aws_histogram_clean_up(&decoded);
+
+    ASSERT_ERROR(AWS_ERROR_INVALID_HISTOGRAM_ENCODING, aws_histogram_decode(&decoded, allocator, buffer,
+                 encoded_len - 1), "a truncated encoding should be rejected");
+    buffer[0]++;
+    ASSERT_ERROR(AWS_ERROR_INVALID_HISTOGRAM_ENCODING, aws_histogram_decode(&decoded, allocator, buffer,
+                 encoded_len), "an unknown version should be rejected");
+    buffer[0]--;
+
+    /* an empty histogram round trips too. */
+    aws_histogram_reset(&histogram);
+    ASSERT_SUCCESS(aws_histogram_encode(&histogram, buffer, sizeof(buffer), &encoded_len), "encode failed");
+    ASSERT_SUCCESS(aws_histogram_decode(&decoded, allocator, buffer, encoded_len), "decode failed");
+    ASSERT_INT_EQUALS(0, decoded.total_count, "an empty histogram should decode empty");
+    aws_histogram_clean_up(&decoded);
+
+    aws_histogram_clean_up(&histogram);
+    return 0;
+}
+
+AWS_TEST_CASE(histogram_encoding_test, test_histogram_encoding)
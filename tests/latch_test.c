@@ -0,0 +1,67 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/latch.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+
+#define LATCH_TEST_WORKERS 4
+
+struct latch_test_data {
+    struct aws_latch started;
+    struct aws_latch go;
+    struct aws_atomic_var ran;
+};
+
+static void latch_worker_fn(void *arg) {
+    struct latch_test_data *data = (struct latch_test_data *)arg;
+
+    aws_latch_count_down(&data->started, 1);
+    aws_latch_wait(&data->go);
+    aws_atomic_fetch_add(&data->ran, 1);
+}
+
+static int test_latch_wait_for_workers(struct aws_allocator *allocator, void *ctx) {
+    struct latch_test_data data;
+    aws_latch_init(&data.started, LATCH_TEST_WORKERS);
+    aws_latch_init(&data.go, 1);
+    aws_atomic_init_int(&data.ran, 0);
+
+    ASSERT_ERROR(AWS_ERROR_WAIT_TIMEOUT, aws_latch_try_wait(&data.started), "the latch should start closed");
+
+    struct aws_thread threads[LATCH_TEST_WORKERS];
+    for (int i = 0; i < LATCH_TEST_WORKERS; ++i) {
+        aws_thread_init(&threads[i], allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], latch_worker_fn, &data, 0), "thread creation failed");
+    }
+
+    ASSERT_SUCCESS(aws_latch_wait(&data.started), "waiting for the workers failed");
+    ASSERT_ERROR(AWS_ERROR_WAIT_TIMEOUT, aws_latch_wait_timeout(&data.go, 1000000),
+                 "waiting on a closed latch should time out");
+    ASSERT_INT_EQUALS(0, aws_atomic_load_int(&data.ran), "no worker should get past a closed latch");
+
+    aws_latch_count_down(&data.go, 1);
+    for (int i = 0; i < LATCH_TEST_WORKERS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]), "thread join failed");
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    ASSERT_INT_EQUALS(LATCH_TEST_WORKERS, aws_atomic_load_int(&data.ran), "every worker should have been released");
+    ASSERT_SUCCESS(aws_latch_try_wait(&data.go), "an open latch should stay open");
+
+    return 0;
+}
+
+AWS_TEST_CASE(latch_wait_for_workers_test, test_latch_wait_for_workers)
@@ -22,6 +22,29 @@
 #include <encoding_test.c>
 #include <linked_list_test.c>
 #include <priority_queue_test.c>
+#include <atomics_test.c>
+#include <seqlock_test.c>
+#include <epoch_test.c>
+#include <hazard_ptr_test.c>
+#include <rcu_test.c>
+#include <semaphore_test.c>
+#include <latch_test.c>
+#include <barrier_test.c>
+#include <event_test.c>
+#include <once_test.c>
+#include <percpu_test.c>
+#include <ref_count_test.c>
+#include <channel_test.c>
+#include <rate_limiter_test.c>
+#include <tsc_clock_test.c>
+#include <coarse_clock_test.c>
+#include <date_time_test.c>
+#include <histogram_test.c>
+#include <trace_test.c>
+#include <metrics_test.c>
+#include <probes_test.c>
+#include <profiler_test.c>
+#include <perf_counters_test.c>
 
 int main(int argc, char *argv[]) {
 
@@ -33,11 +56,18 @@ int main(int argc, char *argv[]) {
                        &unknown_error_code_range_too_large_test,
                        &error_code_cross_thread_test,
                        &thread_creation_join_test,
+                       &thread_sleep_until_test,
+                       &thread_sleep_interrupted_test,
+                       &thread_stats_test,
                        &mutex_aquire_release_test,
                        &mutex_is_actually_mutex_test,
+                       &mutex_contention_profile_test,
+                       &mutex_profile_thread_churn_test,
                        &high_res_clock_increments_test,
                        &sys_clock_increments_test,
+                       &clock_instances_test,
                        &array_list_order_push_back_pop_front_test,
+                       &array_list_pop_front_n_test,
                        &array_list_order_push_back_pop_back_test,
                        &array_list_exponential_mem_model_test,
                        &array_list_exponential_mem_model_iteration_test,
@@ -90,5 +120,60 @@ int main(int argc, char *argv[]) {
                        &uint16_buffer_test,
                        &uint16_buffer_non_aligned_test,
                        &uint16_buffer_signed_positive_test,
-                       &uint16_buffer_signed_negative_test);
+                       &uint16_buffer_signed_negative_test,
+                       &atomics_semantics_test,
+                       &atomics_concurrent_increments_test,
+                       &seqlock_read_write_test,
+                       &seqlock_readers_never_see_torn_records_test,
+                       &epoch_reader_blocks_reclamation_test,
+                       &epoch_lock_free_stack_test,
+                       &hazard_ptr_bounded_garbage_test,
+                       &hazard_ptr_lock_free_stack_test,
+                       &rcu_grace_period_test,
+                       &rcu_concurrent_readers_test,
+                       &semaphore_acquire_release_test,
+                       &semaphore_bounds_concurrency_test,
+                       &latch_wait_for_workers_test,
+                       &barrier_phases_test,
+                       &event_set_reset_test,
+                       &event_ping_pong_test,
+                       &call_once_concurrent_test,
+                       &percpu_slots_test,
+                       &sharded_counter_concurrent_test,
+                       &ref_count_weak_upgrade_test,
+                       &ref_count_biased_test,
+                       &channel_send_recv_test,
+                       &channel_close_wakes_blocked_test,
+                       &channel_batch_mpmc_test,
+                       &rate_limiter_burst_test,
+                       &rate_limiter_refill_test,
+                       &rate_limiter_concurrent_test,
+                       &sharded_rate_limiter_test,
+                       &sharded_rate_limiter_burst_test,
+                       &rate_limiter_simulated_time_test,
+                       &tsc_clock_tracks_high_res_test,
+                       &tsc_to_ns_test,
+                       &coarse_clock_test,
+                       &coarse_clock_ticker_test,
+                       &date_time_format_test,
+                       &date_time_parse_test,
+                       &date_time_round_trip_test,
+                       &histogram_percentiles_test,
+                       &histogram_merge_test,
+                       &histogram_encoding_test,
+                       &trace_collect_test,
+                       &trace_ring_overwrite_test,
+                       &trace_thread_churn_test,
+                       &trace_chrome_json_test,
+                       &metrics_registry_test,
+                       &metrics_prometheus_test,
+                       &metrics_encoding_test,
+                       &metrics_library_test,
+                       &usdt_probes_test,
+                       &profiler_folded_stacks_test,
+                       &profiler_running_thread_test,
+                       &profiler_registered_thread_test,
+                       &profiler_state_test,
+                       &perf_counters_test,
+                       &perf_counter_values_summary_test);
 }
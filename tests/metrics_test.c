@@ -0,0 +1,254 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/metrics.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+#include <string.h>
+
+#define METRICS_THREADS 4
+#define METRICS_UPDATES 10000
+
+struct metrics_test_data {
+    struct aws_metric *counter;
+    struct aws_metric *gauge;
+    struct aws_metric *histogram;
+};
+
+static void metrics_updater_fn(void *arg) {
+    struct metrics_test_data *data = (struct metrics_test_data *)arg;
+
+    for (int i = 1; i <= METRICS_UPDATES; ++i) {
+        aws_metric_counter_add(data->counter, 2);
+        aws_metric_gauge_add(data->gauge, -1);
+        aws_metric_histogram_record(data->histogram, (uint64_t)i);
+    }
+}
+
+/* the sample called name in snapshot, or NULL. */
+static struct aws_metric_sample *find_sample(const struct aws_metrics_snapshot *snapshot, const char *name) {
+    for (size_t i = 0; i < aws_array_list_length(&snapshot->samples); ++i) {
+        struct aws_metric_sample *sample = NULL;
+        aws_array_list_get_at_ptr(&snapshot->samples, (void **)&sample, i);
+        if (!strcmp(sample->name, name)) {
+            return sample;
+        }
+    }
+    return NULL;
+}
+
+/* a registry with a counter, gauge and histogram each updated by several threads. */
+static int fill_registry(struct aws_allocator *allocator, struct aws_metrics_registry *registry) {
+    struct metrics_test_data data;
+    struct aws_thread threads[METRICS_THREADS];
+
+    ASSERT_SUCCESS(aws_metrics_registry_init(registry, allocator), "registry init failed");
+    ASSERT_SUCCESS(aws_metrics_registry_counter(registry, "requests_total", "Requests served.", &data.counter),
+                   "counter registration failed");
+    ASSERT_SUCCESS(aws_metrics_registry_gauge(registry, "queue_depth", "Requests waiting.", &data.gauge),
+                   "gauge registration failed");
+    ASSERT_SUCCESS(aws_metrics_registry_histogram(registry, "latency_ns", "Request latency\\in ns.\n", 1000000000, 3,
+                   &data.histogram), "histogram registration failed");
+
+    aws_metric_gauge_set(data.gauge, 5);
+    for (int i = 0; i < METRICS_THREADS; ++i) {
+        aws_thread_init(&threads[i], allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], metrics_updater_fn, &data, NULL), "thread launch failed");
+    }
+    for (int i = 0; i < METRICS_THREADS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]), "thread join failed");
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    return 0;
+}
+
+static int test_metrics_registry(struct aws_allocator *allocator, void *ctx) {
+    struct aws_metrics_registry registry;
+    struct aws_metrics_snapshot snapshot;
+    struct aws_metric *metric = NULL;
+
+    ASSERT_SUCCESS(fill_registry(allocator, &registry), "filling the registry failed");
+
+    ASSERT_SUCCESS(aws_metrics_registry_counter(&registry, "requests_total", "ignored", &metric),
+                   "registering an existing counter should succeed");
+    aws_metric_counter_add(metric, 1);
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_metrics_registry_gauge(&registry, "requests_total", "", &metric),
+                 "a name can't be reused for another type");
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_metrics_registry_counter(&registry, "0requests", "", &metric),
+                 "names can't start with a digit");
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_metrics_registry_counter(&registry, "req-total", "", &metric),
+                 "names can't contain dashes");
+
+    ASSERT_SUCCESS(aws_metrics_registry_snapshot(&registry, allocator, &snapshot), "snapshot failed");
+    ASSERT_INT_EQUALS(3, aws_array_list_length(&snapshot.samples), "there should be a sample per metric");
+
+    struct aws_metric_sample *sample = find_sample(&snapshot, "requests_total");
+    ASSERT_NOT_NULL(sample, "counter sample is missing");
+    ASSERT_INT_EQUALS(AWS_METRIC_COUNTER, sample->type, "wrong sample type");
+    ASSERT_INT_EQUALS(2 * METRICS_THREADS * METRICS_UPDATES + 1, sample->counter, "counter lost updates");
+
+    sample = find_sample(&snapshot, "queue_depth");
+    ASSERT_NOT_NULL(sample, "gauge sample is missing");
+    ASSERT_INT_EQUALS(5 - METRICS_THREADS * METRICS_UPDATES, sample->gauge, "gauge lost updates");
+
+    sample = find_sample(&snapshot, "latency_ns");
+    ASSERT_NOT_NULL(sample, "histogram sample is missing");
+    ASSERT_INT_EQUALS(METRICS_THREADS * METRICS_UPDATES, sample->histogram.total_count, "histogram lost updates");
+    ASSERT_INT_EQUALS(1, sample->histogram.min, "histogram shards weren't merged");
+    ASSERT_INT_EQUALS(METRICS_UPDATES, sample->histogram.max, "histogram shards weren't merged");
+    uint64_t p50 = aws_histogram_value_at_percentile(&sample->histogram, 50.0);
+    ASSERT_TRUE(p50 >= 4995 && p50 <= 5005, "histogram p50 is off");
+
+    aws_metrics_snapshot_clean_up(&snapshot);
+    aws_metrics_registry_clean_up(&registry);
+    return 0;
+}
+
+AWS_TEST_CASE(metrics_registry_test, test_metrics_registry)
+
+static int test_metrics_prometheus(struct aws_allocator *allocator, void *ctx) {
+    struct aws_metrics_registry registry;
+    struct aws_metrics_snapshot snapshot;
+    char text[2048];
+
+    ASSERT_SUCCESS(fill_registry(allocator, &registry), "filling the registry failed");
+    ASSERT_SUCCESS(aws_metrics_registry_snapshot(&registry, allocator, &snapshot), "snapshot failed");
+
+    FILE *file = tmpfile();
+    ASSERT_NOT_NULL(file, "tmpfile failed");
+    ASSERT_SUCCESS(aws_metrics_snapshot_write_prometheus(&snapshot, file), "writing prometheus text failed");
+    rewind(file);
+    size_t len = fread(text, 1, sizeof(text) - 1, file);
+    text[len] = 0;
+    fclose(file);
+
+    ASSERT_NOT_NULL(strstr(text, "# HELP requests_total Requests served.\n# TYPE requests_total counter\n"
+                                 "requests_total 80000\n"), "counter is missing");
+    ASSERT_NOT_NULL(strstr(text, "# TYPE queue_depth gauge\nqueue_depth -39995\n"), "gauge is missing");
+    ASSERT_NOT_NULL(strstr(text, "# HELP latency_ns Request latency\\\\in ns.\\n\n"), "help should be escaped");
+    ASSERT_NOT_NULL(strstr(text, "# TYPE latency_ns summary\nlatency_ns{quantile=\"0.5\"} "), "summary is missing");
+    ASSERT_NOT_NULL(strstr(text, "latency_ns{quantile=\"0.999\"} "), "p999 is missing");
+    ASSERT_NOT_NULL(strstr(text, "latency_ns_count 40000\n"), "summary count is missing");
+
+    aws_metrics_snapshot_clean_up(&snapshot);
+    aws_metrics_registry_clean_up(&registry);
+    return 0;
+}
+
+AWS_TEST_CASE(metrics_prometheus_test, test_metrics_prometheus)
+
+static int test_metrics_encoding(struct aws_allocator *allocator, void *ctx) {
+    struct aws_metrics_registry registry;
+    struct aws_metrics_snapshot snapshot;
+    struct aws_metrics_snapshot decoded;
+    size_t encoded_len = 0;
+    size_t expected_len = 0;
+
+    ASSERT_SUCCESS(fill_registry(allocator, &registry), "filling the registry failed");
+    ASSERT_SUCCESS(aws_metrics_registry_snapshot(&registry, allocator, &snapshot), "snapshot failed");
+
+    ASSERT_SUCCESS(aws_metrics_snapshot_compute_encoded_len(&snapshot, &expected_len), "compute_encoded_len failed");
+    uint8_t *buffer = (uint8_t *)aws_mem_acquire(allocator, expected_len);
+    ASSERT_NOT_NULL(buffer, "allocation failed");
+    ASSERT_ERROR(AWS_ERROR_INVALID_BUFFER_SIZE, aws_metrics_snapshot_encode(&snapshot, buffer, expected_len - 1,
+                 &encoded_len), "encoding into too small a buffer should fail");
+    ASSERT_SUCCESS(aws_metrics_snapshot_encode(&snapshot, buffer, expected_len, &encoded_len), "encode failed");
+    ASSERT_INT_EQUALS(expected_len, encoded_len, "encoded length should match the computed one");
+
+    ASSERT_SUCCESS(aws_metrics_snapshot_decode(&decoded, allocator, buffer, encoded_len), "decode failed");
+    ASSERT_INT_EQUALS(3, aws_array_list_length(&decoded.samples), "samples are missing");
+    for (size_t i = 0; i < 3; ++i) {
+        struct aws_metric_sample *original = NULL;
+        struct aws_metric_sample *copy = NULL;
+        aws_array_list_get_at_ptr(&snapshot.samples, (void **)&original, i);
+        aws_array_list_get_at_ptr(&decoded.samples, (void **)&copy, i);
+
+        ASSERT_INT_EQUALS(0, strcmp(original->name, copy->name), "names should round trip");
+        ASSERT_INT_EQUALS(0, strcmp(original->help, copy->help), "help should round trip");
+        ASSERT_INT_EQUALS(original->type, copy->type, "types should round trip");
+        ASSERT_INT_EQUALS(original->counter, copy->counter, "counters should round trip");
+        ASSERT_INT_EQUALS(original->gauge, copy->gauge, "gauges should round trip");
+        if (original->type == AWS_METRIC_HISTOGRAM) {
+            ASSERT_INT_EQUALS(original->histogram.total_count, copy->histogram.total_count,
+                              "histograms should round trip");
+        }
+    }
+    aws_metrics_snapshot_clean_up(&decoded);
+
+    ASSERT_ERROR(AWS_ERROR_INVALID_METRICS_ENCODING, aws_metrics_snapshot_decode(&decoded, allocator, buffer,
+                 encoded_len - 1), "a truncated encoding should be rejected");
+    ASSERT_ERROR(AWS_ERROR_INVALID_METRICS_ENCODING, aws_metrics_snapshot_decode(&decoded, allocator, buffer,
+                 encoded_len / 2), "a truncated encoding should be rejected");
+    aws_mem_release(allocator, buffer);
+
+    aws_metrics_snapshot_clean_up(&snapshot);
+    aws_metrics_registry_clean_up(&registry);
+    return 0;
+}
+
+AWS_TEST_CASE(metrics_encoding_test, test_metrics_encoding)
+
+static void contend_fn(void *arg) {
+    struct aws_mutex *mutex = (struct aws_mutex *)arg;
+    aws_mutex_lock(mutex);
+    aws_mutex_unlock(mutex);
+}
+
+static int test_metrics_library(struct aws_allocator *allocator, void *ctx) {
+    struct aws_metrics_snapshot before;
+    struct aws_metrics_snapshot after;
+    struct aws_mutex mutex;
+    struct aws_thread thread;
+
+    struct aws_metrics_registry *registry = aws_metrics_library_registry();
+    ASSERT_NOT_NULL(registry, "the library registry should exist");
+    ASSERT_SUCCESS(aws_metrics_registry_snapshot(registry, allocator, &before), "snapshot failed");
+    ASSERT_SUCCESS(aws_metrics_library_set_enabled(1), "enabling library metrics failed");
+
+    aws_mem_release(allocator, aws_mem_acquire(allocator, 16));
+    aws_raise_error(AWS_ERROR_INVALID_ARGUMENT);
+
+    /* hold the mutex so the thread has to wait for it. */
+    ASSERT_SUCCESS(aws_mutex_init(&mutex, allocator), "mutex init failed");
+    aws_thread_init(&thread, allocator);
+    aws_mutex_lock(&mutex);
+    ASSERT_SUCCESS(aws_thread_launch(&thread, contend_fn, &mutex, NULL), "thread launch failed");
+    aws_thread_current_sleep(20000000);
+    aws_mutex_unlock(&mutex);
+    ASSERT_SUCCESS(aws_thread_join(&thread), "thread join failed");
+    aws_thread_clean_up(&thread);
+    aws_mutex_clean_up(&mutex);
+
+    ASSERT_SUCCESS(aws_metrics_library_set_enabled(0), "disabling library metrics failed");
+    ASSERT_SUCCESS(aws_metrics_registry_snapshot(registry, allocator, &after), "snapshot failed");
+
+    const char *names[] = {
+        "aws_allocations_total", "aws_thread_launches_total", "aws_mutex_contentions_total", "aws_errors_raised_total"
+    };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+        struct aws_metric_sample *old_sample = find_sample(&before, names[i]);
+        struct aws_metric_sample *new_sample = find_sample(&after, names[i]);
+        ASSERT_NOT_NULL(old_sample, "library metric %s is missing", names[i]);
+        ASSERT_NOT_NULL(new_sample, "library metric %s is missing", names[i]);
+        ASSERT_TRUE(new_sample->counter > old_sample->counter, "library metric %s wasn't counted", names[i]);
+    }
+
+    aws_metrics_snapshot_clean_up(&after);
+    aws_metrics_snapshot_clean_up(&before);
+    return 0;
+}
+
+AWS_TEST_CASE(metrics_library_test, test_metrics_library)
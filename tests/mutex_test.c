@@ -104,5 +104,170 @@ static int test_mutex_is_actually_mutex(struct aws_allocator *allocator, void *c
     return 0;
 }
 
+#define PROFILE_TEST_THREADS 4
+#define PROFILE_TEST_ITERATIONS 2000
+
+struct mutex_profile_data {
+    struct aws_mutex hot;
+    size_t counter;
+};
+
+static void mutex_profile_thread_fn(void *arg) {
+    struct mutex_profile_data *data = (struct mutex_profile_data *)arg;
+
+    for (int i = 0; i < PROFILE_TEST_ITERATIONS; ++i) {
+        aws_mutex_lock(&data->hot);
+        data->counter++;
+        if (i % 50 == 0) {
+            /* hold the lock long enough for the others to pile up behind it. */
+            aws_thread_current_sleep(100000);
+        }
+        aws_mutex_unlock(&data->hot);
+    }
+}
+
+static int test_mutex_contention_profile(struct aws_allocator *allocator, void *ctx) {
+    struct mutex_profile_data data = { .counter = 0 };
+    struct aws_mutex quiet;
+    aws_mutex_init(&data.hot, allocator);
+    aws_mutex_init(&quiet, allocator);
+
+    aws_mutex_profiling_reset();
+    aws_mutex_profiling_set_enabled(1);
+    ASSERT_TRUE(aws_mutex_profiling_enabled(), "profiling should be on");
+
+    struct aws_thread threads[PROFILE_TEST_THREADS];
+    for (int i = 0; i < PROFILE_TEST_THREADS; ++i) {
+        aws_thread_init(&threads[i], allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], mutex_profile_thread_fn, &data, 0), "thread creation failed");
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        aws_mutex_lock(&quiet);
+        aws_mutex_unlock(&quiet);
+    }
+
+    for (int i = 0; i < PROFILE_TEST_THREADS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]), "thread join failed");
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    aws_mutex_profiling_set_enabled(0);
+    ASSERT_INT_EQUALS(PROFILE_TEST_THREADS * PROFILE_TEST_ITERATIONS, data.counter, "profiling broke mutual exclusion");
+
+    struct aws_array_list stats;
+    ASSERT_SUCCESS(aws_mutex_profiling_report(allocator, &stats), "report failed");
+
+    struct aws_mutex_contention_stats *top = NULL;
+    ASSERT_SUCCESS(aws_array_list_get_at_ptr(&stats, (void **)&top, 0), "the report should not be empty");
+    ASSERT_PTR_EQUALS(&data.hot, top->mutex, "the contended mutex should be ranked first");
+
+    uint64_t hot_acquisitions = 0, hot_contentions = 0, hot_hold = 0, quiet_acquisitions = 0, quiet_contentions = 0;
+    for (size_t i = 0; i < aws_array_list_length(&stats); ++i) {
+        struct aws_mutex_contention_stats *entry = NULL;
+        aws_array_list_get_at_ptr(&stats, (void **)&entry, i);
+        ASSERT_NOT_NULL(entry->call_site, "every entry should have a call site");
+
+        if (entry->mutex == &data.hot) {
+            hot_acquisitions += entry->acquisitions;
+            hot_contentions += entry->contentions;
+            hot_hold += entry->hold_ns;
+        }
+        else if (entry->mutex == &quiet) {
+            quiet_acquisitions += entry->acquisitions;
+            quiet_contentions += entry->contentions;
+        }
+    }
+
+    ASSERT_INT_EQUALS(PROFILE_TEST_THREADS * PROFILE_TEST_ITERATIONS, hot_acquisitions,
+                      "every acquisition should be counted");
+    ASSERT_TRUE(hot_contentions > 0, "the hot mutex should have seen contention");
+    ASSERT_TRUE(hot_hold >= (uint64_t)PROFILE_TEST_THREADS * (PROFILE_TEST_ITERATIONS / 50) * 100000,
+                "hold time should include the sleeps");
+    ASSERT_INT_EQUALS(100, quiet_acquisitions, "every acquisition should be counted");
+    ASSERT_INT_EQUALS(0, quiet_contentions, "the quiet mutex should never be contended");
+    aws_array_list_clean_up(&stats);
+
+    /* with profiling off, nothing more is recorded. */
+    aws_mutex_lock(&quiet);
+    aws_mutex_unlock(&quiet);
+    ASSERT_SUCCESS(aws_mutex_profiling_report(allocator, &stats), "report failed");
+    for (size_t i = 0; i < aws_array_list_length(&stats); ++i) {
+        struct aws_mutex_contention_stats *entry = NULL;
+        aws_array_list_get_at_ptr(&stats, (void **)&entry, i);
+        if (entry->mutex == &quiet) {
+            ASSERT_INT_EQUALS(100, entry->acquisitions, "acquisitions with profiling off should not be counted");
+        }
+    }
+    aws_array_list_clean_up(&stats);
+
+    FILE *out = tmpfile();
+    ASSERT_NOT_NULL(out, "tmpfile failed");
+    ASSERT_SUCCESS(aws_mutex_profiling_dump(out, 5), "dump failed");
+    ASSERT_TRUE(ftell(out) > 0, "the dump should not be empty");
+    fclose(out);
+
+    aws_mutex_profiling_reset();
+    aws_mutex_clean_up(&quiet);
+    aws_mutex_clean_up(&data.hot);
+
+    return 0;
+}
+
+#define PROFILE_CHURN_THREADS 64
+#define PROFILE_CHURN_ITERATIONS 10
+
+static void mutex_profile_churn_fn(void *arg) {
+    struct mutex_profile_data *data = (struct mutex_profile_data *)arg;
+
+    for (int i = 0; i < PROFILE_CHURN_ITERATIONS; ++i) {
+        aws_mutex_lock(&data->hot);
+        data->counter++;
+        aws_mutex_unlock(&data->hot);
+    }
+}
+
+/* threads that come and go hand their buffers on, and what they recorded still shows up in the report. */
+static int test_mutex_profile_thread_churn(struct aws_allocator *allocator, void *ctx) {
+    struct mutex_profile_data data = { .counter = 0 };
+    aws_mutex_init(&data.hot, allocator);
+
+    aws_mutex_profiling_reset();
+    aws_mutex_profiling_set_enabled(1);
+
+    for (int i = 0; i < PROFILE_CHURN_THREADS; ++i) {
+        struct aws_thread thread;
+        aws_thread_init(&thread, allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&thread, mutex_profile_churn_fn, &data, 0), "thread creation failed");
+        ASSERT_SUCCESS(aws_thread_join(&thread), "thread join failed");
+        aws_thread_clean_up(&thread);
+    }
+
+    aws_mutex_profiling_set_enabled(0);
+
+    struct aws_array_list stats;
+    ASSERT_SUCCESS(aws_mutex_profiling_report(allocator, &stats), "report failed");
+
+    uint64_t acquisitions = 0;
+    for (size_t i = 0; i < aws_array_list_length(&stats); ++i) {
+        struct aws_mutex_contention_stats *entry = NULL;
+        aws_array_list_get_at_ptr(&stats, (void **)&entry, i);
+        if (entry->mutex == &data.hot) {
+            acquisitions += entry->acquisitions;
+        }
+    }
+    aws_array_list_clean_up(&stats);
+
+    ASSERT_INT_EQUALS(PROFILE_CHURN_THREADS * PROFILE_CHURN_ITERATIONS, acquisitions,
+                      "acquisitions of exited threads should be counted");
+
+    aws_mutex_profiling_reset();
+    aws_mutex_clean_up(&data.hot);
+
+    return 0;
+}
+
 AWS_TEST_CASE(mutex_aquire_release_test, test_mutex_acquire_release)
-AWS_TEST_CASE(mutex_is_actually_mutex_test, test_mutex_is_actually_mutex)
\ No newline at end of file
+AWS_TEST_CASE(mutex_is_actually_mutex_test, test_mutex_is_actually_mutex)
+AWS_TEST_CASE(mutex_contention_profile_test, test_mutex_contention_profile)
+AWS_TEST_CASE(mutex_profile_thread_churn_test, test_mutex_profile_thread_churn)
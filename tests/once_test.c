@@ -0,0 +1,80 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/once.h>
+#include <aws/common/barrier.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+
+#define ONCE_TEST_THREADS 8
+
+struct once_test_data {
+    struct aws_once once;
+    struct aws_barrier start;
+    /* written only by the once function, so readers rely on aws_call_once() for visibility. */
+    size_t calls;
+    size_t value;
+    struct aws_atomic_var failed;
+};
+
+static void once_init_fn(void *user_data) {
+    struct once_test_data *data = (struct once_test_data *)user_data;
+    /* stay in the function long enough for the other threads to pile up behind it. */
+    aws_thread_current_sleep(10000000);
+    data->value = 42;
+    data->calls++;
+}
+
+static void once_thread_fn(void *arg) {
+    struct once_test_data *data = (struct once_test_data *)arg;
+
+    aws_barrier_wait(&data->start);
+    aws_call_once(&data->once, once_init_fn, data);
+
+    if (data->value != 42) {
+        aws_atomic_store_int(&data->failed, 1);
+    }
+}
+
+static int test_call_once_concurrent(struct aws_allocator *allocator, void *ctx) {
+    struct once_test_data data = {
+        .once = AWS_ONCE_INIT,
+        .calls = 0,
+        .value = 0,
+    };
+    aws_barrier_init(&data.start, ONCE_TEST_THREADS);
+    aws_atomic_init_int(&data.failed, 0);
+
+    struct aws_thread threads[ONCE_TEST_THREADS];
+    for (int i = 0; i < ONCE_TEST_THREADS; ++i) {
+        aws_thread_init(&threads[i], allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], once_thread_fn, &data, 0), "thread creation failed");
+    }
+
+    for (int i = 0; i < ONCE_TEST_THREADS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]), "thread join failed");
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    ASSERT_INT_EQUALS(1, data.calls, "the function should run exactly once");
+    ASSERT_INT_EQUALS(0, aws_atomic_load_int(&data.failed), "every caller should see the initialized value");
+
+    aws_call_once(&data.once, once_init_fn, &data);
+    ASSERT_INT_EQUALS(1, data.calls, "later calls should not run the function again");
+
+    return 0;
+}
+
+AWS_TEST_CASE(call_once_concurrent_test, test_call_once_concurrent)
@@ -0,0 +1,81 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/percpu.h>
+#include <aws/common/system_info.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+
+static int test_percpu_slots(struct aws_allocator *allocator, void *ctx) {
+    struct aws_percpu percpu;
+    ASSERT_SUCCESS(aws_percpu_init(&percpu, allocator, 24), "init failed");
+
+    size_t slot_count = aws_percpu_slot_count(&percpu);
+    ASSERT_TRUE(slot_count >= aws_system_info_processor_count(), "there should be a slot per processor");
+    ASSERT_INT_EQUALS(0, slot_count & (slot_count - 1), "the slot count should be a power of two");
+
+    for (size_t i = 0; i < slot_count; ++i) {
+        uint8_t *slot = (uint8_t *)aws_percpu_get(&percpu, i);
+        ASSERT_INT_EQUALS(0, (uintptr_t)slot % AWS_CACHE_LINE, "slots should be cache line aligned");
+        for (size_t j = 0; j < 24; ++j) {
+            ASSERT_INT_EQUALS(0, slot[j], "slots should start zeroed");
+        }
+        memset(slot, 0xFF, 24);
+    }
+
+    uint8_t *current = (uint8_t *)aws_percpu_this_cpu(&percpu);
+    ASSERT_TRUE(current >= (uint8_t *)aws_percpu_get(&percpu, 0) &&
+                current <= (uint8_t *)aws_percpu_get(&percpu, slot_count - 1), "the current slot should be a slot");
+
+    aws_percpu_clean_up(&percpu);
+    return 0;
+}
+
+#define SHARDED_COUNTER_THREADS 8
+#define SHARDED_COUNTER_INCREMENTS 100000
+
+static void sharded_counter_thread_fn(void *arg) {
+    struct aws_sharded_counter *counter = (struct aws_sharded_counter *)arg;
+
+    for (int i = 0; i < SHARDED_COUNTER_INCREMENTS; ++i) {
+        aws_sharded_counter_add(counter, 1);
+    }
+}
+
+static int test_sharded_counter_concurrent(struct aws_allocator *allocator, void *ctx) {
+    struct aws_sharded_counter counter;
+    ASSERT_SUCCESS(aws_sharded_counter_init(&counter, allocator), "init failed");
+    ASSERT_INT_EQUALS(0, aws_sharded_counter_sum(&counter), "a new counter should be zero");
+
+    struct aws_thread threads[SHARDED_COUNTER_THREADS];
+    for (int i = 0; i < SHARDED_COUNTER_THREADS; ++i) {
+        aws_thread_init(&threads[i], allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], sharded_counter_thread_fn, &counter, 0), "thread creation failed");
+    }
+
+    for (int i = 0; i < SHARDED_COUNTER_THREADS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]), "thread join failed");
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    ASSERT_INT_EQUALS(SHARDED_COUNTER_THREADS * SHARDED_COUNTER_INCREMENTS, aws_sharded_counter_sum(&counter),
+                      "no increment should be lost");
+
+    aws_sharded_counter_clean_up(&counter);
+    return 0;
+}
+
+AWS_TEST_CASE(percpu_slots_test, test_percpu_slots)
+AWS_TEST_CASE(sharded_counter_concurrent_test, test_sharded_counter_concurrent)
@@ -0,0 +1,113 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/perf_counters.h>
+#include <aws_test_harness.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PERF_COUNTERS_TEST_ITERATIONS 1000000
+
+static int test_perf_counters(struct aws_allocator *allocator, void *ctx) {
+    struct aws_perf_counters counters;
+    struct aws_perf_counter_values values;
+
+    /* without any counters (e.g. in a VM without a PMU, or off Linux) everything still works, and counts nothing. */
+    if (aws_perf_counters_init(&counters)) {
+        ASSERT_INT_EQUALS(AWS_ERROR_UNSUPPORTED_OPERATION, aws_last_error(), "init failed");
+    }
+
+    aws_perf_counters_start(&counters);
+    volatile uint64_t sum = 0;
+    for (uint64_t i = 0; i < PERF_COUNTERS_TEST_ITERATIONS; ++i) {
+        sum += i;
+    }
+    aws_perf_counters_stop(&counters, &values);
+
+    ASSERT_TRUE((values.available & ~AWS_PERF_COUNTER_ALL) == 0, "only known counters should be reported");
+    for (int i = 0; i < AWS_PERF_COUNTER_COUNT; ++i) {
+        if (!(values.available & (1u << i))) {
+            ASSERT_INT_EQUALS(0, values.counts[i], "a missing counter should read 0");
+        }
+    }
+    if (aws_perf_counter_values_has(&values, 1u << AWS_PERF_COUNTER_INSTRUCTIONS)) {
+        ASSERT_TRUE(values.counts[AWS_PERF_COUNTER_INSTRUCTIONS] >= PERF_COUNTERS_TEST_ITERATIONS,
+                "the loop takes at least an instruction per iteration");
+    }
+    if (aws_perf_counter_values_has(&values, 1u << AWS_PERF_COUNTER_TASK_CLOCK)) {
+        ASSERT_TRUE(values.counts[AWS_PERF_COUNTER_TASK_CLOCK] > 0, "the loop takes CPU time");
+    }
+
+    /* counting again starts from zero. */
+    struct aws_perf_counter_values idle;
+    aws_perf_counters_start(&counters);
+    aws_perf_counters_stop(&counters, &idle);
+    if (aws_perf_counter_values_has(&values, 1u << AWS_PERF_COUNTER_INSTRUCTIONS)) {
+        ASSERT_TRUE(idle.counts[AWS_PERF_COUNTER_INSTRUCTIONS] < values.counts[AWS_PERF_COUNTER_INSTRUCTIONS],
+                "start should reset the counters");
+    }
+
+    aws_perf_counters_clean_up(&counters);
+    return 0;
+}
+
+AWS_TEST_CASE(perf_counters_test, test_perf_counters)
+
+static int check_summary(const struct aws_perf_counter_values *values, const char *expected) {
+    char line[256];
+    FILE *out = tmpfile();
+    ASSERT_NOT_NULL(out, "tmpfile failed");
+
+    ASSERT_SUCCESS(aws_perf_counter_values_write_summary(out, values), "write failed");
+    rewind(out);
+    ASSERT_NOT_NULL(fgets(line, sizeof(line), out), "the summary should be written");
+    fclose(out);
+
+    ASSERT_STR_EQUALS(expected, line, "unexpected summary");
+    return 0;
+}
+
+static int test_perf_counter_values_summary(struct aws_allocator *allocator, void *ctx) {
+    struct aws_perf_counter_values values;
+    memset(&values, 0, sizeof(values));
+    ASSERT_SUCCESS(check_summary(&values, "hardware counters unavailable\n"), "summary");
+
+    values.counts[AWS_PERF_COUNTER_CYCLES] = 2000;
+    values.counts[AWS_PERF_COUNTER_INSTRUCTIONS] = 3000;
+    values.counts[AWS_PERF_COUNTER_CACHE_MISSES] = 6;
+    values.counts[AWS_PERF_COUNTER_BRANCH_MISSES] = 15;
+    values.counts[AWS_PERF_COUNTER_TASK_CLOCK] = 1000;
+    values.available = AWS_PERF_COUNTER_ALL;
+    ASSERT_SUCCESS(check_summary(&values,
+            "1.50 IPC, 2.00 cache misses/kinstr, 5.00 branch misses/kinstr, 2.00 GHz\n"), "summary");
+
+    /* rates are only reported when everything they need was counted. */
+    values.available &= ~(1u << AWS_PERF_COUNTER_CYCLES);
+    ASSERT_SUCCESS(check_summary(&values, "2.00 cache misses/kinstr, 5.00 branch misses/kinstr\n"), "summary");
+    ASSERT_TRUE(aws_perf_counter_values_ipc(&values) == 0.0, "no IPC without cycles");
+
+    /* totals keep only the counters every part had. */
+    struct aws_perf_counter_values total;
+    memset(&total, 0, sizeof(total));
+    total.available = AWS_PERF_COUNTER_ALL;
+    aws_perf_counter_values_add(&total, &values);
+    aws_perf_counter_values_add(&total, &values);
+    ASSERT_INT_EQUALS(values.available, total.available, "missing counters should stay missing");
+    ASSERT_INT_EQUALS(6000, total.counts[AWS_PERF_COUNTER_INSTRUCTIONS], "counts should be summed");
+
+    return 0;
+}
+
+AWS_TEST_CASE(perf_counter_values_summary_test, test_perf_counter_values_summary)
@@ -0,0 +1,137 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/common.h>
+#include <aws/common/private/probes.h>
+#include <aws_test_harness.h>
+
+#if AWS_PROBES_ENABLED
+#include <elf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *expected_probes[] = {
+    "mem_acquire", "mem_release", "raise_error", "mutex_lock", "mutex_unlock", "thread_launch", "thread_exit",
+    "priority_queue_push", "priority_queue_pop", "array_list_grow",
+};
+
+/* finds the file mapped at address, i.e. the test binary or the shared library, from /proc/self/maps. */
+static int find_mapped_file(const void *address, char *path, size_t path_size) {
+    char line[1024];
+    int found = 0;
+    FILE *maps = fopen("/proc/self/maps", "r");
+    if (!maps) {
+        return 0;
+    }
+
+    while (!found && fgets(line, sizeof(line), maps)) {
+        unsigned long start = 0;
+        unsigned long end = 0;
+        char *file = NULL;
+        if (sscanf(line, "%lx-%lx", &start, &end) == 2 && (uintptr_t)address >= start && (uintptr_t)address < end &&
+                (file = strchr(line, '/'))) {
+            file[strcspn(file, "\n")] = 0;
+            snprintf(path, path_size, "%s", file);
+            found = 1;
+        }
+    }
+
+    fclose(maps);
+    return found;
+}
+
+static uint8_t *read_file(const char *path, size_t *len) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    *len = (size_t)ftell(file);
+    rewind(file);
+
+    uint8_t *contents = (uint8_t *)malloc(*len);
+    if (contents && fread(contents, 1, *len, file) != *len) {
+        free(contents);
+        contents = NULL;
+    }
+
+    fclose(file);
+    return contents;
+}
+
+/* sets found[i] if image has a stapsdt note for expected_probes[i] from our provider. */
+static void scan_probe_notes(const uint8_t *image, size_t len, int *found) {
+    const Elf64_Ehdr *header = (const Elf64_Ehdr *)image;
+    if (len < sizeof(Elf64_Ehdr) || memcmp(header->e_ident, ELFMAG, SELFMAG) ||
+            header->e_ident[EI_CLASS] != ELFCLASS64 || header->e_shoff + (size_t)header->e_shnum * sizeof(Elf64_Shdr) > len) {
+        return;
+    }
+
+    const Elf64_Shdr *sections = (const Elf64_Shdr *)(image + header->e_shoff);
+    const char *section_names = (const char *)(image + sections[header->e_shstrndx].sh_offset);
+
+    for (size_t s = 0; s < header->e_shnum; ++s) {
+        if (sections[s].sh_type != SHT_NOTE || strcmp(section_names + sections[s].sh_name, ".note.stapsdt")) {
+            continue;
+        }
+
+        const uint8_t *note = image + sections[s].sh_offset;
+        const uint8_t *notes_end = note + sections[s].sh_size;
+        while (note + sizeof(Elf64_Nhdr) <= notes_end) {
+            const Elf64_Nhdr *note_header = (const Elf64_Nhdr *)note;
+            const char *owner = (const char *)(note + sizeof(Elf64_Nhdr));
+            /* the pc, base and semaphore addresses come before the strings. */
+            const char *provider = owner + ((note_header->n_namesz + 3) & ~3u) + 3 * sizeof(uint64_t);
+            const char *name = provider + strlen(provider) + 1;
+
+            if (note_header->n_type == 3 && !strcmp(owner, "stapsdt") && !strcmp(provider, "aws_c_common")) {
+                for (size_t i = 0; i < sizeof(expected_probes) / sizeof(expected_probes[0]); ++i) {
+                    found[i] |= !strcmp(name, expected_probes[i]);
+                }
+            }
+
+            note += sizeof(Elf64_Nhdr) + ((note_header->n_namesz + 3) & ~3u) + ((note_header->n_descsz + 3) & ~3u);
+        }
+    }
+}
+
+static int test_usdt_probes(struct aws_allocator *allocator, void *ctx) {
+    char path[512];
+    size_t len = 0;
+    int found[sizeof(expected_probes) / sizeof(expected_probes[0])] = { 0 };
+
+    ASSERT_TRUE(find_mapped_file((const void *)(uintptr_t)&aws_raise_error, path, sizeof(path)),
+                "couldn't find the file the library is loaded from");
+    uint8_t *image = read_file(path, &len);
+    ASSERT_NOT_NULL(image, "couldn't read %s", path);
+    scan_probe_notes(image, len, found);
+    free(image);
+
+    for (size_t i = 0; i < sizeof(expected_probes) / sizeof(expected_probes[0]); ++i) {
+        ASSERT_TRUE(found[i], "probe %s is missing from %s", expected_probes[i], path);
+    }
+
+    return 0;
+}
+#else
+static int test_usdt_probes(struct aws_allocator *allocator, void *ctx) {
+    /* built without probes, or for a platform they aren't supported on. */
+    return 0;
+}
+#endif
+
+AWS_TEST_CASE(usdt_probes_test, test_usdt_probes)
@@ -0,0 +1,252 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/profiler.h>
+#include <aws/common/atomics.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+#define PROFILER_TEST_CPU_NS 200000000ULL
+
+struct spin_data {
+    struct aws_atomic_var go;
+};
+
+/* burns CPU time, so the thread's SIGPROF timer fires. */
+static void spin_thread_fn(void *arg) {
+    struct spin_data *data = (struct spin_data *)arg;
+    struct aws_thread_stats stats;
+
+    while (!aws_atomic_load_int(&data->go)) {
+        aws_thread_current_sleep(1000000);
+    }
+
+    uint64_t start_ns = 0;
+    aws_thread_current_stats(&stats);
+    start_ns = stats.cpu_time_ns;
+    do {
+        aws_thread_current_stats(&stats);
+    } while (stats.cpu_time_ns - start_ns < PROFILER_TEST_CPU_NS);
+}
+
+/* checks out has one "frames count" line per stack, and returns the sum of the counts and of those of stacks with more
+ * than one frame. */
+static int read_folded(FILE *out, size_t *total, size_t *unwound) {
+    char line[8192];
+    *total = 0;
+    *unwound = 0;
+
+    rewind(out);
+    while (fgets(line, sizeof(line), out)) {
+        char *end = line + strlen(line);
+        ASSERT_TRUE(end > line && end[-1] == '\n', "every line should be complete");
+        *--end = '\0';
+
+        char *space = strrchr(line, ' ');
+        ASSERT_NOT_NULL(space, "a line should end in its count: %s", line);
+        ASSERT_TRUE(space > line, "a line should start with its stack");
+
+        unsigned long long count = 0;
+        ASSERT_INT_EQUALS(1, sscanf(space + 1, "%llu", &count), "the count should be a number");
+        ASSERT_TRUE(count > 0, "only stacks that were sampled should be written");
+        *total += (size_t)count;
+        if (memchr(line, ';', (size_t)(space - line))) {
+            *unwound += (size_t)count;
+        }
+    }
+
+    return AWS_OP_SUCCESS;
+}
+
+static int run_profile(struct aws_allocator *allocator, const struct aws_profiler_options *options,
+        int start_first, int *supported) {
+    struct spin_data data;
+    struct aws_thread thread;
+    aws_atomic_init_int(&data.go, 0);
+    aws_thread_init(&thread, allocator);
+    *supported = 1;
+
+    if (!start_first) {
+        ASSERT_SUCCESS(aws_thread_launch(&thread, spin_thread_fn, &data, NULL), "thread launch failed");
+    }
+
+    if (aws_profiler_start(allocator, options)) {
+        ASSERT_INT_EQUALS(AWS_ERROR_UNSUPPORTED_OPERATION, aws_last_error(), "start failed");
+        *supported = 0;
+        if (!start_first) {
+            aws_atomic_store_int(&data.go, 1);
+            aws_thread_join(&thread);
+            aws_thread_clean_up(&thread);
+        }
+        return AWS_OP_SUCCESS;
+    }
+
+    if (start_first) {
+        ASSERT_SUCCESS(aws_thread_launch(&thread, spin_thread_fn, &data, NULL), "thread launch failed");
+    }
+
+    aws_atomic_store_int(&data.go, 1);
+    ASSERT_SUCCESS(aws_thread_join(&thread), "thread join failed");
+    aws_thread_clean_up(&thread);
+    ASSERT_SUCCESS(aws_profiler_stop(), "stop failed");
+
+    return AWS_OP_SUCCESS;
+}
+
+static int test_profiler_folded_stacks(struct aws_allocator *allocator, void *ctx) {
+    struct aws_profiler_options options = {
+        .frequency_hz = 1000,
+        .max_samples = 4096,
+        .max_depth = 64,
+    };
+    int supported = 0;
+
+    /* a thread launched during the profile is sampled from its start. */
+    ASSERT_SUCCESS(run_profile(allocator, &options, 1, &supported), "profile failed");
+    if (!supported) {
+        return AWS_OP_SUCCESS;
+    }
+
+    /* 200 ms of CPU time is 20 samples even where the kernel only checks CPU timers 100 times a second. */
+    size_t samples = aws_profiler_sample_count();
+    ASSERT_TRUE(samples >= 10, "the spinning thread should have been sampled, got %zu samples", samples);
+    ASSERT_INT_EQUALS(0, aws_profiler_dropped_count(), "there was room for every sample");
+
+    FILE *out = tmpfile();
+    ASSERT_NOT_NULL(out, "tmpfile failed");
+    ASSERT_SUCCESS(aws_profiler_write_folded(out), "write failed");
+
+    size_t total = 0;
+    size_t unwound = 0;
+    ASSERT_SUCCESS(read_folded(out, &total, &unwound), "bad folded output");
+    ASSERT_INT_EQUALS(samples, total, "every sample should be in the output once");
+    ASSERT_TRUE(unwound > 0, "stacks should be walked past the interrupted frame");
+    fclose(out);
+
+    aws_profiler_clean_up();
+    ASSERT_INT_EQUALS(0, aws_profiler_sample_count(), "clean up should discard the samples");
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(profiler_folded_stacks_test, test_profiler_folded_stacks)
+
+static int test_profiler_running_thread(struct aws_allocator *allocator, void *ctx) {
+    struct aws_profiler_options options = {
+        .frequency_hz = 1000,
+        .max_samples = 8,
+        .max_depth = 16,
+    };
+    int supported = 0;
+
+    /* a thread already running when the profile starts is sampled too, and samples past max_samples are dropped. */
+    ASSERT_SUCCESS(run_profile(allocator, &options, 0, &supported), "profile failed");
+    if (!supported) {
+        return AWS_OP_SUCCESS;
+    }
+
+    ASSERT_INT_EQUALS(8, aws_profiler_sample_count(), "max_samples should be kept");
+    ASSERT_TRUE(aws_profiler_dropped_count() > 0, "samples past max_samples should be counted as dropped");
+
+    FILE *out = tmpfile();
+    ASSERT_NOT_NULL(out, "tmpfile failed");
+    ASSERT_SUCCESS(aws_profiler_write_folded(out), "write failed");
+
+    size_t total = 0;
+    size_t unwound = 0;
+    ASSERT_SUCCESS(read_folded(out, &total, &unwound), "bad folded output");
+    ASSERT_INT_EQUALS(8, total, "every kept sample should be in the output once");
+    fclose(out);
+
+    aws_profiler_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(profiler_running_thread_test, test_profiler_running_thread)
+
+#if !defined(_WIN32)
+static void *registered_thread_fn(void *arg) {
+    aws_profiler_register_current_thread();
+    spin_thread_fn(arg);
+    return NULL;
+}
+#endif
+
+static int test_profiler_registered_thread(struct aws_allocator *allocator, void *ctx) {
+#if !defined(_WIN32)
+    struct aws_profiler_options options = {
+        .frequency_hz = 1000,
+        .max_samples = 4096,
+        .max_depth = 16,
+    };
+
+    if (aws_profiler_start(allocator, &options)) {
+        ASSERT_INT_EQUALS(AWS_ERROR_UNSUPPORTED_OPERATION, aws_last_error(), "start failed");
+        return AWS_OP_SUCCESS;
+    }
+
+    /* a thread the library didn't start is sampled once it registers, and its timer goes away when it exits. */
+    struct spin_data data;
+    aws_atomic_init_int(&data.go, 1);
+    pthread_t thread;
+    ASSERT_INT_EQUALS(0, pthread_create(&thread, NULL, registered_thread_fn, &data), "thread creation failed");
+    ASSERT_INT_EQUALS(0, pthread_join(thread, NULL), "thread join failed");
+
+    ASSERT_SUCCESS(aws_profiler_stop(), "stop failed");
+    ASSERT_TRUE(aws_profiler_sample_count() >= 10, "the registered thread should have been sampled");
+    aws_profiler_clean_up();
+#endif
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(profiler_registered_thread_test, test_profiler_registered_thread)
+
+static int test_profiler_state(struct aws_allocator *allocator, void *ctx) {
+    struct aws_profiler_options options = {
+        .frequency_hz = 100,
+        .max_samples = 16,
+        .max_depth = 8,
+    };
+
+    if (aws_profiler_start(allocator, &options)) {
+        ASSERT_INT_EQUALS(AWS_ERROR_UNSUPPORTED_OPERATION, aws_last_error(), "start failed");
+        return AWS_OP_SUCCESS;
+    }
+
+    ASSERT_ERROR(AWS_ERROR_INVALID_STATE, aws_profiler_start(allocator, &options), "already running");
+    ASSERT_SUCCESS(aws_profiler_register_current_thread(), "register failed");
+    ASSERT_SUCCESS(aws_profiler_stop(), "stop failed");
+    ASSERT_ERROR(AWS_ERROR_INVALID_STATE, aws_profiler_stop(), "already stopped");
+
+    options.frequency_hz = 0;
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_profiler_start(allocator, &options), "bad options");
+    options.frequency_hz = 100;
+    options.max_samples = 0;
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_profiler_start(allocator, &options), "bad options");
+
+    aws_profiler_clean_up();
+
+    return AWS_OP_SUCCESS;
+}
+
+AWS_TEST_CASE(profiler_state_test, test_profiler_state)
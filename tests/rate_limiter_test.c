@@ -0,0 +1,213 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/rate_limiter.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+
+static int test_rate_limiter_burst(struct aws_allocator *allocator, void *ctx) {
+    struct aws_rate_limiter limiter;
+    struct aws_rate_limiter_options options = { .tokens_per_second = 1, .burst = 10 };
+
+    struct aws_rate_limiter_options bad_options = { .tokens_per_second = 0, .burst = 10 };
+    ASSERT_ERROR(AWS_ERROR_INVALID_ARGUMENT, aws_rate_limiter_init(&limiter, &bad_options), "a zero rate is invalid");
+    ASSERT_SUCCESS(aws_rate_limiter_init(&limiter, &options), "init failed");
+
+    uint64_t wait_ns = 1;
+    ASSERT_SUCCESS(aws_rate_limiter_time_until_available(&limiter, 10, &wait_ns), "time_until_available failed");
+    ASSERT_INT_EQUALS(0, wait_ns, "a new limiter should have a full bucket");
+
+    ASSERT_SUCCESS(aws_rate_limiter_try_acquire(&limiter, 4), "acquire failed");
+    for (int i = 0; i < 6; ++i) {
+        ASSERT_SUCCESS(aws_rate_limiter_try_acquire(&limiter, 1), "acquire failed");
+    }
+    ASSERT_ERROR(AWS_ERROR_RATE_LIMIT_EXCEEDED, aws_rate_limiter_try_acquire(&limiter, 1),
+                 "the bucket should be empty");
+
+    ASSERT_SUCCESS(aws_rate_limiter_time_until_available(&limiter, 2, &wait_ns), "time_until_available failed");
+    ASSERT_TRUE(wait_ns > 1900000000 && wait_ns <= 2000000000, "two tokens should take about two seconds");
+    ASSERT_ERROR(AWS_ERROR_RATE_LIMIT_EXCEEDED, aws_rate_limiter_time_until_available(&limiter, 11, &wait_ns),
+                 "more tokens than the burst are never available");
+
+    return 0;
+}
+
+static int test_rate_limiter_refill(struct aws_allocator *allocator, void *ctx) {
+    struct aws_rate_limiter limiter;
+    struct aws_rate_limiter_options options = { .tokens_per_second = 1000, .burst = 5 };
+    ASSERT_SUCCESS(aws_rate_limiter_init(&limiter, &options), "init failed");
+
+    ASSERT_SUCCESS(aws_rate_limiter_try_acquire(&limiter, 5), "acquire failed");
+    ASSERT_ERROR(AWS_ERROR_RATE_LIMIT_EXCEEDED, aws_rate_limiter_try_acquire(&limiter, 5),
+                 "the bucket should be empty");
+
+    aws_thread_current_sleep(20000000);
+
+    /* 20ms earns 20 tokens, but the bucket only holds 5. */
+    ASSERT_SUCCESS(aws_rate_limiter_try_acquire(&limiter, 5), "the bucket should have refilled");
+    ASSERT_ERROR(AWS_ERROR_RATE_LIMIT_EXCEEDED, aws_rate_limiter_try_acquire(&limiter, 5),
+                 "the bucket should not refill past its burst");
+
+    return 0;
+}
+
+#define RATE_LIMITER_THREADS 4
+#define RATE_LIMITER_BURST 10000
+
+struct rate_limiter_test_data {
+    struct aws_rate_limiter limiter;
+    struct aws_atomic_var acquired;
+};
+
+static void rate_limiter_contender_fn(void *arg) {
+    struct rate_limiter_test_data *data = (struct rate_limiter_test_data *)arg;
+    size_t acquired = 0;
+
+    for (int i = 0; i < RATE_LIMITER_BURST; ++i) {
+        if (!aws_rate_limiter_try_acquire(&data->limiter, 1)) {
+            acquired++;
+        }
+    }
+
+    aws_atomic_fetch_add(&data->acquired, acquired);
+}
+
+static int test_rate_limiter_concurrent(struct aws_allocator *allocator, void *ctx) {
+    struct rate_limiter_test_data data;
+    struct aws_rate_limiter_options options = { .tokens_per_second = 1, .burst = RATE_LIMITER_BURST };
+    ASSERT_SUCCESS(aws_rate_limiter_init(&data.limiter, &options), "init failed");
+    aws_atomic_init_int(&data.acquired, 0);
+
+    struct aws_thread threads[RATE_LIMITER_THREADS];
+    for (int i = 0; i < RATE_LIMITER_THREADS; ++i) {
+        aws_thread_init(&threads[i], allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], rate_limiter_contender_fn, &data, 0), "thread creation failed");
+    }
+    for (int i = 0; i < RATE_LIMITER_THREADS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]), "thread join failed");
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    /* the test may run long enough to earn a token or two on top of the burst, but no more. */
+    size_t acquired = aws_atomic_load_int(&data.acquired);
+    ASSERT_TRUE(acquired >= RATE_LIMITER_BURST && acquired <= RATE_LIMITER_BURST + 2,
+                "exactly the burst should be handed out under contention");
+
+    return 0;
+}
+
+static int test_sharded_rate_limiter(struct aws_allocator *allocator, void *ctx) {
+    struct aws_sharded_rate_limiter limiter;
+    struct aws_rate_limiter_options options = { .tokens_per_second = 1000, .burst = 1 };
+    ASSERT_SUCCESS(aws_sharded_rate_limiter_init(&limiter, allocator, &options), "init failed");
+
+    /* a burst of one leaves a single shard holding the one token. */
+    size_t shards = limiter.shard_count;
+    ASSERT_INT_EQUALS(1, shards, "there should be no more shards than tokens in the burst");
+    ASSERT_SUCCESS(aws_sharded_rate_limiter_try_acquire(&limiter, 1), "acquire failed");
+    ASSERT_ERROR(AWS_ERROR_RATE_LIMIT_EXCEEDED, aws_sharded_rate_limiter_try_acquire(&limiter, 1),
+                 "every shard should be empty");
+    ASSERT_ERROR(AWS_ERROR_RATE_LIMIT_EXCEEDED, aws_sharded_rate_limiter_try_acquire(&limiter, 2),
+                 "more than the burst can never be taken");
+
+    uint64_t wait_ns = 0;
+    ASSERT_SUCCESS(aws_sharded_rate_limiter_time_until_available(&limiter, 1, &wait_ns), "time_until_available failed");
+    ASSERT_TRUE(wait_ns > 0 && wait_ns <= shards * 1000000, "each shard refills at its share of the rate");
+
+    aws_thread_current_sleep(shards * 1000000 + 1000000);
+    ASSERT_SUCCESS(aws_sharded_rate_limiter_try_acquire(&limiter, 1), "the shards should have refilled");
+
+    aws_sharded_rate_limiter_clean_up(&limiter);
+    return 0;
+}
+
+/* however many shards there are, together they hand out exactly the configured burst. */
+static int test_sharded_rate_limiter_burst(struct aws_allocator *allocator, void *ctx) {
+    struct aws_manual_clock clock;
+    aws_manual_clock_init(&clock, 1000000000);
+
+    for (size_t burst = 1; burst <= 70; ++burst) {
+        struct aws_sharded_rate_limiter limiter;
+        struct aws_rate_limiter_options options = { .tokens_per_second = 1, .burst = burst, .clock = &clock.clock };
+        ASSERT_SUCCESS(aws_sharded_rate_limiter_init(&limiter, allocator, &options), "init failed");
+        ASSERT_TRUE(limiter.shard_count <= burst, "there should be no more shards than tokens in the burst");
+
+        size_t granted = 0;
+        while (!aws_sharded_rate_limiter_try_acquire(&limiter, 1)) {
+            granted++;
+        }
+        ASSERT_INT_EQUALS(burst, granted, "the shards should hold exactly the burst");
+
+        /* once refilled, the whole burst can be taken at once even though it is spread over the shards. A shard
+         * earns 1/shard_count of the rate, so one holding the remainder takes up to twice the burst to fill. */
+        aws_manual_clock_advance(&clock, 2000000000ULL * burst);
+        uint64_t wait_ns = 1;
+        ASSERT_SUCCESS(aws_sharded_rate_limiter_time_until_available(&limiter, burst, &wait_ns),
+                       "time_until_available failed");
+        ASSERT_INT_EQUALS(0, wait_ns, "the shards should be full again");
+        ASSERT_SUCCESS(aws_sharded_rate_limiter_try_acquire(&limiter, burst), "the whole burst should be available");
+        ASSERT_ERROR(AWS_ERROR_RATE_LIMIT_EXCEEDED, aws_sharded_rate_limiter_try_acquire(&limiter, 1),
+                     "the shards should be empty");
+        ASSERT_ERROR(AWS_ERROR_RATE_LIMIT_EXCEEDED, aws_sharded_rate_limiter_try_acquire(&limiter, burst + 1),
+                     "more than the burst can never be taken");
+
+        /* a refused acquisition puts back the tokens it gathered. */
+        aws_manual_clock_advance(&clock, 2000000000ULL * burst);
+        ASSERT_SUCCESS(aws_sharded_rate_limiter_try_acquire(&limiter, 1), "acquire failed");
+        ASSERT_ERROR(AWS_ERROR_RATE_LIMIT_EXCEEDED, aws_sharded_rate_limiter_try_acquire(&limiter, burst),
+                     "one token short of the burst should be refused");
+        if (burst > 1) {
+            ASSERT_SUCCESS(aws_sharded_rate_limiter_try_acquire(&limiter, burst - 1), "the tokens should be back");
+        }
+
+        aws_sharded_rate_limiter_clean_up(&limiter);
+    }
+
+    return 0;
+}
+
+static int test_rate_limiter_simulated_time(struct aws_allocator *allocator, void *ctx) {
+    struct aws_manual_clock clock;
+    aws_manual_clock_init(&clock, 1000000000);
+
+    struct aws_rate_limiter limiter;
+    struct aws_rate_limiter_options options = { .tokens_per_second = 100, .burst = 50, .clock = &clock.clock };
+    ASSERT_SUCCESS(aws_rate_limiter_init(&limiter, &options), "init failed");
+
+    /* an hour of a client asking every millisecond, in however long the loop takes to run. */
+    size_t granted = 0;
+    for (int ms = 0; ms <= 3600 * 1000; ++ms) {
+        if (!aws_rate_limiter_try_acquire(&limiter, 1)) {
+            granted++;
+        }
+        aws_manual_clock_advance(&clock, 1000000);
+    }
+    ASSERT_INT_EQUALS(50 + 3600 * 100, granted, "the limiter should grant the burst plus the rate over the hour");
+
+    uint64_t wait_ns = 0;
+    ASSERT_SUCCESS(aws_rate_limiter_time_until_available(&limiter, 50, &wait_ns), "time_until_available failed");
+    ASSERT_TRUE(wait_ns > 0 && wait_ns <= 500000000, "a drained bucket refills at the configured rate");
+    aws_manual_clock_advance(&clock, wait_ns);
+    ASSERT_SUCCESS(aws_rate_limiter_try_acquire(&limiter, 50), "the wait should have been long enough");
+
+    return 0;
+}
+
+AWS_TEST_CASE(rate_limiter_burst_test, test_rate_limiter_burst)
+AWS_TEST_CASE(rate_limiter_refill_test, test_rate_limiter_refill)
+AWS_TEST_CASE(rate_limiter_concurrent_test, test_rate_limiter_concurrent)
+AWS_TEST_CASE(sharded_rate_limiter_test, test_sharded_rate_limiter)
+AWS_TEST_CASE(sharded_rate_limiter_burst_test, test_sharded_rate_limiter_burst)
+AWS_TEST_CASE(rate_limiter_simulated_time_test, test_rate_limiter_simulated_time)
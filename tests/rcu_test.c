@@ -0,0 +1,176 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/rcu.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+
+static void rcu_count_callback(void *object, void *user_data) {
+    (void)object;
+    (*(int *)user_data)++;
+}
+
+static int test_rcu_grace_period(struct aws_allocator *allocator, void *ctx) {
+    struct aws_rcu_domain domain;
+    ASSERT_SUCCESS(aws_rcu_domain_init(&domain, allocator), "domain init failed");
+
+    int first = 1, second = 2;
+    struct aws_rcu_ptr ptr;
+    aws_rcu_ptr_init(&ptr, &first);
+
+    struct aws_rcu_reader reader;
+    aws_rcu_reader_register(&domain, &reader);
+    ASSERT_PTR_EQUALS(&first, aws_rcu_ptr_get(&ptr), "get should return the published object");
+
+    int ran = 0;
+    ASSERT_PTR_EQUALS(&first, aws_rcu_ptr_publish(&ptr, &second), "publish should return the previous object");
+    ASSERT_PTR_EQUALS(&second, aws_rcu_ptr_get(&ptr), "get should return the new object");
+    ASSERT_SUCCESS(aws_rcu_call(&domain, rcu_count_callback, &first, &ran), "call failed");
+
+    /* the reader may still hold the old object until it passes a quiescent state. */
+    ASSERT_INT_EQUALS(0, aws_rcu_domain_poll(&domain), "no callback should run before the grace period");
+    ASSERT_INT_EQUALS(0, ran, "no callback should run before the grace period");
+
+    aws_rcu_reader_quiescent(&reader);
+    ASSERT_INT_EQUALS(1, aws_rcu_domain_poll(&domain), "the callback should run after the grace period");
+    ASSERT_INT_EQUALS(1, ran, "the callback should run exactly once");
+
+    /* offline readers don't hold up writers. */
+    aws_rcu_reader_offline(&reader);
+    ASSERT_SUCCESS(aws_rcu_call(&domain, rcu_count_callback, &second, &ran), "call failed");
+    ASSERT_INT_EQUALS(1, aws_rcu_domain_poll(&domain), "the callback should not wait for offline readers");
+    aws_rcu_synchronize(&domain);
+
+    /* polling an empty list leaves the caller's error alone. */
+    aws_raise_error(AWS_ERROR_OOM);
+    ASSERT_INT_EQUALS(0, aws_rcu_domain_poll(&domain), "there should be nothing left to run");
+    ASSERT_INT_EQUALS(AWS_ERROR_OOM, aws_last_error(), "poll should not touch the last error");
+
+    /* pending callbacks run at clean up. */
+    aws_rcu_reader_online(&reader);
+    ASSERT_SUCCESS(aws_rcu_call(&domain, rcu_count_callback, &second, &ran), "call failed");
+    ASSERT_INT_EQUALS(0, aws_rcu_domain_poll(&domain), "no callback should run before the grace period");
+    aws_rcu_reader_unregister(&reader);
+    aws_rcu_domain_clean_up(&domain);
+    ASSERT_INT_EQUALS(3, ran, "clean up should run the pending callback");
+
+    return 0;
+}
+
+#define RCU_TEST_READERS 4
+#define RCU_TEST_VERSIONS 2000
+#define RCU_TEST_MAGIC 0x5AFEC0DE
+
+struct rcu_config {
+    size_t magic;
+    size_t version;
+    size_t check;
+};
+
+struct rcu_test_data {
+    struct aws_rcu_domain domain;
+    struct aws_rcu_ptr config;
+    struct aws_allocator *allocator;
+    struct aws_atomic_var stop;
+    struct aws_atomic_var failed;
+};
+
+static void rcu_release_config(void *object, void *user_data) {
+    struct rcu_test_data *data = (struct rcu_test_data *)user_data;
+    struct rcu_config *config = (struct rcu_config *)object;
+    config->magic = 0;
+    aws_mem_release(data->allocator, config);
+}
+
+static void rcu_reader_fn(void *arg) {
+    struct rcu_test_data *data = (struct rcu_test_data *)arg;
+
+    struct aws_rcu_reader reader;
+    aws_rcu_reader_register(&data->domain, &reader);
+
+    size_t last_version = 0;
+    for (size_t i = 0; !aws_atomic_load_int_explicit(&data->stop, aws_memory_order_relaxed); ++i) {
+        const struct rcu_config *config = (const struct rcu_config *)aws_rcu_ptr_get(&data->config);
+
+        if (config->magic != RCU_TEST_MAGIC || config->check != ~config->version || config->version < last_version) {
+            aws_atomic_store_int(&data->failed, 1);
+        }
+        last_version = config->version;
+
+        if (i % 64 == 0) {
+            aws_rcu_reader_offline(&reader);
+            aws_rcu_reader_online(&reader);
+        }
+        else {
+            aws_rcu_reader_quiescent(&reader);
+        }
+    }
+
+    aws_rcu_reader_unregister(&reader);
+}
+
+static struct rcu_config *rcu_new_config(struct aws_allocator *allocator, size_t version) {
+    struct rcu_config *config = (struct rcu_config *)aws_mem_acquire(allocator, sizeof(struct rcu_config));
+    config->magic = RCU_TEST_MAGIC;
+    config->version = version;
+    config->check = ~version;
+    return config;
+}
+
+static int test_rcu_concurrent_readers(struct aws_allocator *allocator, void *ctx) {
+    struct rcu_test_data data;
+    data.allocator = allocator;
+    aws_atomic_init_int(&data.stop, 0);
+    aws_atomic_init_int(&data.failed, 0);
+    ASSERT_SUCCESS(aws_rcu_domain_init(&data.domain, allocator), "domain init failed");
+    aws_rcu_ptr_init(&data.config, rcu_new_config(allocator, 0));
+
+    struct aws_thread threads[RCU_TEST_READERS];
+    for (int i = 0; i < RCU_TEST_READERS; ++i) {
+        aws_thread_init(&threads[i], allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], rcu_reader_fn, &data, 0), "thread creation failed");
+    }
+
+    for (size_t version = 1; version <= RCU_TEST_VERSIONS; ++version) {
+        struct rcu_config *old = (struct rcu_config *)aws_rcu_ptr_publish(&data.config,
+                rcu_new_config(allocator, version));
+
+        /* alternate between the synchronous and deferred ways of reclaiming. */
+        if (version % 2) {
+            aws_rcu_synchronize(&data.domain);
+            rcu_release_config(old, &data);
+        }
+        else {
+            ASSERT_SUCCESS(aws_rcu_call(&data.domain, rcu_release_config, old, &data), "call failed");
+            aws_rcu_domain_poll(&data.domain);
+        }
+    }
+
+    aws_atomic_store_int(&data.stop, 1);
+    for (int i = 0; i < RCU_TEST_READERS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]), "thread join failed");
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    ASSERT_INT_EQUALS(0, aws_atomic_load_int(&data.failed), "a reader saw a released or torn config");
+
+    aws_rcu_domain_clean_up(&data.domain);
+    rcu_release_config(aws_rcu_ptr_get(&data.config), &data);
+
+    return 0;
+}
+
+AWS_TEST_CASE(rcu_grace_period_test, test_rcu_grace_period)
+AWS_TEST_CASE(rcu_concurrent_readers_test, test_rcu_concurrent_readers)
@@ -0,0 +1,135 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/ref_count.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+
+struct ref_counted_object {
+    struct aws_ref_count ref_count;
+    struct aws_atomic_var *destroyed;
+    int payload;
+};
+
+static void ref_counted_object_destroy(void *object) {
+    struct ref_counted_object *counted = (struct ref_counted_object *)object;
+    counted->payload = 0;
+    aws_atomic_fetch_add(counted->destroyed, 1);
+}
+
+static struct ref_counted_object *new_ref_counted_object(struct aws_allocator *allocator,
+        struct aws_atomic_var *destroyed, int biased) {
+    struct ref_counted_object *object =
+            (struct ref_counted_object *)aws_mem_acquire(allocator, sizeof(struct ref_counted_object));
+    object->destroyed = destroyed;
+    object->payload = 42;
+
+    if (biased) {
+        aws_ref_count_init_biased(&object->ref_count, allocator, object, ref_counted_object_destroy);
+    }
+    else {
+        aws_ref_count_init(&object->ref_count, allocator, object, ref_counted_object_destroy);
+    }
+    return object;
+}
+
+static int test_ref_count_weak_upgrade(struct aws_allocator *allocator, void *ctx) {
+    struct aws_atomic_var destroyed;
+    aws_atomic_init_int(&destroyed, 0);
+    struct ref_counted_object *object = new_ref_counted_object(allocator, &destroyed, 0);
+
+    aws_ref_count_acquire(&object->ref_count);
+    aws_ref_count_acquire_weak(&object->ref_count);
+    aws_ref_count_release(&object->ref_count);
+    ASSERT_INT_EQUALS(0, aws_atomic_load_int(&destroyed), "a strong reference is still held");
+
+    ASSERT_TRUE(aws_ref_count_try_upgrade(&object->ref_count), "upgrading a live object should succeed");
+    aws_ref_count_release(&object->ref_count);
+    aws_ref_count_release(&object->ref_count);
+    ASSERT_INT_EQUALS(1, aws_atomic_load_int(&destroyed), "the last strong release should destroy the object");
+
+    /* the weak reference keeps the memory, but not the object, alive. */
+    ASSERT_FALSE(aws_ref_count_try_upgrade(&object->ref_count), "upgrading a destroyed object should fail");
+    ASSERT_INT_EQUALS(0, object->payload, "the destroy callback should have run");
+    aws_ref_count_release_weak(&object->ref_count);
+    ASSERT_INT_EQUALS(1, aws_atomic_load_int(&destroyed), "the object should be destroyed exactly once");
+
+    return 0;
+}
+
+#define REF_COUNT_TEST_THREADS 4
+#define REF_COUNT_TEST_ITERATIONS 100000
+
+static void ref_count_thread_fn(void *arg) {
+    struct ref_counted_object *object = (struct ref_counted_object *)arg;
+
+    for (int i = 0; i < REF_COUNT_TEST_ITERATIONS; ++i) {
+        aws_ref_count_acquire(&object->ref_count);
+        aws_ref_count_release(&object->ref_count);
+    }
+
+    /* release the reference the owner handed over. */
+    aws_ref_count_release(&object->ref_count);
+}
+
+static int test_ref_count_biased(struct aws_allocator *allocator, void *ctx) {
+    struct aws_atomic_var destroyed;
+    aws_atomic_init_int(&destroyed, 0);
+    /* the harness allocator isn't thread safe, and the last release may happen on any thread. */
+    struct ref_counted_object *object = new_ref_counted_object(aws_default_allocator(), &destroyed, 1);
+
+    for (int i = 0; i < 1000; ++i) {
+        aws_ref_count_acquire(&object->ref_count);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        aws_ref_count_release(&object->ref_count);
+    }
+    ASSERT_INT_EQUALS(0, aws_atomic_load_int(&object->ref_count.shared),
+                      "the owner's references should not touch the shared count");
+
+    /* other threads acquire their own references through the shared count while the owner holds its own. */
+    struct aws_thread threads[REF_COUNT_TEST_THREADS];
+    for (int i = 0; i < REF_COUNT_TEST_THREADS; ++i) {
+        aws_ref_count_acquire(&object->ref_count);
+    }
+    aws_ref_count_unbias(&object->ref_count);
+    for (int i = 0; i < REF_COUNT_TEST_THREADS; ++i) {
+        aws_thread_init(&threads[i], allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], ref_count_thread_fn, object, 0), "thread creation failed");
+    }
+
+    aws_ref_count_release(&object->ref_count);
+
+    for (int i = 0; i < REF_COUNT_TEST_THREADS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]), "thread join failed");
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    ASSERT_INT_EQUALS(1, aws_atomic_load_int(&destroyed), "the object should be destroyed exactly once");
+
+    /* an owner that keeps its references on its own thread merges when its count drops to zero. */
+    aws_atomic_init_int(&destroyed, 0);
+    object = new_ref_counted_object(aws_default_allocator(), &destroyed, 1);
+    aws_ref_count_acquire_weak(&object->ref_count);
+    aws_ref_count_release(&object->ref_count);
+    ASSERT_INT_EQUALS(1, aws_atomic_load_int(&destroyed), "the owner's last release should destroy the object");
+    ASSERT_FALSE(aws_ref_count_try_upgrade(&object->ref_count), "upgrading a destroyed object should fail");
+    aws_ref_count_release_weak(&object->ref_count);
+
+    return 0;
+}
+
+AWS_TEST_CASE(ref_count_weak_upgrade_test, test_ref_count_weak_upgrade)
+AWS_TEST_CASE(ref_count_biased_test, test_ref_count_biased)
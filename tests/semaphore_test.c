@@ -0,0 +1,98 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/semaphore.h>
+#include <aws/common/clock.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+
+static int test_semaphore_acquire_release(struct aws_allocator *allocator, void *ctx) {
+    struct aws_semaphore semaphore;
+    aws_semaphore_init(&semaphore, 2);
+
+    ASSERT_SUCCESS(aws_semaphore_try_acquire(&semaphore), "the first permit should be available");
+    ASSERT_SUCCESS(aws_semaphore_acquire(&semaphore), "the second permit should be available");
+    ASSERT_ERROR(AWS_ERROR_WAIT_TIMEOUT, aws_semaphore_try_acquire(&semaphore), "no permit should be left");
+
+    uint64_t before = 0, after = 0;
+    ASSERT_SUCCESS(aws_high_res_clock_get_ticks(&before), "clock failed");
+    ASSERT_ERROR(AWS_ERROR_WAIT_TIMEOUT, aws_semaphore_acquire_timeout(&semaphore, 10000000),
+                 "acquire should time out without a permit");
+    ASSERT_SUCCESS(aws_high_res_clock_get_ticks(&after), "clock failed");
+    ASSERT_TRUE(after - before >= 10000000, "acquire should not time out early");
+
+    aws_semaphore_release(&semaphore, 1);
+    ASSERT_SUCCESS(aws_semaphore_acquire_timeout(&semaphore, 10000000), "the released permit should be available");
+
+    return 0;
+}
+
+#define SEMAPHORE_TEST_THREADS 8
+#define SEMAPHORE_TEST_PERMITS 3
+#define SEMAPHORE_TEST_ITERATIONS 2000
+
+struct semaphore_test_data {
+    struct aws_semaphore semaphore;
+    struct aws_atomic_var inside;
+    struct aws_atomic_var max_inside;
+};
+
+static void semaphore_thread_fn(void *arg) {
+    struct semaphore_test_data *data = (struct semaphore_test_data *)arg;
+
+    for (int i = 0; i < SEMAPHORE_TEST_ITERATIONS; ++i) {
+        aws_semaphore_acquire(&data->semaphore);
+
+        size_t inside = aws_atomic_fetch_add(&data->inside, 1) + 1;
+        size_t max_inside = aws_atomic_load_int(&data->max_inside);
+        while (inside > max_inside && !aws_atomic_compare_exchange_int(&data->max_inside, &max_inside, inside)) {
+        }
+
+        if (i % 100 == 0) {
+            aws_thread_current_sleep(10000);
+        }
+
+        aws_atomic_fetch_sub(&data->inside, 1);
+        aws_semaphore_release(&data->semaphore, 1);
+    }
+}
+
+static int test_semaphore_bounds_concurrency(struct aws_allocator *allocator, void *ctx) {
+    struct semaphore_test_data data;
+    aws_semaphore_init(&data.semaphore, SEMAPHORE_TEST_PERMITS);
+    aws_atomic_init_int(&data.inside, 0);
+    aws_atomic_init_int(&data.max_inside, 0);
+
+    struct aws_thread threads[SEMAPHORE_TEST_THREADS];
+    for (int i = 0; i < SEMAPHORE_TEST_THREADS; ++i) {
+        aws_thread_init(&threads[i], allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], semaphore_thread_fn, &data, 0), "thread creation failed");
+    }
+
+    for (int i = 0; i < SEMAPHORE_TEST_THREADS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]), "thread join failed");
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    ASSERT_TRUE(aws_atomic_load_int(&data.max_inside) <= SEMAPHORE_TEST_PERMITS,
+                "no more threads than permits should be inside at once");
+    ASSERT_INT_EQUALS(SEMAPHORE_TEST_PERMITS, aws_atomic_load_int(&data.semaphore.count),
+                      "every permit should have been returned");
+
+    return 0;
+}
+
+AWS_TEST_CASE(semaphore_acquire_release_test, test_semaphore_acquire_release)
+AWS_TEST_CASE(semaphore_bounds_concurrency_test, test_semaphore_bounds_concurrency)
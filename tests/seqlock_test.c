@@ -0,0 +1,102 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/seqlock.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+
+struct seqlock_test_record {
+    uint64_t a;
+    uint64_t b;
+    uint64_t c;
+    uint64_t d;
+};
+
+static int test_seqlock_read_write(struct aws_allocator *allocator, void *ctx) {
+    struct aws_seqlock lock;
+    aws_seqlock_init(&lock);
+    struct seqlock_test_record record = { 0 };
+
+    size_t seq = aws_seqlock_read_begin(&lock);
+    ASSERT_FALSE(aws_seqlock_read_retry(&lock, seq), "an idle seqlock should not request a retry");
+
+    struct seqlock_test_record update = { .a = 1, .b = 2, .c = 3, .d = 4 };
+    aws_seqlock_write(&lock, &record, &update, sizeof(update));
+    ASSERT_TRUE(aws_seqlock_read_retry(&lock, seq), "a read overlapping a write should request a retry");
+
+    struct seqlock_test_record snapshot;
+    aws_seqlock_read(&lock, &snapshot, &record, sizeof(record));
+    ASSERT_INT_EQUALS(1, snapshot.a, "snapshot should match the last write");
+    ASSERT_INT_EQUALS(4, snapshot.d, "snapshot should match the last write");
+
+    return 0;
+}
+
+#define SEQLOCK_TEST_WRITES 200000
+
+struct seqlock_thread_data {
+    struct aws_seqlock lock;
+    struct seqlock_test_record record;
+    struct aws_atomic_var done;
+};
+
+static void seqlock_writer_fn(void *arg) {
+    struct seqlock_thread_data *data = (struct seqlock_thread_data *)arg;
+
+    for (uint64_t i = 1; i <= SEQLOCK_TEST_WRITES; ++i) {
+        aws_seqlock_write_begin(&data->lock);
+        data->record.a = i;
+        data->record.b = i;
+        data->record.c = i;
+        data->record.d = i;
+        aws_seqlock_write_end(&data->lock);
+    }
+
+    aws_atomic_store_int(&data->done, 1);
+}
+
+static int test_seqlock_readers_never_see_torn_records(struct aws_allocator *allocator, void *ctx) {
+    struct seqlock_thread_data data;
+    memset(&data, 0, sizeof(data));
+    aws_seqlock_init(&data.lock);
+    aws_atomic_init_int(&data.done, 0);
+
+    struct aws_thread writer;
+    aws_thread_init(&writer, allocator);
+    ASSERT_SUCCESS(aws_thread_launch(&writer, seqlock_writer_fn, &data, 0), "thread creation failed");
+
+    uint64_t last_seen = 0;
+    int done = 0;
+    while (!done) {
+        done = (int)aws_atomic_load_int(&data.done);
+
+        struct seqlock_test_record snapshot;
+        aws_seqlock_read(&data.lock, &snapshot, &data.record, sizeof(snapshot));
+        ASSERT_TRUE(snapshot.a == snapshot.b && snapshot.b == snapshot.c && snapshot.c == snapshot.d,
+                    "torn read: %llu %llu %llu %llu", (unsigned long long)snapshot.a, (unsigned long long)snapshot.b,
+                    (unsigned long long)snapshot.c, (unsigned long long)snapshot.d);
+        ASSERT_TRUE(snapshot.a >= last_seen, "snapshots should never go backwards");
+        last_seen = snapshot.a;
+    }
+
+    ASSERT_SUCCESS(aws_thread_join(&writer), "thread join failed");
+    aws_thread_clean_up(&writer);
+    ASSERT_INT_EQUALS(SEQLOCK_TEST_WRITES, last_seen, "the final read should see the final write");
+
+    return 0;
+}
+
+AWS_TEST_CASE(seqlock_read_write_test, test_seqlock_read_write)
+AWS_TEST_CASE(seqlock_readers_never_see_torn_records_test, test_seqlock_readers_never_see_torn_records)
@@ -14,8 +14,16 @@
  */
 
 #include <aws/common/thread.h>
+#include <aws/common/clock.h>
+#include <aws/common/event.h>
+#include <aws/common/latch.h>
 #include <aws_test_harness.h>
 
+#ifndef _WIN32
+#include <signal.h>
+#include <string.h>
+#endif
+
 struct thread_test_data {
     uint64_t thread_id;
 };
@@ -44,3 +52,165 @@ static int test_thread_creation_join_fn(struct aws_allocator *allocator, void *c
 }
 
 AWS_TEST_CASE(thread_creation_join_test, test_thread_creation_join_fn)
+
+static int test_thread_sleep_until_fn(struct aws_allocator *allocator, void *ctx) {
+    /* failing is fine off Linux, this just shouldn't break anything. */
+    aws_thread_current_set_timer_slack(1000);
+
+    uint64_t deadline = 0, now = 0;
+    uint64_t best_overshoot = UINT64_MAX;
+    for (int i = 0; i < 20; ++i) {
+        ASSERT_SUCCESS(aws_high_res_clock_get_ticks(&deadline), "clock failed");
+        deadline += 250000 * (uint64_t)(i % 4 + 1);
+
+        ASSERT_SUCCESS(aws_thread_sleep_until(deadline), "sleep_until failed");
+        ASSERT_SUCCESS(aws_high_res_clock_get_ticks(&now), "clock failed");
+        ASSERT_TRUE(now >= deadline, "sleep_until should never wake up early");
+        if (now - deadline < best_overshoot) {
+            best_overshoot = now - deadline;
+        }
+    }
+
+    /* wake ups are normally within microseconds, but on a busy machine any single one can be preempted. */
+    ASSERT_TRUE(best_overshoot < 1000000, "sleep_until should be able to wake up close to its deadline");
+
+    aws_thread_current_set_timer_slack(0);
+    return 0;
+}
+
+AWS_TEST_CASE(thread_sleep_until_test, test_thread_sleep_until_fn)
+
+#ifndef _WIN32
+static void ignore_signal(int signal_number) {
+    (void)signal_number;
+}
+
+struct sleeper_data {
+    uint64_t slept_ns;
+};
+
+static void sleeper_fn(void *arg) {
+    struct sleeper_data *data = (struct sleeper_data *)arg;
+    uint64_t start = 0, end = 0;
+
+    aws_high_res_clock_get_ticks(&start);
+    aws_thread_current_sleep(50000000);
+    aws_high_res_clock_get_ticks(&end);
+    data->slept_ns = end - start;
+}
+
+static int test_thread_sleep_interrupted_fn(struct aws_allocator *allocator, void *ctx) {
+    struct sigaction action, old_action;
+    memset(&action, 0, sizeof(action));
+    /* no SA_RESTART, so the signal interrupts nanosleep with EINTR. */
+    action.sa_handler = ignore_signal;
+    sigemptyset(&action.sa_mask);
+    ASSERT_SUCCESS(sigaction(SIGUSR1, &action, &old_action), "sigaction failed");
+
+    struct sleeper_data data = { 0 };
+    struct aws_thread thread;
+    aws_thread_init(&thread, allocator);
+    ASSERT_SUCCESS(aws_thread_launch(&thread, sleeper_fn, &data, 0), "thread creation failed");
+
+    aws_thread_current_sleep(10000000);
+    pthread_kill(thread.thread_id, SIGUSR1);
+
+    ASSERT_SUCCESS(aws_thread_join(&thread), "thread join failed");
+    aws_thread_clean_up(&thread);
+    sigaction(SIGUSR1, &old_action, NULL);
+
+    ASSERT_TRUE(data.slept_ns >= 50000000, "a signal should not cut the sleep short");
+    return 0;
+}
+#else
+static int test_thread_sleep_interrupted_fn(struct aws_allocator *allocator, void *ctx) {
+    /* no signals to interrupt a sleep with. */
+    return 0;
+}
+#endif
+
+AWS_TEST_CASE(thread_sleep_interrupted_test, test_thread_sleep_interrupted_fn)
+
+#define STATS_TEST_THREADS 2
+#define STATS_TEST_CPU_NS 20000000
+
+struct stats_test_data {
+    struct aws_latch busy;
+    struct aws_event done;
+};
+
+static void busy_thread_fn(void *arg) {
+    struct stats_test_data *data = (struct stats_test_data *)arg;
+    struct aws_thread_stats stats;
+
+    /* a few sleeps for voluntary context switches, then burn some CPU. */
+    for (int i = 0; i < 3; ++i) {
+        aws_thread_current_sleep(1000000);
+    }
+    do {
+        aws_thread_current_stats(&stats);
+    } while (stats.cpu_time_ns < STATS_TEST_CPU_NS);
+
+    aws_latch_count_down(&data->busy, 1);
+    aws_event_wait(&data->done);
+}
+
+static int find_thread_stats(struct aws_array_list *list, uint64_t thread_id, struct aws_thread_stats *stats) {
+    for (size_t i = 0; i < aws_array_list_length(list); ++i) {
+        aws_array_list_get_at(list, stats, i);
+        if (stats->thread_id == thread_id) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int test_thread_stats_fn(struct aws_allocator *allocator, void *ctx) {
+    struct stats_test_data data;
+    aws_latch_init(&data.busy, STATS_TEST_THREADS);
+    aws_event_init(&data.done);
+
+    struct aws_thread threads[STATS_TEST_THREADS];
+    for (int i = 0; i < STATS_TEST_THREADS; ++i) {
+        aws_thread_init(&threads[i], allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&threads[i], busy_thread_fn, &data, 0), "thread creation failed");
+    }
+    ASSERT_SUCCESS(aws_latch_wait(&data.busy), "latch wait failed");
+
+    struct aws_array_list list;
+    struct aws_thread_stats stats;
+    ASSERT_SUCCESS(aws_array_list_init_dynamic(&list, allocator, 4, sizeof(struct aws_thread_stats)), "init failed");
+    ASSERT_SUCCESS(aws_thread_registry_get_stats(&list), "registry enumeration failed");
+
+    for (int i = 0; i < STATS_TEST_THREADS; ++i) {
+        uint64_t cpu_time_ns = 0;
+        ASSERT_SUCCESS(aws_thread_cpu_time(&threads[i], &cpu_time_ns), "cpu time failed");
+        ASSERT_TRUE(cpu_time_ns >= STATS_TEST_CPU_NS, "the thread's CPU time should include its busy loop");
+
+        ASSERT_TRUE(find_thread_stats(&list, aws_thread_get_id(&threads[i]), &stats),
+                    "running threads should be in the registry");
+        ASSERT_TRUE(stats.cpu_time_ns >= STATS_TEST_CPU_NS, "the registry should report CPU time");
+#if defined(__linux__)
+        ASSERT_TRUE(stats.voluntary_context_switches >= 3, "sleeping should count as voluntary context switches");
+#endif
+    }
+
+    aws_event_set(&data.done);
+    for (int i = 0; i < STATS_TEST_THREADS; ++i) {
+        ASSERT_SUCCESS(aws_thread_join(&threads[i]), "thread join failed");
+    }
+
+    aws_array_list_clear(&list);
+    ASSERT_SUCCESS(aws_thread_registry_get_stats(&list), "registry enumeration failed");
+    for (int i = 0; i < STATS_TEST_THREADS; ++i) {
+        ASSERT_FALSE(find_thread_stats(&list, aws_thread_get_id(&threads[i]), &stats),
+                     "finished threads should leave the registry");
+        aws_thread_clean_up(&threads[i]);
+    }
+
+    aws_array_list_clean_up(&list);
+    return 0;
+}
+
+AWS_TEST_CASE(thread_stats_test, test_thread_stats_fn)
@@ -0,0 +1,215 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/trace.h>
+#include <aws/common/mutex.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+#include <string.h>
+
+/* the number of events named name that thread_id recorded. */
+static size_t count_events(const struct aws_array_list *events, uint64_t thread_id, const char *name) {
+    size_t count = 0;
+    for (size_t i = 0; i < aws_array_list_length(events); ++i) {
+        struct aws_trace_event *event = NULL;
+        aws_array_list_get_at_ptr(events, (void **)&event, i);
+        if (event->thread_id == thread_id && !strcmp(event->name, name)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+struct trace_test_data {
+    struct aws_mutex mutex;
+    uint64_t thread_id;
+};
+
+static void trace_thread_fn(void *arg) {
+    struct trace_test_data *data = (struct trace_test_data *)arg;
+    data->thread_id = aws_thread_current_thread_id();
+
+    aws_trace_record(AWS_TRACE_EVENT_BEGIN, "work", 0);
+    aws_mutex_lock(&data->mutex);
+    aws_mutex_unlock(&data->mutex);
+    aws_trace_record(AWS_TRACE_EVENT_END, "work", 0);
+}
+
+static int test_trace_collect(struct aws_allocator *allocator, void *ctx) {
+    struct trace_test_data data;
+    struct aws_array_list events;
+    uint64_t self = aws_thread_current_thread_id();
+
+    aws_trace_reset();
+    aws_trace_record(AWS_TRACE_EVENT_INSTANT, "ignored", 0);
+    ASSERT_FALSE(aws_trace_enabled(), "tracing should start off");
+
+    aws_trace_set_enabled(1);
+    ASSERT_SUCCESS(aws_mutex_init(&data.mutex, allocator), "mutex init failed");
+
+    /* hold the mutex so the thread has to wait for it. */
+    struct aws_thread thread;
+    aws_thread_init(&thread, allocator);
+    aws_trace_record(AWS_TRACE_EVENT_BEGIN, "main", 0);
+    aws_mutex_lock(&data.mutex);
+    ASSERT_SUCCESS(aws_thread_launch(&thread, trace_thread_fn, &data, NULL), "thread launch failed");
+    aws_thread_current_sleep(20000000);
+    aws_mutex_unlock(&data.mutex);
+    ASSERT_SUCCESS(aws_thread_join(&thread), "thread join failed");
+    aws_trace_record(AWS_TRACE_EVENT_INSTANT, "joined", 42);
+    aws_trace_record(AWS_TRACE_EVENT_END, "main", 0);
+    aws_trace_set_enabled(0);
+
+    ASSERT_SUCCESS(aws_trace_collect(allocator, &events), "collect failed");
+    ASSERT_INT_EQUALS(0, count_events(&events, self, "ignored"), "nothing is recorded while tracing is off");
+    ASSERT_INT_EQUALS(2, count_events(&events, self, "main"), "main thread events are missing");
+    ASSERT_INT_EQUALS(1, count_events(&events, self, "joined"), "the instant event is missing");
+    ASSERT_INT_EQUALS(2, count_events(&events, data.thread_id, "work"), "events of an exited thread are missing");
+#if defined(AWS_ENABLE_TRACING)
+    ASSERT_INT_EQUALS(2, count_events(&events, data.thread_id, "aws_thread"), "the thread should be traced");
+    ASSERT_INT_EQUALS(2, count_events(&events, data.thread_id, "aws_mutex_wait"), "the mutex wait should be traced");
+#endif
+
+    /* each thread's events are in the order it recorded them. */
+    uint64_t last_timestamp = 0;
+    for (size_t i = 0; i < aws_array_list_length(&events); ++i) {
+        struct aws_trace_event *event = NULL;
+        aws_array_list_get_at_ptr(&events, (void **)&event, i);
+        if (event->thread_id == self) {
+            ASSERT_TRUE(event->timestamp >= last_timestamp, "timestamps should not go backwards");
+            last_timestamp = event->timestamp;
+            if (!strcmp(event->name, "joined")) {
+                ASSERT_INT_EQUALS(AWS_TRACE_EVENT_INSTANT, event->type, "wrong event type");
+                ASSERT_INT_EQUALS(42, event->arg, "wrong event argument");
+            }
+        }
+    }
+
+    aws_array_list_clean_up(&events);
+    aws_mutex_clean_up(&data.mutex);
+    return 0;
+}
+
+AWS_TEST_CASE(trace_collect_test, test_trace_collect)
+
+static int test_trace_ring_overwrite(struct aws_allocator *allocator, void *ctx) {
+    struct aws_array_list events;
+    uint64_t self = aws_thread_current_thread_id();
+
+    aws_trace_reset();
+    aws_trace_set_enabled(1);
+    for (uint64_t i = 0; i < 3 * AWS_TRACE_BUFFER_EVENTS; ++i) {
+        aws_trace_record(AWS_TRACE_EVENT_INSTANT, "tick", i);
+    }
+    aws_trace_set_enabled(0);
+
+    ASSERT_SUCCESS(aws_trace_collect(allocator, &events), "collect failed");
+    ASSERT_INT_EQUALS(AWS_TRACE_BUFFER_EVENTS, count_events(&events, self, "tick"),
+                      "a thread should keep exactly its buffer's worth of events");
+
+    /* the oldest events were overwritten, the newest kept in order. */
+    uint64_t expected = 2 * AWS_TRACE_BUFFER_EVENTS;
+    for (size_t i = 0; i < aws_array_list_length(&events); ++i) {
+        struct aws_trace_event *event = NULL;
+        aws_array_list_get_at_ptr(&events, (void **)&event, i);
+        if (event->thread_id == self && !strcmp(event->name, "tick")) {
+            ASSERT_INT_EQUALS(expected, event->arg, "events are missing or out of order");
+            expected++;
+        }
+    }
+    aws_array_list_clean_up(&events);
+
+    aws_trace_reset();
+    ASSERT_SUCCESS(aws_trace_collect(allocator, &events), "collect failed");
+    ASSERT_INT_EQUALS(0, count_events(&events, self, "tick"), "reset should discard every event");
+    aws_array_list_clean_up(&events);
+
+    return 0;
+}
+
+AWS_TEST_CASE(trace_ring_overwrite_test, test_trace_ring_overwrite)
+
+#define TRACE_CHURN_THREADS 64
+
+static void trace_churn_fn(void *arg) {
+    aws_trace_record(AWS_TRACE_EVENT_INSTANT, "churn", *(uint64_t *)arg);
+}
+
+static int test_trace_thread_churn(struct aws_allocator *allocator, void *ctx) {
+    struct aws_array_list events;
+
+    /* exited threads' buffers are handed on to later threads, without losing the events already in them. */
+    aws_trace_reset();
+    aws_trace_set_enabled(1);
+    for (uint64_t i = 0; i < TRACE_CHURN_THREADS; ++i) {
+        struct aws_thread thread;
+        aws_thread_init(&thread, allocator);
+        ASSERT_SUCCESS(aws_thread_launch(&thread, trace_churn_fn, &i, NULL), "thread launch failed");
+        ASSERT_SUCCESS(aws_thread_join(&thread), "thread join failed");
+        aws_thread_clean_up(&thread);
+    }
+    aws_trace_set_enabled(0);
+
+    ASSERT_SUCCESS(aws_trace_collect(allocator, &events), "collect failed");
+    uint64_t seen = 0;
+    for (size_t i = 0; i < aws_array_list_length(&events); ++i) {
+        struct aws_trace_event *event = NULL;
+        aws_array_list_get_at_ptr(&events, (void **)&event, i);
+        if (!strcmp(event->name, "churn")) {
+            ASSERT_TRUE(event->arg < TRACE_CHURN_THREADS, "unexpected event");
+            seen |= 1ULL << event->arg;
+        }
+    }
+    ASSERT_TRUE(seen == ~0ULL, "every thread's event should still be collectable");
+    aws_array_list_clean_up(&events);
+
+    return 0;
+}
+
+AWS_TEST_CASE(trace_thread_churn_test, test_trace_thread_churn)
+
+static int test_trace_chrome_json(struct aws_allocator *allocator, void *ctx) {
+    struct aws_array_list events;
+    char json[1024];
+
+    aws_trace_reset();
+    aws_trace_set_enabled(1);
+    aws_trace_record(AWS_TRACE_EVENT_BEGIN, "say \"hi\"", 0);
+    aws_trace_record(AWS_TRACE_EVENT_INSTANT, "value", 7);
+    aws_trace_record(AWS_TRACE_EVENT_END, "say \"hi\"", 0);
+    aws_trace_set_enabled(0);
+
+    ASSERT_SUCCESS(aws_trace_collect(allocator, &events), "collect failed");
+
+    FILE *file = tmpfile();
+    ASSERT_NOT_NULL(file, "tmpfile failed");
+    ASSERT_SUCCESS(aws_trace_write_chrome_json(file, &events), "writing json failed");
+    rewind(file);
+    size_t len = fread(json, 1, sizeof(json) - 1, file);
+    json[len] = 0;
+    fclose(file);
+    aws_array_list_clean_up(&events);
+
+    ASSERT_INT_EQUALS(0, strncmp(json, "{\"traceEvents\":[", 16), "json should be a trace_event object");
+    ASSERT_NOT_NULL(strstr(json, "{\"name\":\"say \\\"hi\\\"\",\"ph\":\"B\",\"ts\":"), "begin event is missing");
+    ASSERT_NOT_NULL(strstr(json, "\"ph\":\"E\""), "end event is missing");
+    ASSERT_NOT_NULL(strstr(json, "\"ph\":\"i\""), "instant event is missing");
+    ASSERT_NOT_NULL(strstr(json, "\"args\":{\"value\":7}"), "instant event argument is missing");
+    ASSERT_INT_EQUALS(0, strcmp(json + len - 4, "\n]}\n"), "json should be terminated");
+
+    return 0;
+}
+
+AWS_TEST_CASE(trace_chrome_json_test, test_trace_chrome_json)
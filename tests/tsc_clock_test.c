@@ -0,0 +1,73 @@
+/*
+ *  Copyright 2010-2018 Amazon.com, Inc. or its affiliates. All Rights Reserved.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License").
+ *  You may not use this file except in compliance with the License.
+ *  A copy of the License is located at
+ *
+ *  http://aws.amazon.com/apache2.0
+ *
+ *  or in the "license" file accompanying this file. This file is distributed
+ *  on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either
+ *  express or implied. See the License for the specific language governing
+ *  permissions and limitations under the License.
+ */
+
+#include <aws/common/tsc_clock.h>
+#include <aws/common/thread.h>
+#include <aws_test_harness.h>
+
+static int test_tsc_clock_tracks_high_res(struct aws_allocator *allocator, void *ctx) {
+    uint64_t before = 0, ticks = 0, after = 0, previous = 0;
+
+    if (aws_tsc_clock_init()) {
+        ASSERT_INT_EQUALS(AWS_ERROR_UNSUPPORTED_OPERATION, aws_last_error(), "init should only fail without a TSC");
+        ASSERT_SUCCESS(aws_tsc_clock_get_ticks(&ticks), "the fallback clock should work");
+        return 0;
+    }
+
+    /* long enough to go through a recalibration. */
+    for (int i = 0; i < 25; ++i) {
+        ASSERT_SUCCESS(aws_high_res_clock_get_ticks(&before), "clock failed");
+        ASSERT_SUCCESS(aws_tsc_clock_get_ticks(&ticks), "tsc clock failed");
+        ASSERT_SUCCESS(aws_high_res_clock_get_ticks(&after), "clock failed");
+
+        ASSERT_TRUE(ticks >= previous, "the tsc clock should never go backwards");
+        ASSERT_TRUE(ticks + 200000 >= before && ticks <= after + 200000,
+                    "the tsc clock should stay within 200us of the high res clock");
+        previous = ticks;
+
+        for (int j = 0; j < 1000; ++j) {
+            ASSERT_SUCCESS(aws_tsc_clock_get_ticks(&ticks), "tsc clock failed");
+            ASSERT_TRUE(ticks >= previous, "the tsc clock should never go backwards");
+            previous = ticks;
+        }
+
+        aws_thread_current_sleep(50000000);
+    }
+
+    return 0;
+}
+
+static int test_tsc_to_ns(struct aws_allocator *allocator, void *ctx) {
+    if (aws_tsc_clock_init()) {
+        return 0;
+    }
+
+    uint64_t start_ns = 0, end_ns = 0;
+    ASSERT_SUCCESS(aws_high_res_clock_get_ticks(&start_ns), "clock failed");
+    uint64_t start = aws_tsc_read();
+    aws_thread_current_sleep(20000000);
+    uint64_t end = aws_tsc_read();
+    ASSERT_SUCCESS(aws_high_res_clock_get_ticks(&end_ns), "clock failed");
+
+    ASSERT_TRUE(end > start, "the TSC should count up");
+    uint64_t elapsed = aws_tsc_to_ns(end - start);
+    ASSERT_TRUE(elapsed >= 20000000 - 100000 && elapsed <= end_ns - start_ns + 100000,
+                "converted TSC deltas should match the high res clock");
+
+    return 0;
+}
+
+AWS_TEST_CASE(tsc_clock_tracks_high_res_test, test_tsc_clock_tracks_high_res)
+AWS_TEST_CASE(tsc_to_ns_test, test_tsc_to_ns)